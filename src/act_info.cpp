@@ -20,6 +20,7 @@
 #include "color.h"
 #include "comm.h"
 #include "db.h"
+#include "exploit_log.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
@@ -59,8 +60,6 @@ extern struct index_data* mob_index;
 extern struct index_data* obj_index;
 extern int social_list_top;
 extern struct social_messg* soc_mess_list;
-extern struct crime_record_type* crime_record;
-extern int num_of_crimes;
 extern long beginning_of_time;
 extern char* credits;
 extern char* news;
@@ -4107,67 +4106,16 @@ void print_exploits(struct char_data* sendto, char* name)
     char str3[255];
     char str4[255];
     char str5[255];
-    char playerfname[255];
     int i, iTotalPk, iDeaths = 0, iNotes = 0;
     exploit_record exploitrec;
-    FILE* fp = NULL;
     // 1000 lines max of output.
     // that means max of 2000 kills/deaths. certainly enough for a while.
     char buf[80000];
-    char tname[50];
-    char* tmpchar;
     int iMobDeaths;
 
-    // convert name to lowercase
-    strcpy(tname, name);
-    for (tmpchar = tname; *tmpchar; tmpchar++)
-        *tmpchar = tolower(*tmpchar);
-
-    switch (tolower(*name)) {
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-        sprintf(playerfname, "exploits/A-E/%s.exploits", tname);
-        break;
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-        sprintf(playerfname, "exploits/F-J/%s.exploits", tname);
-        break;
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-        sprintf(playerfname, "exploits/K-O/%s.exploits", tname);
-        break;
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-        sprintf(playerfname, "exploits/P-T/%s.exploits", tname);
-        break;
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-        sprintf(playerfname, "exploits/U-Z/%s.exploits", tname);
-        break;
-    default:
-        sprintf(playerfname, "exploits/ZZZ/%s.exploits", tname);
-        break;
-    }
-
     // open trophy file
-    fp = fopen(playerfname, "r");
-    if (fp == NULL) {
+    game_exploits::reader exploits(name);
+    if (!exploits.is_open()) {
         // assume no exploit file exists
         send_to_char("You have accomplished nothing worthy of note.\n\r", sendto);
         return;
@@ -4184,12 +4132,8 @@ void print_exploits(struct char_data* sendto, char* name)
     iTotalPk = 0;
 
     iMobDeaths = 0;
-    for (;;) {
-        // read an entry
-        exploitrec.type = 999;
-        fread(&exploitrec, sizeof(struct exploit_record), 1, fp);
-        if (feof(fp))
-            break;
+    // entries come newest first
+    while (exploits.next(exploitrec)) {
 
         // this entry - date
         strcpy(str2, exploitrec.chtime + 4);
@@ -4279,8 +4223,6 @@ void print_exploits(struct char_data* sendto, char* name)
         sprintf(buf, "%s%s\n\r", buf, str4);
     }
 
-    fclose(fp);
-
     if (iTotalPk == 1)
         sprintf(buf, "%s\n\rTotal: 1 pkill, ", buf);
     else
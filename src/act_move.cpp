@@ -16,6 +16,7 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "pathfind.h"
 #include "script.h"
 #include "spells.h"
 #include "structs.h"
@@ -1039,6 +1040,7 @@ ACMD(do_open)
 
         else {
             REMOVE_BIT(EXIT(ch, door)->exit_info, EX_CLOSED);
+            game_path::doors_changed(world[ch->in_room]);
             if (EXIT(ch, door)->keyword)
                 act("$n opens the $F.", FALSE, ch, 0, EXIT(ch, door)->keyword,
                     TO_ROOM);
@@ -1050,6 +1052,7 @@ ACMD(do_open)
                 if ((back = world[other_room].dir_option[rev_dir[door]]))
                     if (back->to_room == ch->in_room) {
                         REMOVE_BIT(back->exit_info, EX_CLOSED);
+                        game_path::doors_changed(world[other_room]);
                         if (back->keyword) {
                             sprintf(buf, "The %s is opened from the other side.\n\r",
                                 fname(back->keyword));
@@ -1152,6 +1155,7 @@ ACMD(do_close)
 
         else {
             SET_BIT(EXIT(ch, door)->exit_info, EX_CLOSED);
+            game_path::doors_changed(world[ch->in_room]);
             if (EXIT(ch, door)->keyword)
                 act("$n closes the $F.", 0, ch, 0, EXIT(ch, door)->keyword,
                     TO_ROOM);
@@ -1163,6 +1167,7 @@ ACMD(do_close)
                 if ((back = world[other_room].dir_option[rev_dir[door]]))
                     if ((back->to_room == ch->in_room) && IS_SET(back->exit_info, EX_ISDOOR)) {
                         SET_BIT(back->exit_info, EX_CLOSED);
+                        game_path::doors_changed(world[other_room]);
                         if (back->keyword) {
                             sprintf(buf, "The %s closes quietly.\n\r", back->keyword);
                             send_to_room(buf, EXIT(ch, door)->to_room);
@@ -1274,6 +1279,7 @@ ACMD(do_lock)
             send_to_char("It's already locked!\n\r", ch);
         else {
             SET_BIT(EXIT(ch, door)->exit_info, EX_LOCKED);
+            game_path::doors_changed(world[ch->in_room]);
             if (EXIT(ch, door)->keyword)
                 act("$n locks the $F.", 0, ch, 0, EXIT(ch, door)->keyword,
                     TO_ROOM);
@@ -1283,8 +1289,10 @@ ACMD(do_lock)
             /* now for locking the other side, too */
             if ((other_room = EXIT(ch, door)->to_room) != NOWHERE)
                 if ((back = world[other_room].dir_option[rev_dir[door]]))
-                    if ((back->to_room == ch->in_room) && IS_SET(back->exit_info, EX_ISDOOR))
+                    if ((back->to_room == ch->in_room) && IS_SET(back->exit_info, EX_ISDOOR)) {
                         SET_BIT(back->exit_info, EX_LOCKED);
+                        game_path::doors_changed(world[other_room]);
+                    }
         }
 }
 
@@ -1343,6 +1351,7 @@ ACMD(do_unlock)
             send_to_char("It's already unlocked, it seems.\n\r", ch);
         else {
             REMOVE_BIT(EXIT(ch, door)->exit_info, EX_LOCKED);
+            game_path::doors_changed(world[ch->in_room]);
             if (EXIT(ch, door)->keyword)
                 act("$n unlocks the $F.", 0, ch, 0, EXIT(ch, door)->keyword,
                     TO_ROOM);
@@ -1353,8 +1362,10 @@ ACMD(do_unlock)
             /* now for unlocking the other side, too */
             if ((other_room = EXIT(ch, door)->to_room) != NOWHERE)
                 if ((back = world[other_room].dir_option[rev_dir[door]]))
-                    if (back->to_room == ch->in_room)
+                    if (back->to_room == ch->in_room) {
                         REMOVE_BIT(back->exit_info, EX_LOCKED);
+                        game_path::doors_changed(world[other_room]);
+                    }
         }
 }
 
@@ -1879,6 +1890,8 @@ ACMD(do_pull)
         }
     }
 
+    game_path::doors_changed(*room);
+
     //*** now opening the other side of the door
 
     next_room_num = room->dir_option[exit_num]->to_room;
@@ -1908,4 +1921,5 @@ ACMD(do_pull)
         sprintf(buf, "The %s closes slowly.\n\r", next_room->dir_option[exit_num]->keyword);
         send_to_room(buf, next_room_num);
     }
+    game_path::doors_changed(*next_room);
 }
@@ -20,7 +20,10 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "name_index.h"
+#include "player_index.h"
 #include "script.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -873,7 +876,7 @@ int generic_scalp = 1122;
 
 obj_data* load_scalp(int number)
 {
-    int tmp, trophy_num, w_type = 0;
+    int trophy_num, w_type = 0;
     obj_data* scalp;
 
     if (number == 0) {
@@ -888,18 +891,11 @@ obj_data* load_scalp(int number)
             return 0;
     }
     if (number < 0) {
-        for (tmp = 0; tmp <= top_of_p_table; tmp++)
-            if (player_table[tmp].idnum == -number)
-                break;
-
-        if (tmp > top_of_p_table)
-            trophy_num = -1;
-        else
-            trophy_num = tmp;
+        trophy_num = game_index::players.find_idnum(-number);
         w_type = 1;
     }
 
-    CREATE(scalp, struct obj_data, 1);
+    scalp = game_memory::object_pool.allocate();
     // printf("making corpse from %p\n",ch);
     // printf("corpse created, =%p\n",corpse);
     clear_object(scalp);
@@ -938,6 +934,7 @@ obj_data* load_scalp(int number)
     }
     scalp->next = object_list;
     object_list = scalp;
+    game_index::add_obj(scalp);
 
     return scalp;
 }
@@ -19,6 +19,7 @@
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "name_index.h"
 #include "script.h"
 #include "spells.h"
 #include "structs.h"
@@ -64,6 +65,7 @@ void name_from_drinkcon(struct obj_data* obj)
         if (obj->item_number < 0 || obj->name != obj_proto[obj->item_number].name)
             RELEASE(obj->name);
         obj->name = new_name;
+        game_index::rename_obj(obj);
     }
 }
 
@@ -78,6 +80,7 @@ void name_to_drinkcon(struct obj_data* obj, int type)
     if (obj->item_number < 0 || obj->name != obj_proto[obj->item_number].name)
         RELEASE(obj->name);
     obj->name = new_name;
+    game_index::rename_obj(obj);
 }
 
 extern struct obj_data generic_water;
@@ -1198,7 +1201,7 @@ ACMD(do_light)
         return;
     }
     torch->obj_flags.value[3] = 1;
-    world[ch->in_room].light++;
+    adjust_light(torch, 1);
 
     act("You light $p.", FALSE, ch, torch, 0, TO_CHAR);
     act("$n lights $p.", FALSE, ch, torch, 0, TO_ROOM);
@@ -1241,7 +1244,7 @@ ACMD(do_blowout)
         return;
     }
     torch->obj_flags.value[3] = 0;
-    world[ch->in_room].light--;
+    adjust_light(torch, -1);
 
     act("You blow $p out.", FALSE, ch, torch, 0, TO_CHAR);
     act("$n blows $p out.", FALSE, ch, torch, 0, TO_ROOM);
@@ -18,6 +18,7 @@
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "pathfind.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -648,6 +649,7 @@ ACMD(do_bash)
         }
         SET_BIT(EXIT(ch, door)->exit_info, EX_ISBROKEN);
         REMOVE_BIT(EXIT(ch, door)->exit_info, EX_CLOSED | EX_LOCKED);
+        game_path::doors_changed(world[ch->in_room]);
         sprintf(buf, "The %s crashes open! You fall through it.\n\r",
             EXIT(ch, door)->keyword);
         send_to_char(buf, ch);
@@ -659,6 +661,7 @@ ACMD(do_bash)
                 if (back->to_room == ch->in_room) {
                     SET_BIT(back->exit_info, EX_ISBROKEN);
                     REMOVE_BIT(back->exit_info, EX_CLOSED | EX_LOCKED);
+                    game_path::doors_changed(world[other_room]);
                     if (back->keyword) {
                         sprintf(buf, "The %s suddenly crashes open.\n\r",
                             fname(back->keyword));
@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "comm.h"
+#include "command_trie.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
@@ -184,7 +185,9 @@ int find_action_old(char* arg)
     return tmp;
 }
 
-int find_action(char* arg)
+/* the binary search find_action() used before the command trie, which
+   still settles what each abbreviation of a social resolves to */
+int find_action_sorted(char* arg)
 {
     int bot, top, mid, len;
 
@@ -211,6 +214,14 @@ int find_action(char* arg)
     return -1;
 }
 
+int find_action(char* arg)
+{
+    if (!game_commands::is_built())
+        return find_action_sorted(arg);
+
+    return game_commands::lookup(arg, strlen(arg)).social;
+}
+
 char action_arg[MAX_INPUT_LENGTH];
 
 int social_parser(char_data* ch, char* argument, waiting_type* wtl)
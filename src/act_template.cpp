@@ -0,0 +1,406 @@
+/* act_template.cpp */
+
+#include "act_template.h"
+
+#include "platdef.h"
+#include "structs.h"
+#include "utils.h"
+#include "color.h"
+#include "handler.h"
+
+#include <ctype.h>
+#include <deque>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern int act_template_limit; /* see config.c */
+
+namespace game_text {
+namespace {
+    enum token_kind {
+        LITERAL, // text[start, start + length)
+        COLOR, // $C?, color 'color'
+        PERSON, // $n, $N or $K
+        OBJECT, // $o, $O, $p or $P
+        FIXED // the other codes, the same for everyone
+    };
+
+    struct token {
+        token_kind kind;
+        char code;
+        int color;
+        int start;
+        int length;
+    };
+
+    // What one COLOR, PERSON or OBJECT token, or the closing color, comes
+    // to for a recipient.  Recipients alike in all of them get one line.
+    struct facet {
+        int kind; // PERSON: pers_kind(); OBJECT: whether it is seen
+        const char* color; // COLOR, or the enemy color of a PERSON
+        const char* normal; // the closing color, or that of a PERSON
+
+        bool operator==(const facet& other) const
+        {
+            return kind == other.kind && color == other.color && normal == other.normal;
+        }
+    };
+
+    facet make_facet(int kind, const char* color, const char* normal)
+    {
+        facet made = { kind, color, normal };
+        return made;
+    }
+
+    int color_of(char code)
+    {
+        switch (code) {
+        case 'N':
+            return COLOR_NARR;
+        case 'C':
+            return COLOR_CHAT;
+        case 'Y':
+            return COLOR_YELL;
+        case 'T':
+            return COLOR_TELL;
+        case 'S':
+            return COLOR_SAY;
+        case 'R':
+            return COLOR_ROOM;
+        case 'H':
+            return COLOR_HIT;
+        case 'D':
+            return COLOR_DAMG;
+        case 'K':
+            return COLOR_CHAR;
+        case 'O':
+            return COLOR_OBJ;
+        case 'E':
+            return COLOR_DESC;
+        case 'G':
+            return COLOR_GTELL;
+        default:
+            return -1;
+        }
+    }
+
+    // Skips the ANSI colors at 'letter', as convert_string() does before
+    // capitalizing.
+    size_t skip_colors(const std::string& line, size_t letter)
+    {
+        while (letter < line.size() && line[letter] == '\x1B') {
+            while (letter < line.size() && line[letter] != 'm')
+                ++letter;
+            ++letter;
+        }
+        return letter;
+    }
+}
+
+struct act_template {
+    bool valid;
+    bool colored; // ends with the recipient's normal color
+    std::string text;
+    std::vector<token> tokens;
+};
+
+struct render_state {
+    std::vector<facet> facets; // of the recipient being rendered for
+    std::vector<facet> seen; // every line's facets, one after the other
+    std::vector<std::string> lines;
+    int line_count;
+};
+
+namespace {
+    typedef std::unordered_map<std::string, act_template> template_map;
+
+    template_map templates;
+    std::string lookup_text;
+    act_template_stats totals;
+
+    // One per act() being rendered; a CAN_SEE() inside one act() may start
+    // another.
+    std::deque<render_state> states;
+    size_t depth;
+
+    void compile_into(act_template& compiled)
+    {
+        const std::string& text = compiled.text;
+        compiled.valid = true;
+        compiled.colored = false;
+
+        size_t literal = 0;
+        for (size_t at = 0; at < text.size(); ++at) {
+            if (text[at] != '$')
+                continue;
+
+            token code = { FIXED, 0, -1, 0, 0 };
+            if (at + 1 < text.size())
+                code.code = text[at + 1];
+
+            switch (code.code) {
+            case 'C':
+                code.kind = COLOR;
+                code.color = at + 2 < text.size() ? color_of(text[at + 2]) : -1;
+                if (code.color < 0) {
+                    compiled.valid = false;
+                    return;
+                }
+                compiled.colored = true;
+                break;
+            case 'n':
+            case 'N':
+            case 'K':
+                code.kind = PERSON;
+                break;
+            case 'o':
+            case 'O':
+            case 'p':
+            case 'P':
+                code.kind = OBJECT;
+                break;
+            case 'm':
+            case 'M':
+            case 's':
+            case 'S':
+            case 'e':
+            case 'E':
+            case 'a':
+            case 'A':
+            case 'T':
+            case 'F':
+            case 'b':
+            case 'B':
+            case '$':
+                break;
+            default:
+                compiled.valid = false;
+                return;
+            }
+
+            if (at > literal) {
+                token run = { LITERAL, 0, -1, int(literal), int(at - literal) };
+                compiled.tokens.push_back(run);
+            }
+            compiled.tokens.push_back(code);
+
+            at += code.kind == COLOR ? 2 : 1;
+            literal = at + 1;
+        }
+
+        if (literal < text.size()) {
+            token run = { LITERAL, 0, -1, int(literal), int(text.size() - literal) };
+            compiled.tokens.push_back(run);
+        }
+    }
+}
+
+//============================================================================
+const act_template* compile(const char* format)
+{
+    lookup_text.assign(format);
+    template_map::iterator found = templates.find(lookup_text);
+    if (found != templates.end())
+        return found->second.valid ? &found->second : 0;
+
+    // Messages built with sprintf() would fill the map for ever.  Nothing
+    // is being rendered at depth 0, so nothing refers to the templates.
+    if (depth == 0 && int(templates.size()) >= act_template_limit) {
+        templates.clear();
+        ++totals.flushes;
+    }
+
+    act_template& compiled = templates[lookup_text];
+    compiled.text = lookup_text;
+    compile_into(compiled);
+    ++totals.compiles;
+    return compiled.valid ? &compiled : 0;
+}
+
+//============================================================================
+act_renderer::act_renderer(const act_template* compiled, char_data* ch, obj_data* obj, void* vict_obj)
+    : m_template(compiled)
+    , m_ch(ch)
+    , m_obj(obj)
+    , m_vict_obj(vict_obj)
+{
+    if (states.size() <= depth)
+        states.push_back(render_state());
+    m_state = &states[depth++];
+    m_state->seen.clear();
+    m_state->line_count = 0;
+}
+
+//============================================================================
+act_renderer::~act_renderer()
+{
+    --depth;
+}
+
+//============================================================================
+const char* act_renderer::text_for(char_data* to)
+{
+    if (!m_template)
+        return "";
+
+    // In the order convert_string() met them, for the sake of CAN_SEE().
+    std::vector<facet>& facets = m_state->facets;
+    facets.clear();
+    for (const token& code : m_template->tokens) {
+        switch (code.kind) {
+        case COLOR:
+            facets.push_back(make_facet(0, CC_USE(to, code.color), 0));
+            break;
+        case PERSON: {
+            char_data* person = code.code == 'n' ? m_ch : (char_data*)m_vict_obj;
+            int kind = pers_kind(person, to, code.code == 'K');
+            if (kind == PERS_ENEMY)
+                facets.push_back(make_facet(kind, CC_USE(to, COLOR_ENMY), CC_NORM(to)));
+            else
+                facets.push_back(make_facet(kind, 0, 0));
+            break;
+        }
+        case OBJECT: {
+            obj_data* object = (code.code == 'o' || code.code == 'p') ? m_obj : (obj_data*)m_vict_obj;
+            facets.push_back(make_facet(CAN_SEE_OBJ(to, object), 0, 0));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    if (m_template->colored)
+        facets.push_back(make_facet(0, 0, CC_NORM(to)));
+
+    ++totals.lines;
+    const std::vector<facet>& seen = m_state->seen;
+    size_t count = facets.size();
+    for (int line = 0; line < m_state->line_count; ++line) {
+        const facet* other = &seen[line * count];
+        bool same = true;
+        for (size_t facet_at = 0; same && facet_at < count; ++facet_at)
+            same = facets[facet_at] == other[facet_at];
+        if (same)
+            return m_state->lines[line].c_str();
+    }
+
+    render(to);
+    return m_state->lines[m_state->line_count - 1].c_str();
+}
+
+//============================================================================
+void act_renderer::render(char_data* to)
+{
+    render_state& state = *m_state;
+    state.seen.insert(state.seen.end(), state.facets.begin(), state.facets.end());
+    if (int(state.lines.size()) <= state.line_count)
+        state.lines.push_back(std::string());
+    std::string& line = state.lines[state.line_count++];
+    line.clear();
+    ++totals.renders;
+
+    // This follows convert_string(), color clobbering and all.
+    const char* used_color = 0;
+    bool clobbered_color = false;
+    const facet* next = &state.facets[0];
+    char_data* vict = (char_data*)m_vict_obj;
+    obj_data* vict_obj = (obj_data*)m_vict_obj;
+
+    for (const token& code : m_template->tokens) {
+        if (code.kind == LITERAL) {
+            line.append(m_template->text, code.start, code.length);
+            continue;
+        }
+
+        const char* i = "";
+        switch (code.kind) {
+        case COLOR:
+            i = used_color = (next++)->color;
+            break;
+        case PERSON:
+            // Any recipient with these facets sees the same name.
+            i = pers_name(next->kind, code.code == 'n' ? m_ch : vict, to);
+            if (code.code != 'K')
+                clobbered_color = true;
+            ++next;
+            break;
+        case OBJECT: {
+            obj_data* object = (code.code == 'o' || code.code == 'p') ? m_obj : vict_obj;
+            if (!(next++)->kind)
+                i = "something";
+            else if (code.code == 'o' || code.code == 'O')
+                i = fname(object->name);
+            else
+                i = object->short_description;
+            break;
+        }
+        default:
+            switch (code.code) {
+            case 'm':
+                i = HMHR(m_ch);
+                break;
+            case 'M':
+                i = HMHR(vict);
+                break;
+            case 's':
+                i = HSHR(m_ch);
+                break;
+            case 'S':
+                i = HSHR(vict);
+                break;
+            case 'e':
+                i = HSSH(m_ch);
+                break;
+            case 'E':
+                i = HSSH(vict);
+                break;
+            case 'a':
+                i = SANA(m_obj);
+                break;
+            case 'A':
+                i = SANA(vict_obj);
+                break;
+            case 'T':
+                i = (char*)m_vict_obj;
+                break;
+            case 'F':
+                i = fname((char*)m_vict_obj);
+                break;
+            case 'b':
+                i = GET_CURRPART(m_ch);
+                break;
+            case 'B':
+                i = GET_CURRPART(vict);
+                break;
+            case '$':
+                i = "$";
+                break;
+            }
+        }
+        line += i;
+
+        if (clobbered_color && used_color) {
+            line += used_color;
+            clobbered_color = false;
+        }
+    }
+
+    line += "\n\r";
+    if (used_color)
+        line += (next++)->normal;
+
+    size_t first = skip_colors(line, 0);
+    if (first < line.size() && isalpha((unsigned char)line[first]))
+        line[first] = UPPER(line[first]);
+}
+
+//============================================================================
+act_template_stats stats()
+{
+    act_template_stats current = totals;
+    current.templates = int(templates.size());
+    return current;
+}
+}
@@ -0,0 +1,69 @@
+/* act_template.h */
+// Compiled act() messages.  act() used to hand the format string to
+// convert_string() once for every character in the room, parsing the
+// $-codes and building the line afresh even when most of the room was to
+// be sent the very same text.
+//
+// A format string is now compiled once into runs of literal text and
+// codes, and kept by its text.  To send it to a room, act() asks an
+// act_renderer for each recipient's line.  The renderer works out only
+// what depends on the recipient -- whether they see each character and
+// object the message names, whether a character is an enemy to them, and
+// the colors they use -- and builds the line once for each different
+// answer.
+//
+// Those answers call CAN_SEE() as convert_string() did, in the same
+// order, so its dice and the messages it may itself send are unchanged.
+
+#ifndef ACT_TEMPLATE_H
+#define ACT_TEMPLATE_H
+#pragma once
+
+struct char_data;
+struct obj_data;
+
+namespace game_text {
+struct act_template;
+struct render_state;
+
+// The compiled form of 'format', or null if it holds a code act() does not
+// know, which convert_string() is left to report as before.
+const act_template* compile(const char* format);
+
+// Renders one act() call.  Characters that are sent the same text share
+// the line rendered for the first of them.  act() may be called again
+// while a renderer is alive, as CAN_SEE() sometimes does.
+class act_renderer {
+public:
+    act_renderer(const act_template* compiled, char_data* ch, obj_data* obj, void* vict_obj);
+    ~act_renderer();
+
+    // The line 'to' is sent, as convert_string() would write it.  Valid
+    // until the renderer is destroyed.
+    const char* text_for(char_data* to);
+
+private:
+    act_renderer(const act_renderer&);
+    act_renderer& operator=(const act_renderer&);
+
+    void render(char_data* to);
+
+    const act_template* m_template;
+    char_data* m_ch;
+    obj_data* m_obj;
+    void* m_vict_obj;
+    render_state* m_state;
+};
+
+struct act_template_stats {
+    int templates; // compiled and kept
+    unsigned long compiles;
+    unsigned long flushes; // times the kept templates passed the limit
+    unsigned long lines; // sent by act_renderers
+    unsigned long renders; // lines actually built
+};
+
+act_template_stats stats();
+}
+
+#endif /* ACT_TEMPLATE_H */
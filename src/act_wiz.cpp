@@ -14,17 +14,24 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "act_template.h"
 #include "char_utils.h"
 #include "color.h"
 #include "comm.h"
+#include "command_journal.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "mob_activity.h"
 #include "mudlle.h"
+#include "name_index.h"
+#include "pathfind.h"
 #include "pkill.h"
 #include "profs.h"
 #include "protos.h"
+#include "save_queue.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -54,7 +61,6 @@ extern int top_of_p_table;
 extern byte language_number;
 
 extern int txt_block_counter;
-extern int affected_type_counter;
 
 extern unsigned long stat_ticks_passed;
 extern unsigned long stat_mortals_counter;
@@ -1087,7 +1093,7 @@ ACMD(do_wizstat)
         if (!*buf2) {
             send_to_char("Stats on which player?\n\r", ch);
         } else {
-            CREATE(victim, struct char_data, 1);
+            victim = game_memory::character_pool.allocate();
             clear_char(victim, MOB_VOID);
             if (load_char(buf2, &tmp_store) > -1) {
                 store_to_char(&tmp_store, victim);
@@ -1098,7 +1104,7 @@ ACMD(do_wizstat)
                 free_char(victim);
             } else {
                 send_to_char("There is no such player.\n\r", ch);
-                RELEASE(victim);
+                game_memory::character_pool.release(victim);
             }
         }
     } else if (is_abbrev(buf1, "object")) {
@@ -2319,18 +2325,17 @@ ACMD(do_show)
 {
     struct char_file_u vbuf;
     int i, j, k, l, con, count;
-    ;
+    size_t len;
     char self = 0;
     struct char_data* vict;
     struct obj_data* obj;
     struct alias_list* list;
     char field[40], value[40], birth[80];
     universal_list* tmplist;
+    struct descriptor_data* d;
 
     extern char* prof_abbrevs[];
     extern char* genders[];
-    extern int buf_switches, buf_largecount, buf_overflows;
-    extern int memory_rec_counter;
     extern universal_list* affected_list;
 
     struct show_struct {
@@ -2348,6 +2353,8 @@ ACMD(do_show)
         { "affected", LEVEL_GOD },
         { "aliases", LEVEL_AREAGOD },
         { "exploits", LEVEL_AREAGOD },
+        { "network", LEVEL_GRGOD },
+        { "memory", LEVEL_GRGOD },
         { "\n", 0 }
     };
 
@@ -2448,13 +2455,48 @@ ACMD(do_show)
             buf, k, top_of_objt + 1);
         sprintf(buf, "%s  %5d rooms            %5d zones\n\r",
             buf, top_of_world + 1, top_of_zone_table + 1);
-        sprintf(buf, "%s  %5d large bufs\n\r", buf, buf_largecount);
-        sprintf(buf, "%s  %5d buf switches     %5d overflows\n\r", buf,
-            buf_switches, buf_overflows);
+        len = strlen(buf);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %5d output segments  %5d pooled\n\r",
+            game_net::output_segments.allocated, game_net::output_segments.pooled);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %5lu path searches  %5lu cached steps  %lu rooms searched\n\r",
+            game_path::path_totals.searches, game_path::path_totals.cache_hits,
+            game_path::path_totals.rooms_expanded);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %5lu portals searched %5lu zone routes measured\n\r",
+            game_path::path_totals.portals_expanded, game_path::path_totals.zones_measured);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %5d mobiles filed    %5d busy  %d zones awake  %d visited last pulse\n\r",
+            game_activity::activity_totals.filed, game_activity::activity_totals.busy,
+            game_activity::activity_totals.awake_zones, game_activity::activity_totals.last_visits);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %5lu mobile visits   %5lu in sleeping zones  %lu put off by the budget\n\r",
+            game_activity::activity_totals.visits, game_activity::activity_totals.sleeping_visits,
+            game_activity::activity_totals.deferred);
+        {
+            game_save::save_stats saves = game_save::stats();
+            len += snprintf(buf + len, sizeof(buf) - len, "  %5lu saves written  %5d queued (%d max)  %lu coalesced  %lu failed\n\r",
+                saves.written, saves.queue_depth, saves.max_queue_depth, saves.coalesced, saves.failed);
+            len += snprintf(buf + len, sizeof(buf) - len, "  %5lu save batches   %5lu us mean latency  %lu us max\n\r",
+                saves.batches, saves.written ? saves.total_latency_us / saves.written : 0,
+                saves.max_latency_us);
+        }
+        {
+            game_journal::journal_stats journal = game_journal::stats();
+            len += snprintf(buf + len, sizeof(buf) - len, "  %5lu commands logged %5lu streamed  %lu dropped  %lu log restarts\n\r",
+                journal.recorded, journal.streamed, journal.dropped, journal.restarts);
+        }
+        {
+            game_index::name_index_stats chars = game_index::char_name_stats();
+            game_index::name_index_stats objs = game_index::obj_name_stats();
+            len += snprintf(buf + len, sizeof(buf) - len, "  %5lu name searches  %5lu candidates offered  %d char keys  %d obj keys\n\r",
+                chars.searches + objs.searches, chars.candidates + objs.candidates, chars.keys, objs.keys);
+        }
+        {
+            game_text::act_template_stats acts = game_text::stats();
+            len += snprintf(buf + len, sizeof(buf) - len, "  %5lu act lines sent %5lu rendered  %d templates kept  %lu compiled  %lu flushes\n\r",
+                acts.lines, acts.renders, acts.templates, acts.compiles, acts.flushes);
+        }
         sprintf(buf, "%s  %5d txt_blocks       %5d affect_blocks\n\r", buf,
-            txt_block_counter, affected_type_counter);
+            txt_block_counter, game_memory::affect_pool.stats().live);
         sprintf(buf, "%s  %5d pkill records    %5d mobile memories \n\r", buf,
-            pkill_get_total(), memory_rec_counter);
+            pkill_get_total(), game_memory::memory_pool.stats().live);
 
         if (!stat_ticks_passed)
             sprintf(buf, "%s  No player statistics yet\n\r", buf);
@@ -2541,6 +2583,52 @@ ACMD(do_show)
         print_exploits(ch, value);
         break;
 
+    case 11: {
+        const game_net::send_stats& totals = game_net::send_totals;
+        extern int max_output_queue;
+
+        len = sprintf(buf, "Output since boot:\n\r");
+        len += snprintf(buf + len, sizeof(buf) - len, "  %10lu bytes queued   %10lu bytes sent\n\r",
+            totals.bytes_queued, totals.bytes_sent);
+        len += snprintf(buf + len, sizeof(buf) - len, "  %10lu writes         %10lu stalls\n\r",
+            totals.write_calls, totals.stalls);
+        snprintf(buf + len, sizeof(buf) - len, "  %10lu overflows      %10d peak queue (limit %d)\n\r",
+            totals.overflows, totals.peak_queue, max_output_queue);
+        send_to_char(buf, ch);
+
+        strcpy(buf, "Connections with output waiting:\n\r");
+        len = strlen(buf);
+        for (j = 0, d = descriptor_list; d; d = d->next) {
+            if (!d->descriptor || d->output_queue.is_empty())
+                continue;
+            len += snprintf(buf + len, sizeof(buf) - len, "  %3d %-16s %8d bytes%s\n\r", d->descriptor,
+                (d->character && GET_NAME(d->character)) ? GET_NAME(d->character) : d->host,
+                d->output_queue.length,
+                IS_SET(d->dflags, DFLAG_WRITE_BLOCKED) ? " (blocked)" : "");
+            if (++j > 40) {
+                strcat(buf, "  *** More... ***\n\r");
+                break;
+            }
+        }
+        if (!j)
+            strcat(buf, "  None.\n\r");
+        send_to_char(buf, ch);
+        break;
+    }
+
+    case 12:
+        strcpy(buf, "Pool               size   live   peak   free  slabs  allocations\n\r");
+        len = strlen(buf);
+        for (const game_memory::slab_pool_base* pool : game_memory::slab_pool_base::pools()) {
+            game_memory::pool_stats stats = pool->stats();
+            len += snprintf(buf + len, sizeof(buf) - len, "  %-16s %4d %6d %6d %6d %6d  %11lu\n\r",
+                stats.name, stats.object_size, stats.live, stats.peak, stats.free,
+                stats.slabs, stats.allocations);
+        }
+        send_to_char(buf, ch);
+        break;
+
+
     default:
         send_to_char("Sorry, I don't understand that.\n\r", ch);
         break;
@@ -2710,7 +2798,7 @@ ACMD(do_wizset)
             player_i = -1;
 
     } else if (is_file) {
-        CREATE(cbuf, struct char_data, 1);
+        cbuf = game_memory::character_pool.allocate();
         clear_char(cbuf, MOB_VOID);
         if ((player_i = load_char(name, &tmp_store)) > -1) {
             store_to_char(&tmp_store, cbuf);
@@ -2726,7 +2814,7 @@ ACMD(do_wizset)
             cbuf->desc = &descr;
             vict = cbuf;
         } else {
-            RELEASE(cbuf);
+            game_memory::character_pool.release(cbuf);
             send_to_char("There is no such player.\n\r", ch);
             return;
         }
@@ -3498,6 +3586,7 @@ ACMD(do_rehash)
 
     count1 = 0;
     while (affected_list) {
+        cancel_affect_update(affected_list);
         from_list_to_pool(&affected_list, &affected_list_pool, affected_list);
         count1++;
     }
@@ -3510,6 +3599,7 @@ ACMD(do_rehash)
             tmplist->ptr.ch = tmpch;
             tmplist->number = tmpch->abs_number;
             tmplist->type = TARGET_CHAR;
+            schedule_affect_update(tmplist);
 
             count2++;
         }
@@ -3530,6 +3620,7 @@ ACMD(do_rehash)
             tmplist->ptr.room = &world[num];
             tmplist->number = world[num].number;
             tmplist->type = TARGET_ROOM;
+            schedule_affect_update(tmplist);
 
             count2++;
         }
@@ -0,0 +1,182 @@
+/* area_files.cpp */
+
+#include "area_files.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace game_boot {
+namespace {
+    struct mapping_job {
+        area_directory directory;
+        std::thread worker;
+    };
+
+    // Only the main thread touches this list; each worker writes to its own job.
+    std::vector<std::unique_ptr<mapping_job>> jobs;
+
+    //========================================================================
+    // Counts the lines whose first non-blank character is '#', as
+    // count_hash_records() did with fgets(), and returns one less.
+    int count_records(const char* data, size_t length)
+    {
+        int count = 0;
+        const char* end = data + length;
+        for (const char* line = data; line < end;) {
+            const char* at = line;
+            while (at < end && *at != '\n' && (unsigned char)*at <= ' ')
+                ++at;
+            if (at < end && *at == '#')
+                ++count;
+
+            while (at < end && *at != '\n')
+                ++at;
+            line = at + 1;
+        }
+        return count - 1;
+    }
+
+    //========================================================================
+    bool map_file(area_file& file)
+    {
+        file.data = 0;
+        file.length = 0;
+        file.records = -1;
+        file.digest = DIGEST_START;
+
+        int fd = open(file.path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat status;
+        if (fstat(fd, &status) < 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+
+        if (status.st_size > 0) {
+            void* data = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                close(fd);
+                errno = error;
+                return false;
+            }
+            madvise(data, status.st_size, MADV_SEQUENTIAL);
+
+            file.data = static_cast<const char*>(data);
+            file.length = status.st_size;
+            // Counting reads every page, so the worker takes the disk reads
+            // rather than the loader.
+            file.records = count_records(file.data, file.length);
+            file.digest = digest_bytes(DIGEST_START, file.data, file.length);
+        }
+        close(fd);
+        return true;
+    }
+
+    //========================================================================
+    void map_directory(area_directory* directory, std::string index_filename)
+    {
+        std::string index_path = directory->prefix + "/" + index_filename;
+        FILE* index = fopen(index_path.c_str(), "r");
+        if (!index) {
+            directory->error = errno;
+            directory->failed_path = index_path;
+            directory->index_missing = true;
+            return;
+        }
+
+        char name[256];
+        while (fscanf(index, "%255s", name) == 1 && *name != '$') {
+            area_file file;
+            file.path = directory->prefix + "/" + name;
+            if (!map_file(file)) {
+                directory->error = errno;
+                directory->failed_path = file.path;
+                break;
+            }
+            directory->files.push_back(file);
+        }
+        fclose(index);
+    }
+
+    //========================================================================
+    mapping_job* start_job(const char* prefix, const char* index_filename)
+    {
+        std::unique_ptr<mapping_job> job(new mapping_job);
+        job->directory.prefix = prefix;
+        job->directory.error = 0;
+        job->directory.index_missing = false;
+        job->worker = std::thread(map_directory, &job->directory, std::string(index_filename));
+
+        jobs.push_back(std::move(job));
+        return jobs.back().get();
+    }
+}
+
+//============================================================================
+// FNV-1a, which is quick enough to run over every mapped page.
+unsigned long long digest_bytes(unsigned long long digest, const void* data, size_t length)
+{
+    const unsigned char* byte = static_cast<const unsigned char*>(data);
+    for (size_t at = 0; at < length; ++at) {
+        digest ^= byte[at];
+        digest *= 1099511628211ULL;
+    }
+    return digest;
+}
+
+//============================================================================
+void map_areas(const char* const prefixes[], int count, const char* index_filename)
+{
+    for (int prefix = 0; prefix < count; ++prefix)
+        start_job(prefixes[prefix], index_filename);
+}
+
+//============================================================================
+const area_directory& mapped_areas(const char* prefix, const char* index_filename)
+{
+    mapping_job* found = 0;
+    for (const std::unique_ptr<mapping_job>& job : jobs)
+        if (job->directory.prefix == prefix)
+            found = job.get();
+
+    if (!found)
+        found = start_job(prefix, index_filename);
+
+    if (found->worker.joinable())
+        found->worker.join();
+    return found->directory;
+}
+
+//============================================================================
+FILE* open_area(const area_file& file)
+{
+    // fmemopen() refuses an empty buffer.
+    if (!file.data)
+        return fopen(file.path.c_str(), "r");
+
+    return fmemopen(const_cast<char*>(file.data), file.length, "r");
+}
+
+//============================================================================
+void unmap_areas()
+{
+    for (const std::unique_ptr<mapping_job>& job : jobs) {
+        if (job->worker.joinable())
+            job->worker.join();
+        for (const area_file& file : job->directory.files)
+            if (file.data)
+                munmap(const_cast<char*>(file.data), file.length);
+    }
+    jobs.clear();
+}
+}
@@ -0,0 +1,53 @@
+/* area_files.h */
+// Maps the world files into memory at boot.  Each world directory (wld, mob,
+// obj, ...) is read on its own worker thread while the main thread is busy
+// with the directories before it, so index_boot() finds its files already
+// in memory and their records already counted.
+
+#ifndef AREA_FILES_H
+#define AREA_FILES_H
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace game_boot {
+struct area_file {
+    std::string path; // "prefix/name", as the index lists it
+    const char* data; // the mapped file, or null if it is empty
+    size_t length;
+    int records; // as count_hash_records() counted them: one less than the '#' lines
+    unsigned long long digest; // of the contents, for world_snapshot.h
+};
+
+struct area_directory {
+    std::string prefix;
+    std::vector<area_file> files; // in index order
+    std::string failed_path; // the file that could not be mapped, if any
+    int error; // errno for failed_path, or 0
+    bool index_missing; // failed_path is the index itself
+};
+
+// Folds 'length' bytes into a running digest that starts at DIGEST_START.
+const unsigned long long DIGEST_START = 14695981039346656037ULL;
+unsigned long long digest_bytes(unsigned long long digest, const void* data, size_t length);
+
+// Starts mapping the files listed in each directory's index, one worker per
+// directory.  'index_filename' is "index", "index.min" or "index.new".
+void map_areas(const char* const prefixes[], int count, const char* index_filename);
+
+// Waits for the worker mapping 'prefix' and returns what it found.  Starts
+// one first if map_areas() was not asked for this directory.
+const area_directory& mapped_areas(const char* prefix, const char* index_filename);
+
+// Opens a read-only stream over a mapped file for the existing loaders.
+FILE* open_area(const area_file& file);
+
+// Unmaps every world file.  Must be called once boot is done: OLC rewrites
+// these files, and a mapping over a truncated file faults.
+void unmap_areas();
+}
+
+#endif /* AREA_FILES_H */
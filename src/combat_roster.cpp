@@ -0,0 +1,81 @@
+/* combat_roster.cpp */
+
+#include "combat_roster.h"
+
+#include "platdef.h"
+#include "structs.h"
+
+namespace game_rules {
+//============================================================================
+combat_roster::iterator::iterator(const combat_roster* roster, int place)
+    : m_roster(roster)
+    , m_place(place)
+{
+    skip_vacant();
+}
+
+//============================================================================
+combat_roster::iterator& combat_roster::iterator::operator++()
+{
+    --m_place;
+    skip_vacant();
+    return *this;
+}
+
+//============================================================================
+void combat_roster::iterator::skip_vacant()
+{
+    while (m_place >= 0 && !m_roster->m_fighters[m_place])
+        --m_place;
+}
+
+//============================================================================
+combat_roster::combat_roster()
+    : m_vacant(0)
+{
+}
+
+//============================================================================
+bool combat_roster::contains(const char_data* ch) const
+{
+    return ch->combat_slot != 0;
+}
+
+//============================================================================
+void combat_roster::add(char_data* ch)
+{
+    if (contains(ch))
+        return;
+
+    m_fighters.push_back(ch);
+    ch->combat_slot = int(m_fighters.size());
+}
+
+//============================================================================
+void combat_roster::remove(char_data* ch)
+{
+    if (!contains(ch))
+        return;
+
+    m_fighters[ch->combat_slot - 1] = 0;
+    ch->combat_slot = 0;
+    ++m_vacant;
+}
+
+//============================================================================
+void combat_roster::compact()
+{
+    if (!m_vacant)
+        return;
+
+    int kept = 0;
+    for (char_data* fighter : m_fighters) {
+        if (fighter) {
+            m_fighters[kept++] = fighter;
+            fighter->combat_slot = kept;
+        }
+    }
+    m_fighters.resize(kept);
+    m_vacant = 0;
+}
+}
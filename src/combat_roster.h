@@ -0,0 +1,70 @@
+/* combat_roster.h */
+// The characters taking part in fights.  They are kept in one array in the
+// order they joined, and each knows its place in it, so that joining and
+// leaving cost the same however many others are fighting, and a combat
+// round walks an array rather than a linked list.
+//
+// A character that leaves only vacates its place; the array is closed up by
+// compact(), which perform_violence() calls once its round is over.  So
+// characters can leave -- die, flee, be extracted -- while the roster is
+// being walked, by the round or by anything the round calls.
+
+#ifndef COMBAT_ROSTER_H
+#define COMBAT_ROSTER_H
+#pragma once
+
+#include <vector>
+
+struct char_data;
+
+namespace game_rules {
+class combat_roster {
+public:
+    combat_roster();
+
+    // Walks the fighters from the newest to the oldest, skipping vacated
+    // places.  Fighters that join during the walk are not reached.
+    class iterator {
+    public:
+        iterator(const combat_roster* roster, int place);
+
+        char_data* operator*() const { return m_roster->m_fighters[m_place]; }
+        iterator& operator++();
+        bool operator!=(const iterator& other) const { return m_place != other.m_place; }
+
+    private:
+        void skip_vacant();
+
+        const combat_roster* m_roster;
+        int m_place;
+    };
+
+    iterator begin() const { return iterator(this, int(m_fighters.size()) - 1); }
+    iterator end() const { return iterator(this, -1); }
+
+    bool contains(const char_data* ch) const;
+    void add(char_data* ch);
+    void remove(char_data* ch);
+
+    // Closes up vacated places.  Must not be called while the roster is
+    // being walked.
+    void compact();
+
+    // The number of places, vacated ones included, and the fighter in one
+    // of them, or null if it is vacant.  For walks that need to know where
+    // they are.
+    int places() const { return int(m_fighters.size()); }
+    char_data* at(int place) const { return m_fighters[place]; }
+
+    // How many are fighting.
+    int size() const { return int(m_fighters.size()) - m_vacant; }
+
+private:
+    std::vector<char_data*> m_fighters;
+    int m_vacant;
+};
+}
+
+extern game_rules::combat_roster combat_list;
+
+#endif /* COMBAT_ROSTER_H */
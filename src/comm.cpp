@@ -20,14 +20,18 @@
 #include <signal.h>
 #include <string.h>
 
+#include "act_template.h"
 #include "big_brother.h"
 #include "char_utils.h"
 #include "color.h"
 #include "comm.h"
+#include "command_journal.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "reactor.h"
+#include "save_queue.h"
 #include "script.h"
 #include "skill_timer.h"
 #include "spells.h"
@@ -72,28 +76,23 @@ extern unsigned long stat_darkie_legend_counter;
 
 /* local globals */
 struct descriptor_data *descriptor_list = 0, *next_to_process = 0;
-struct txt_block* bufpool = 0; /* pool of large output buffers */
-int buf_largecount; /* # of large buffers which exist */
-int buf_overflows; /* # of overflows of output */
-int buf_switches; /* # of switches from small to large buf */
 int circle_shutdown = 0; /* clean shutdown */
+volatile sig_atomic_t shutdown_signalled = 0; /* by SIGHUP, SIGINT or SIGTERM */
 int circle_reboot = 0; /* reboot the game after a shutdown */
 int no_specials = 0; /* Suppress ass. of special routines */
 int last_desc = 0; /* last unique num assigned to a desc. */
 SocketType mother_desc = 0; /* file desc of the mother connection */
-SocketType maxdesc; /* highest desc num used */
 int avail_descs; /* max descriptors available */
 int tics = 0; /* for extern checkpointing */
 int has_proxy; /* Game expects to be proxied */
 
-FILE* fpCommand; // DEBUGGING
-int iCommands = 0;
-
 struct txt_block* txt_block_pool = 0;
 int txt_block_counter = 0;
 
 extern int nameserver_is_slow; /* see config.c */
 extern int autosave_time; /* see config.c */
+extern int max_output_queue; /* see config.c */
+extern long command_journal_bytes; /* see config.c */
 
 /* functions in this file */
 int get_from_q(struct txt_q* queue, char* dest);
@@ -104,8 +103,9 @@ SocketType pnew_connection(SocketType s);
 SocketType pnew_descriptor(SocketType s);
 int process_output(struct descriptor_data* t);
 int process_input(struct descriptor_data* t);
+int flush_descriptor(struct descriptor_data* d);
+void output_overflow(struct descriptor_data* d);
 void close_sockets(SocketType s);
-struct timeval timediff(struct timeval* a, struct timeval* b);
 void flush_queues(struct descriptor_data* d);
 void nonblock(SocketType s);
 int perform_subst(struct descriptor_data* t, char* orig, char* subst);
@@ -145,6 +145,9 @@ void sigsegv_handler(int sig)
     // print out all the frames to stderr
     fprintf(stderr, "Error: signal %d:\n", sig);
     backtrace_symbols_fd(array, size, STDERR_FILENO);
+
+    // the commands that led up to it, including any not yet in last_cmds
+    game_journal::dump("crash_journal");
     exit(1);
 }
 
@@ -244,7 +247,7 @@ int main(int argc, char** argv)
 
     // Open command log
     system("mv -f last_cmds crash_cmds");
-    fpCommand = fopen("last_cmds", "w");
+    game_journal::start("last_cmds", command_journal_bytes);
     srandom(time(0));
     run_the_game(port);
     return (0);
@@ -280,6 +283,9 @@ void run_the_game(sh_int port)
 
     close_sockets(s);
     // fclose(player_fl);
+    game_save::stop();
+    game_journal::stop();
+    save_player_index_file();
 
     if (circle_reboot) {
         log("Rebooting.");
@@ -352,104 +358,55 @@ void untrack_specialized_mage(char_data* mage)
 void add_prompt(char* prompt, struct char_data* ch, long flag);
 
 /* Accept pnew connects, relay commands, and call 'heartbeat-functs' */
-timeval opt_time;
 int pulse = 0; // moved here from being a local variable
+game_net::reactor event_reactor;
+
+void heartbeat();
 
 void game_loop(SocketType s)
 {
-    fd_set input_set, output_set, exc_set;
-    struct timeval last_time, now, timespent, timeout, null_time;
     char comm[MAX_INPUT_LENGTH];
     char prompt[MAX_INPUT_LENGTH];
     char* pptr;
     struct descriptor_data *point, *next_point;
     struct char_data *wait_ch, *wait_tmp;
-    int mins_since_crashsave = 0, mask;
-    int sockets_connected, sockets_playing;
-    int tmp, was_updated;
+    struct rlimit fd_limit;
+    int mask, tmp, pulse_due;
     char disp, tmpflag;
-    char buf[100];
-
-    null_time.tv_sec = 0;
-    null_time.tv_usec = 0;
-
-    opt_time.tv_usec = OPT_USEC; /* Init time values */
-    opt_time.tv_sec = 0;
-    gettimeofday(&last_time, NULL);
 
-    maxdesc = s;
+    /* epoll has no FD_SETSIZE ceiling; the process file limit is what counts */
+    if (!getrlimit(RLIMIT_NOFILE, &fd_limit) && fd_limit.rlim_cur != RLIM_INFINITY)
+        avail_descs = int(fd_limit.rlim_cur) - 8;
+    else
+        avail_descs = MAX_DESCRIPTORS_AVAILABLE;
 
-#if defined(OPEN_MAX)
-    avail_descs = OPEN_MAX - 8;
-#elif defined(USE_TABLE_SIZE)
-    {
-        int retval;
+    avail_descs = std::min(avail_descs, MAX_PLAYERS);
 
-        retval = setdtablesize(64);
-        if (retval == -1)
-            log("SYSERR: unable to set table size");
-        else {
-            sprintf(buf, "%s %d\n", "dtablesize set to: ", retval);
-            log(buf);
-        }
-        avail_descs = getdtablesize() - 8;
+    if (!event_reactor.open(s, OPT_USEC)) {
+        log("SYSERR: Unable to start the event reactor.");
+        return;
     }
-#else
-    avail_descs = MAX_DESCRIPTORS_AVAILABLE;
-#endif
-
-    avail_descs = std::min(avail_descs, MAX_PLAYERS);
 
     mask = sigmask(SIGUSR1) | sigmask(SIGUSR2) | sigmask(SIGALRM) | sigmask(SIGTERM) | sigmask(SIGURG) | sigmask(SIGXCPU) | sigmask(SIGHUP) | sigmask(SIGSEGV) | sigmask(SIGBUS);
 
     /* Main loop */
     while (!circle_shutdown) {
-        /* Check what's happening out there */
-        FD_ZERO(&input_set);
-        FD_ZERO(&output_set);
-        FD_ZERO(&exc_set);
-        FD_SET(s, &input_set);
-        for (point = descriptor_list; point; point = point->next)
-            if (point->descriptor) {
-                FD_SET(point->descriptor, &input_set);
-                FD_SET(point->descriptor, &exc_set);
-                FD_SET(point->descriptor, &output_set);
-            }
-
-        /* check out the time */
-        gettimeofday(&now, NULL);
-        timespent = timediff(&now, &last_time);
-        timeout = timediff(&opt_time, &timespent);
-        last_time.tv_sec = now.tv_sec + timeout.tv_sec;
-        last_time.tv_usec = now.tv_usec + timeout.tv_usec;
-
-        if (last_time.tv_usec >= 1000000) {
-            last_time.tv_usec -= 1000000;
-            last_time.tv_sec++;
-        }
-
+        /* Sleep until somebody talks to us or the next pulse is due */
         sigsetmask(mask);
 
-        if ((tmp = select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) < 0)) {
-            if (errno != EINTR) {
-                perror("Select poll");
-                return;
-            }
-        }
-
-        if (select(0, (fd_set*)0, (fd_set*)0, (fd_set*)0, &timeout) < 0) {
-            if (errno != EINTR) {
-                perror("Select sleep");
-                exit(1);
-            }
+        if (!event_reactor.wait()) {
+            sigsetmask(0);
+            return;
         }
 
         sigsetmask(0);
 
+        pulse_due = event_reactor.is_pulse_due();
+
         /* Respond to whatever might be happening */
 
         /* Pnew connection? */
-        if (FD_ISSET(s, &input_set)) {
+        if (event_reactor.has_new_connection()) {
             if (pnew_descriptor(s) == 0) // here was <0, had to change
             {
                 perror("Pnew connection");
@@ -460,9 +417,7 @@ void game_loop(SocketType s)
         for (point = descriptor_list; point; point = next_point) {
             next_point = point->next;
             if (point->descriptor) {
-                if (FD_ISSET(point->descriptor, &exc_set)) {
-                    FD_CLR(point->descriptor, &input_set);
-                    FD_CLR(point->descriptor, &output_set);
+                if (IS_SET(point->dflags, DFLAG_SOCKET_ERROR)) {
                     close_socket(point, FALSE);
                 }
             }
@@ -472,7 +427,7 @@ void game_loop(SocketType s)
         for (point = descriptor_list; point; point = next_point) {
             next_point = point->next;
             if (point->descriptor) {
-                if (FD_ISSET(point->descriptor, &input_set)) {
+                if (IS_SET(point->dflags, DFLAG_INPUT_READY)) {
                     if (process_input(point) < 0) {
                         close_socket(point, FALSE);
                     }
@@ -481,35 +436,41 @@ void game_loop(SocketType s)
         }
 
         /* process_commands */
-        for (wait_ch = waiting_list; wait_ch; wait_ch = wait_tmp) {
-            if (wait_ch->delay.wait_value > 0) {
-                (wait_ch->delay.wait_value)--;
-            }
+        if (pulse_due) {
+            for (wait_ch = waiting_list; wait_ch; wait_ch = wait_tmp) {
+                if (wait_ch->delay.wait_value > 0) {
+                    (wait_ch->delay.wait_value)--;
+                }
 
-            if (wait_ch->delay.wait_value > 0) {
-                if (!IS_NPC(wait_ch) && IS_AFFECTED(wait_ch, AFF_WAITWHEEL)) {
-                    if (PRF_FLAGGED(wait_ch, PRF_SPINNER)) {
-                        write_to_descriptor(wait_ch->desc->descriptor, wait_wheel[wait_ch->delay.wait_value % 8]);
+                if (wait_ch->delay.wait_value > 0) {
+                    if (!IS_NPC(wait_ch) && IS_AFFECTED(wait_ch, AFF_WAITWHEEL)) {
+                        if (PRF_FLAGGED(wait_ch, PRF_SPINNER)) {
+                            write_to_descriptor(wait_ch->desc, wait_wheel[wait_ch->delay.wait_value % 8]);
+                        }
                     }
-                }
 
-                wait_tmp = wait_ch->delay.next;
-            } else if (wait_ch->delay.wait_value == 0) {
-                /* here is the block calling actual procedures */
-                complete_delay(wait_ch);
-                wait_tmp = wait_ch->delay.next;
+                    wait_tmp = wait_ch->delay.next;
+                } else if (wait_ch->delay.wait_value == 0) {
+                    /* here is the block calling actual procedures */
+                    complete_delay(wait_ch);
+                    wait_tmp = wait_ch->delay.next;
 
-                if (wait_ch->delay.wait_value == 0)
-                    /* look out for the similar code in raw_kill() */
-                    abort_delay(wait_ch);
-            } else {
-                wait_tmp = wait_ch->delay.next;
+                    if (wait_ch->delay.wait_value == 0)
+                        /* look out for the similar code in raw_kill() */
+                        abort_delay(wait_ch);
+                } else {
+                    wait_tmp = wait_ch->delay.next;
+                }
             }
         }
 
         for (point = descriptor_list; point; point = next_to_process) {
             next_to_process = point->next;
-            if (point->descriptor) {
+            if (pulse_due)
+                REMOVE_BIT(point->dflags, DFLAG_COMMAND_DONE);
+
+            /* only one command per pulse, however often the network wakes us */
+            if (point->descriptor && !IS_SET(point->dflags, DFLAG_COMMAND_DONE)) {
                 if (point->character)
                     tmpflag = (!IS_AFFECTED(point->character, AFF_WAITING));
                 else
@@ -534,6 +495,7 @@ void game_loop(SocketType s)
                         string_add(point, comm);
                     }
 
+                    SET_BIT(point->dflags, DFLAG_COMMAND_DONE);
                     point->prompt_mode = 1;
                     if (!point->connected) {
                         if (point->showstr_point) {
@@ -554,7 +516,7 @@ void game_loop(SocketType s)
         for (point = descriptor_list; point; point = next_point) {
             next_point = point->next;
             if (point->descriptor) {
-                if (FD_ISSET(point->descriptor, &output_set) && *(point->output)) {
+                if (!point->output.is_empty()) {
                     if (process_output(point) < 0) {
                         close_socket(point, FALSE);
                     } else {
@@ -568,7 +530,7 @@ void game_loop(SocketType s)
         for (point = descriptor_list; point; point = next_to_process) {
             next_to_process = point->next;
             if (point->descriptor) {
-                if (STATE(point) == CON_CLOSE) {
+                if (STATE(point) == CON_CLOSE || IS_SET(point->dflags, DFLAG_SOCKET_ERROR)) {
                     close_socket(point, FALSE);
                 }
             }
@@ -583,10 +545,10 @@ void game_loop(SocketType s)
                     tmp = !(point->connected);
                 }
                 if (tmp) {
-                    write_to_descriptor(point->descriptor, "] ");
+                    write_to_descriptor(point, "] ");
                 } else if (!point->connected) {
                     if (point->showstr_point)
-                        write_to_descriptor(point->descriptor,
+                        write_to_descriptor(point,
                             "*** Press return to continue, q to quit ***");
                     else { /*if point->showstr_point */
                         struct char_data* opponent;
@@ -679,108 +641,144 @@ void game_loop(SocketType s)
                         else
                             tmpflag = 1;
                         if (tmpflag)
-                            write_to_descriptor(point->descriptor, pptr);
+                            write_to_descriptor(point, pptr);
                     }
                 }
                 point->prompt_mode = 0;
             }
 
-        /* handle heartbeat stuff */
-        /* Note: pulse now changes every 1/4 sec  */
-
-        pulse++;
-        was_updated = 0;
-
-        if (!((pulse + 3) % PULSE_ZONE)) {
-            zone_update();
-        }
-        if (!((pulse + 9) % PULSE_MOBILE)) {
-            mobile_activity();
-            was_updated = 1;
-        }
-        perform_violence(pulse % (PULSE_VIOLENCE * 2));
-        /* parry is restored in 2 combat (PULSE_VIOLENCE) rounds */
-
-        if (!((pulse % (SECS_PER_MUD_HOUR * 4)))) {
-            weather_and_time(1);
-            point_update(); // putting affect_total call in point_update.
-            stat_update();
-            was_updated = 1;
+        /* send everything queued during this pass, one writev() per socket */
+        for (point = descriptor_list; point; point = next_point) {
+            next_point = point->next;
+            if (point->descriptor) {
+                if (flush_descriptor(point) < 0) {
+                    close_socket(point, FALSE);
+                }
+            }
         }
-        if (!(pulse % (PULSE_FAST_UPDATE)) /*&& !was_updated*/) {
-            // now increasing hp/mp/mana/spirit fast in fast_update..
-            fast_update();
-            affect_update();
 
-            // clean-up expose elements
-            clean_expose_elements();
+        if (pulse_due) {
+            event_reactor.consume_pulse();
+            heartbeat();
         }
 
-        if (!(pulse % (60 * 4))) /* one minute */
-        {
-            if (++mins_since_crashsave >= autosave_time) {
-                mins_since_crashsave = 0;
-                Crash_save_all();
+        // Save chars before a shutdown or reboot.  --S
+        if (circle_shutdown || circle_reboot) {
+            struct char_data* ch;
+
+            for (ch = character_list; ch; ch = ch->next) {
+                if (!IS_NPC(ch) && ch->desc) {
+                    save_char(ch, NOWHERE, 0);
+                    Crash_crashsave(ch);
+                }
             }
         }
+    }
 
-        if (!(pulse % 4)) {
-            game_timer::skill_timer& st_instance = game_timer::skill_timer::instance();
-            st_instance.update_skill_timer();
-        }
+    /* everyone was saved above, on the pass that saw the shutdown */
+    if (shutdown_signalled)
+        log("Received SIGHUP, SIGINT, or SIGTERM.  Shutting down...");
 
-        if (!(pulse % 1200)) {
-            sockets_connected = sockets_playing = 0;
+    event_reactor.close();
+}
 
-            for (point = descriptor_list; point; point = next_point) {
-                next_point = point->next;
-                if (point->descriptor) {
-                    sockets_connected++;
-                    if (!point->connected) {
-                        sockets_playing++;
-                    }
-                }
-            }
+/* Runs everything that is driven by the pulse counter; called once per pulse */
+void heartbeat()
+{
+    static int mins_since_crashsave = 0;
+    struct descriptor_data* point;
+    int sockets_connected, sockets_playing;
+    int was_updated;
+    char buf[100];
 
-            sprintf(buf, "nusage: %-3d sockets connected, %-3d sockets playing",
-                sockets_connected, sockets_playing);
-            log(buf);
+    /* handle heartbeat stuff */
+    /* Note: pulse now changes every 1/4 sec  */
 
-#ifdef RUSAGE
-            {
-                struct rusage rusagedata;
-
-                getrusage(0, &rusagedata);
-                sprintf(buf, "rusage: %d %d %d %d %d %d %d",
-                    rusagedata.ru_utime.tv_sec,
-                    rusagedata.ru_stime.tv_sec,
-                    rusagedata.ru_maxrss,
-                    rusagedata.ru_ixrss,
-                    rusagedata.ru_ismrss,
-                    rusagedata.ru_idrss,
-                    rusagedata.ru_isrss);
-                log(buf);
-            }
-#endif
-        }
+    pulse++;
+    was_updated = 0;
 
-        if (pulse >= 2400)
-            pulse = 0;
+    if (!((pulse + 3) % PULSE_ZONE)) {
+        zone_update();
+    }
+    if (!((pulse + 9) % PULSE_MOBILE)) {
+        mobile_activity();
+        was_updated = 1;
+    }
+    perform_violence(pulse % (PULSE_VIOLENCE * 2));
+    /* parry is restored in 2 combat (PULSE_VIOLENCE) rounds */
+
+    if (!((pulse % (SECS_PER_MUD_HOUR * 4)))) {
+        weather_and_time(1);
+        point_update(); // putting affect_total call in point_update.
+        stat_update();
+        was_updated = 1;
+    }
+    if (!(pulse % (PULSE_FAST_UPDATE)) /*&& !was_updated*/) {
+        // now increasing hp/mp/mana/spirit fast in fast_update..
+        fast_update();
+        affect_update();
 
-        tics++; /* tics since last checkpoint signal */
+        // clean-up expose elements
+        clean_expose_elements();
+    }
 
-        // Save chars before a shutdown or reboot.  --S
-        if (circle_shutdown || circle_reboot) {
-            struct char_data* ch;
+    if (!(pulse % (60 * 4))) /* one minute */
+    {
+        if (++mins_since_crashsave >= autosave_time) {
+            mins_since_crashsave = 0;
+            Crash_save_all();
+        }
+    }
 
-            for (ch = character_list; ch; ch = ch->next) {
-                if (!IS_NPC(ch) && ch->desc) {
-                    save_char(ch, NOWHERE, 0);
-                    Crash_crashsave(ch);
+    if (!(pulse % 4)) {
+        game_timer::skill_timer& st_instance = game_timer::skill_timer::instance();
+        st_instance.update_skill_timer();
+    }
+
+    if (!(pulse % 1200)) {
+        sockets_connected = sockets_playing = 0;
+
+        for (point = descriptor_list; point; point = point->next) {
+            if (point->descriptor) {
+                sockets_connected++;
+                if (!point->connected) {
+                    sockets_playing++;
                 }
             }
         }
+
+        sprintf(buf, "nusage: %-3d sockets connected, %-3d sockets playing",
+            sockets_connected, sockets_playing);
+        log(buf);
+
+        if (event_reactor.get_dropped_pulses()) {
+            sprintf(buf, "nusage: %lu pulses dropped while lagging",
+                event_reactor.get_dropped_pulses());
+            log(buf);
+        }
+
+#ifdef RUSAGE
+        {
+            struct rusage rusagedata;
+
+            getrusage(0, &rusagedata);
+            sprintf(buf, "rusage: %d %d %d %d %d %d %d",
+                rusagedata.ru_utime.tv_sec,
+                rusagedata.ru_stime.tv_sec,
+                rusagedata.ru_maxrss,
+                rusagedata.ru_ixrss,
+                rusagedata.ru_ismrss,
+                rusagedata.ru_idrss,
+                rusagedata.ru_isrss);
+            log(buf);
+        }
+#endif
     }
+
+    if (pulse >= 2400)
+        pulse = 0;
+
+    tics++; /* tics since last checkpoint signal */
 }
 
 /* ******************************************************************
@@ -805,47 +803,33 @@ int get_from_q(struct txt_q* queue, char* dest)
     return (1);
 }
 
-void write_to_output(const char* txt, struct descriptor_data* t)
+/* A client this far behind is not coming back; close it on the next pass */
+void output_overflow(struct descriptor_data* d)
 {
-    int size;
+    vmudlog(NRM, "Output overflow on socket %d [%s], closing.",
+        d->descriptor, d->host);
+    game_net::send_totals.overflows++;
+    SET_BIT(d->dflags, DFLAG_SOCKET_ERROR);
+}
 
-    size = strlen(txt);
+void write_to_output(const char* txt, struct descriptor_data* t)
+{
+    write_to_output(txt, strlen(txt), t);
+}
 
-    /* if we're in the overflow state already, ignore this */
-    if (t->bufptr < 0)
+void write_to_output(const char* txt, int size, struct descriptor_data* t)
+{
+    /* a connection marked for closing gets nothing more */
+    if (IS_SET(t->dflags, DFLAG_SOCKET_ERROR))
         return;
 
-    /* if we have enough space, just write to buffer and that's it! */
-    if (t->bufspace >= size) {
-        strcpy(t->output + t->bufptr, txt);
-        t->bufspace -= size;
-        t->bufptr += size;
-    } else { /* otherwise, try to switch to a large buffer */
-        if (t->large_outbuf || ((size + strlen(t->output)) > LARGE_BUFSIZE)) {
-            /* we're already using large buffer, or even the large buffer
-            in't big enough -- switch to overflow state */
-            t->bufptr = -1;
-            buf_overflows++;
-            return;
-        }
-
-        buf_switches++;
-        /* if the pool has a buffer in it, grab it */
-        if (bufpool) {
-            t->large_outbuf = bufpool;
-            bufpool = bufpool->next;
-        } else { /* else create one */
-            CREATE(t->large_outbuf, struct txt_block, 1);
-            CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
-            buf_largecount++;
-        }
-
-        strcpy(t->large_outbuf->text, t->output);
-        t->output = t->large_outbuf->text;
-        strcpy(t->output + strlen(t->output), txt);
-        t->bufspace = LARGE_BUFSIZE - 1 - strlen(t->output);
-        t->bufptr = strlen(t->output);
+    /* the chain has no size limit of its own, but nobody reads this fast */
+    if (t->output.length + size > max_output_queue) {
+        output_overflow(t);
+        return;
     }
+
+    t->output.append(txt, size);
 }
 
 struct txt_block* get_from_txt_block_pool(char* line)
@@ -928,31 +912,11 @@ void write_to_q_lang(char* txt, struct txt_q* queue, int freq)
     }
 }
 
-struct timeval timediff(struct timeval* a, struct timeval* b)
-{
-    struct timeval rslt, tmp;
-
-    tmp = *a;
-
-    if ((rslt.tv_usec = tmp.tv_usec - b->tv_usec) < 0) {
-        rslt.tv_usec += 1000000;
-        --(tmp.tv_sec);
-    }
-    if ((rslt.tv_sec = tmp.tv_sec - b->tv_sec) < 0) {
-        rslt.tv_usec = 0;
-        rslt.tv_sec = 0;
-    }
-    return (rslt);
-}
-
 /* Empty the queues before closing connection */
 void flush_queues(struct descriptor_data* d)
 {
-    if (d->large_outbuf) {
-        d->large_outbuf->next = bufpool;
-        bufpool = d->large_outbuf;
-        d->large_outbuf = 0;
-    }
+    d->output.clear();
+    d->output_queue.release();
 
     while (get_from_q(&d->input, buf2))
         ;
@@ -1060,13 +1024,13 @@ SocketType pnew_descriptor(SocketType s)
         }
     }
 
-    /*	if ((maxdesc + 1) >= avail_descs) */
     if (sockets_connected >= avail_descs) {
-        write_to_descriptor(desc, "Sorry, RotS is full right now... try again later!  :-)\n\r");
+        /* no descriptor to queue on yet; this is one small write to a fresh socket */
+        const char* full_message = "Sorry, RotS is full right now... try again later!  :-)\n\r";
+        write(desc, full_message, strlen(full_message));
         close(desc);
         return (0);
-    } else if (desc > maxdesc)
-        maxdesc = desc;
+    }
 
     CREATE(pnewd, struct descriptor_data, 1);
 
@@ -1137,10 +1101,6 @@ SocketType pnew_descriptor(SocketType s)
     pnewd->showstr_head = 0;
     pnewd->showstr_point = 0;
     *pnewd->last_input = '\0';
-    pnewd->output = pnewd->small_outbuf;
-    *(pnewd->output) = '\0';
-    pnewd->bufspace = SMALL_BUFSIZE - 1;
-    pnewd->large_outbuf = NULL;
     pnewd->input.head = NULL;
     pnewd->next = descriptor_list;
     pnewd->character = 0;
@@ -1156,6 +1116,12 @@ SocketType pnew_descriptor(SocketType s)
     //   pnewd->desc_num = last_desc;
     pnewd->desc_num = int(desc);
 
+    if (!event_reactor.watch(pnewd)) {
+        close(desc);
+        RELEASE(pnewd);
+        return (0);
+    }
+
     /* prepend to list */
 
     descriptor_data* cur_list = descriptor_list;
@@ -1169,150 +1135,136 @@ SocketType pnew_descriptor(SocketType s)
 
 extern sh_int screen_width; /* config.cpp */
 
-void append_lines(char* target, char* source, int* len)
-{
-    register sh_int i, tmp;
-    int sourcelen;
-
-    tmp = *len;
-    sourcelen = strlen(source);
-
-    for (i = 0; i < sourcelen; i++) {
-        *(target++) = source[i];
-        tmp++;
-        if (source[i] == '\r')
-            tmp = 0;
-        if (source[i] == '\n')
-            tmp--;
-        if (tmp > screen_width) {
-            *(target++) = '\n';
-            *(target++) = '\r';
-            tmp = 0;
-        }
+/*
+ * Moves composed text into the send queue of a connection, wrapping long
+ * lines and unaccenting latin-1 on the way, and mirrors exactly what was
+ * queued to whoever is snooping.  The text is written straight into the
+ * send queue's storage, so nothing is copied into a staging buffer first.
+ */
+struct output_filter {
+    struct descriptor_data* d;
+    struct descriptor_data* snooper;
+    bool wrap;
+    bool strip_accents;
+    int column;
+
+    explicit output_filter(struct descriptor_data* t)
+        : d(t)
+        , snooper(t->snoop.snoop_by ? t->snoop.snoop_by->desc : 0)
+        , wrap(t->character && PRF_FLAGGED(t->character, PRF_WRAP))
+        , strip_accents(t->character && !PRF_FLAGGED(t->character, PRF_LATIN1))
+        , column(0)
+    {
     }
-    *len = tmp;
-    *target = 0;
-}
 
-char process_output_buffer[LARGE_BUFSIZE + 20];
+    /* returns false if the send queue is over its limit */
+    bool put(const char* text, int length)
+    {
+        char *start, *out, *end;
+        char c;
+        int space;
+
+        while (length > 0) {
+            /* room for one character plus a wrap */
+            start = d->output_queue.reserve(3, max_output_queue, space);
+            if (!start)
+                return false;
+
+            out = start;
+            end = start + space - 2;
+            while (length > 0 && out < end) {
+                c = *(text++);
+                --length;
+
+                /* they don't have latin-1 set; drop what we can't unaccent */
+                if (strip_accents && !(c = unaccent(c)))
+                    continue;
+
+                *(out++) = c;
+                if (wrap) {
+                    column++;
+                    if (c == '\r')
+                        column = 0;
+                    if (c == '\n')
+                        column--;
+                    if (column > screen_width) {
+                        *(out++) = '\n';
+                        *(out++) = '\r';
+                        column = 0;
+                    }
+                }
+            }
+
+            d->output_queue.commit(out - start);
+            if (snooper)
+                write_to_output(start, out - start, snooper);
+        }
+        return true;
+    }
+};
 
 int process_output(struct descriptor_data* t)
 {
-    char *i = process_output_buffer, *c;
-    int wid_count, i_shift;
-    /* start writing at the 2nd space so we can prepend "% " for snoop */
-    wid_count = 0;
-    if (!t->prompt_mode && !t->connected) {
-        strcpy(i + 2, "\n\r");
-        i_shift = 2;
-    } else
-        i_shift = 0;
-    if ((t->character) && (IS_SET(PRF_FLAGS(t->character), PRF_WRAP)))
-        append_lines(i + 2 + i_shift, t->output, &wid_count);
-    else
-        strcpy(i + 2 + i_shift, t->output);
+    output_filter filter(t);
+    game_net::output_segment* segment;
+    int ok = TRUE;
 
-    /* they don't have latin-1 set. unaccent all of our latin-1 chars */
-    if (t->character)
-        if (!PRF_FLAGGED(t->character, PRF_LATIN1))
-            for (c = i + 2; *c; ++c)
-                *c = unaccent(*c);
+    if (filter.snooper)
+        write_to_output("% ", 2, filter.snooper);
 
-    if (t->bufptr < 0)
-        strcat(i + 2, "**OVERFLOW**");
+    if (!t->prompt_mode && !t->connected)
+        ok = filter.put("\n\r", 2);
 
-    if (!t->connected && !(t->character && !IS_NPC(t->character) && PRF_FLAGGED(t->character, PRF_COMPACT)))
-        strcat(i + 2, "\n\r");
+    for (segment = t->output.head; segment && ok; segment = segment->next)
+        ok = filter.put(segment->text, segment->used);
 
-    if (write_to_descriptor(t->descriptor, i + 2) < 0)
-        return -1;
+    if (ok && !t->connected && !(t->character && !IS_NPC(t->character) && PRF_FLAGGED(t->character, PRF_COMPACT)))
+        ok = filter.put("\n\r", 2);
 
-    if (t->snoop.snoop_by) {
-        i[0] = '%';
-        i[1] = ' ';
-        SEND_TO_Q(i, t->snoop.snoop_by->desc);
-    }
+    t->output.clear();
 
-    /* if we were using a large buffer, put the large buffer on the buffer
-      pool and switch back to the small one */
-    if (t->large_outbuf) {
-        t->large_outbuf->next = bufpool;
-        bufpool = t->large_outbuf;
-        t->large_outbuf = NULL;
-        t->output = t->small_outbuf;
+    if (!ok) {
+        output_overflow(t);
+        return -1;
     }
 
-    /* reset total bufspace back to that of a small buffer */
-    t->bufspace = SMALL_BUFSIZE - 1;
-    t->bufptr = 0;
-    *(t->output) = '\0';
-
     return 1;
 }
 
-// New version (similar to circle ver 3) April 2001 - Fingolfin
-// Not windows compatible (not finished and not working...), but c'est la vie...
-
-int write_to_descriptor_new(int desc, char* txt)
+/*
+ * Queues text for a connection.  Nothing is written here; the game loop
+ * flushes every queue once per pass with flush_descriptor(), so a client
+ * that stops reading can never stall the loop.  A client that falls more
+ * than max_output_queue bytes behind is marked for disconnection instead.
+ */
+int write_to_descriptor(struct descriptor_data* d, const char* txt)
 {
-    int result, length;
-
-    length = strlen(txt);
-
-    while (length > 0) {
+    if (!d || d->descriptor <= 0 || IS_SET(d->dflags, DFLAG_SOCKET_ERROR))
+        return (-1);
 
-        result = write(desc, txt, length);
-
-        if (result <= 0) {
-            if (result == 0) {
-                /* This should never happen! */
-                log("SYSERR: Huh??  write() returned 0???  Please report this!");
-                return (-1);
-            }
-
-            if (errno == EWOULDBLOCK) {
-                perror("WARNING: socket would block, about to close");
-                return (-1);
-            } else {
-                /* Fatal error.  Disconnect the player. */
-                perror("SYSERR: Write to socket");
-                return (-1);
-            }
-        }
-
-        txt += result;
-        length -= result;
+    if (!d->output_queue.append(txt, strlen(txt), max_output_queue)) {
+        output_overflow(d);
+        return (-1);
     }
+
     return (0);
 }
 
-// old version replaced with above April 2001 - Fingolfin
-
-int write_to_descriptor(int desc, char* txt)
+/* Hands the queued output of a connection to the kernel */
+int flush_descriptor(struct descriptor_data* d)
 {
-    int sofar, thisround, total;
+    int pending;
 
-    total = strlen(txt);
-    sofar = 0;
+    if (d->output_queue.is_empty() || IS_SET(d->dflags, DFLAG_WRITE_BLOCKED))
+        return (0);
 
-    if (desc <= 0) {
-        return 0;
-    }
+    pending = d->output_queue.flush(d->descriptor);
+    if (pending < 0)
+        return (-1);
 
-    try {
-        do {
-            thisround = write(desc, txt + sofar, total - sofar);
-            if (thisround < 0) {
-                perror("Write to socket");
-                return (-1);
-            }
-            sofar += thisround;
-        } while (sofar < total);
-    }
-    catch(...) {
-        vmudlog(NRM, "Exception in write_to_descriptor");
-        return -1;
-    }
+    /* the socket is full; the reactor clears this when it drains */
+    if (pending > 0)
+        SET_BIT(d->dflags, DFLAG_WRITE_BLOCKED);
 
     return (0);
 }
@@ -1361,25 +1313,28 @@ int process_input(struct descriptor_data* t)
     sofar = flag = 0;
     begin = strlen(t->buf);
 
-    /* Read in some stuff */
-    do {
+    /* Read in some stuff.  The socket is edge-triggered, so keep reading
+       until it would block; if the buffer fills first, DFLAG_INPUT_READY
+       stays set and we come back for the rest on the next pass. */
+    while (begin + sofar < MAX_STRING_LENGTH - 1) {
         thisround = read(t->descriptor, t->buf + begin + sofar,
             MAX_STRING_LENGTH - (begin + sofar) - 1);
         if (thisround > 0)
             sofar += thisround;
-        else {
-            if (thisround < 0)
-                if (errno != EWOULDBLOCK) {
-                    perror("Read1 - ERROR");
-                    return (-1);
-                } else
-                    break;
-            else {
-                log("EOF encountered on socket read.");
+        else if (thisround < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                perror("Read1 - ERROR");
                 return (-1);
             }
+            REMOVE_BIT(t->dflags, DFLAG_INPUT_READY);
+            break;
+        } else {
+            log("EOF encountered on socket read.");
+            return (-1);
         }
-    } while (!ISNEWL(*(t->buf + begin + sofar - 1)));
+    }
 
     if (t->character)
         t->character->specials.timer = 0;
@@ -1388,8 +1343,14 @@ int process_input(struct descriptor_data* t)
 
     /* if no pnewline is contained in input, return without proc'ing */
     for (i = begin; !ISNEWL(*(t->buf + i)); i++)
-        if (!*(t->buf + i))
+        if (!*(t->buf + i)) {
+            /* a full buffer without a single newline will never drain */
+            if (begin + sofar >= MAX_STRING_LENGTH - 1) {
+                log("Input buffer overflow on socket read.");
+                return (-1);
+            }
             return (0);
+        }
 
     /* input contains 1 or more pnewlines; process the stuff */
     for (i = 0, k = 0; *(t->buf + i);) {
@@ -1429,17 +1390,8 @@ int process_input(struct descriptor_data* t)
                 strcpy(t->last_input, tmp);
 
             // COMMAND LOG
-            if (iCommands == 200) {
-                fclose(fpCommand);
-                fpCommand = fopen("last_cmds", "w");
-                iCommands = 0;
-            }
-
             if ((t->connected == CON_PLYNG) && (t->character))
-                fprintf(fpCommand, "%3d %-16s: %s\n", t->descriptor, GET_NAME(t->character), tmp);
-
-            iCommands++;
-            fflush(fpCommand);
+                game_journal::record(t, tmp);
 
             if (!failed_subst)
                 write_to_q(tmp, &t->input);
@@ -1452,7 +1404,7 @@ int process_input(struct descriptor_data* t)
 
             if (flag) {
                 sprintf(buffer, "Line too long.  Truncated to:\n\r%s\n\r", tmp);
-                if (write_to_descriptor(t->descriptor, buffer) < 0)
+                if (write_to_descriptor(t, buffer) < 0)
                     return (-1);
 
                 /* skip the rest of the line */
@@ -1532,15 +1484,16 @@ void close_socket(descriptor_data* conn_descriptor, int drop_all)
         sprintf(buf, "Closing socket %d.", conn_descriptor->descriptor);
         mudlog(buf, NRM, LEVEL_IMPL, TRUE);
 
+        /* last chance for anything still queued, e.g. a quit message */
+        flush_descriptor(conn_descriptor);
+        event_reactor.unwatch(conn_descriptor);
         close(conn_descriptor->descriptor);
         conn_descriptor->descriptor = 0;
+        REMOVE_BIT(conn_descriptor->dflags, DFLAG_INPUT_READY | DFLAG_SOCKET_ERROR);
         conn_descriptor->desc_num = -1;
     }
 
     flush_queues(conn_descriptor);
-    if (conn_descriptor->descriptor == maxdesc) {
-        --maxdesc;
-    }
 
     /* Forget snooping */
     if (conn_descriptor->snoop.snooping) {
@@ -1920,11 +1873,20 @@ void convert_string(const char* str, int hide_invisible, struct char_data* ch,
 }
 
 char act_buffer[MAX_STRING_LENGTH];
+
+/*
+ * act() renders 'str' through a compiled template: everyone in
+ * the room who would be sent the same line shares one rendering
+ * of it.  Only a string with a code the templates do not know
+ * goes through convert_string() for each character, which then
+ * complains about it.
+ */
 void act(const char* str, int hide_invisible, struct char_data* ch,
     struct obj_data* obj, void* vict_obj, int type, char spam_only)
 {
     struct char_data* to;
-    char* buf = act_buffer;
+    const game_text::act_template* compiled;
+    const char* text;
 
     if (!str)
         return;
@@ -1946,12 +1908,21 @@ void act(const char* str, int hide_invisible, struct char_data* ch,
 
     if (!to)
         return;
+
+    compiled = game_text::compile(str);
+    game_text::act_renderer renderer(compiled, ch, obj, vict_obj);
+
     //   printf("act(%s) called, to=%p\n",str, to);
     for (; to; to = to->next_in_room) {
         if (to->desc && (to != ch || type == TO_CHAR) && (CAN_SEE(to, ch) || !hide_invisible) && (AWAKE(to) || type == TO_VICT) && !PLR_FLAGGED(to, PLR_WRITING) && !(type == TO_NOTVICT && to == (struct char_data*)vict_obj) && (!spam_only || PRF_FLAGGED(to, PRF_SPAM))) {
-            convert_string(str, hide_invisible, ch, obj, vict_obj, to, buf);
-            if (*buf != '\0')
-                SEND_TO_Q(buf, to->desc);
+            if (compiled)
+                text = renderer.text_for(to);
+            else {
+                convert_string(str, hide_invisible, ch, obj, vict_obj, to, act_buffer);
+                text = act_buffer;
+            }
+            if (*text != '\0')
+                SEND_TO_Q(text, to->desc);
         }
         if ((type == TO_VICT) || (type == TO_CHAR))
             return;
@@ -45,17 +45,15 @@ void act(const char* str, int hide_invisible, struct char_data* ch,
 #define TO_NOTVICT 2
 #define TO_CHAR 3
 
-int write_to_descriptor(int desc, char* txt);
+int write_to_descriptor(struct descriptor_data* d, const char* txt);
 void write_to_q(char* txt, struct txt_q* queue);
 void write_to_output(const char* txt, struct descriptor_data* d);
+void write_to_output(const char* txt, int size, struct descriptor_data* d);
 void page_string(struct descriptor_data* d, char* str, int keep_internal);
 
 /* #define SEND_TO_Q(messg, desc)  write_to_q((messg), &(desc)->output) */
 #define SEND_TO_Q(messg, desc) write_to_output((messg), desc)
 
-#define USING_SMALL(d) ((d)->output == (d)->small_outbuf)
-#define USING_LARGE(d) (!USING_SMALL(d))
-
 // Implemented in spec_ass.cc.
 typedef int (*special_func_ptr)(char_data* host, char_data* character, int cmd, char* argument, int call_flag, waiting_type* wait_list);
 void* virt_program_number(int number);
@@ -0,0 +1,266 @@
+/* command_journal.cpp */
+
+#include "command_journal.h"
+
+#include "platdef.h"
+#include "structs.h"
+#include "utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+
+namespace game_journal {
+namespace {
+    const int NAME_BYTES = 20;
+    const int LINE_BYTES = MAX_INPUT_LENGTH + 80;
+    const std::chrono::milliseconds FLUSH_INTERVAL(250);
+
+    struct journal_entry {
+        long seconds;
+        long microseconds;
+        int descriptor;
+        long character; // player id number
+        char name[NAME_BYTES];
+        int length;
+        char command[MAX_INPUT_LENGTH];
+    };
+
+    // 'sequence' is the number of the command held plus one, or zero while
+    // the writer is filling the slot in.
+    struct journal_slot {
+        std::atomic<unsigned long> sequence;
+        journal_entry entry;
+    };
+
+    journal_slot ring[JOURNAL_RECORDS];
+    std::atomic<unsigned long> head(0); // commands recorded since boot
+
+    std::atomic<unsigned long> streamed(0);
+    std::atomic<unsigned long> dropped(0);
+    std::atomic<unsigned long> restarts(0);
+
+    std::thread* flusher = 0;
+    std::atomic<bool> stopping(false);
+    FILE* journal_file = 0;
+    char journal_path[256];
+    long journal_limit = 0;
+
+    //========================================================================
+    // Copies command 'number' out of the ring.  False if it has been, or is
+    // being, overwritten by a later one.
+    bool copy(unsigned long number, journal_entry& entry)
+    {
+        const journal_slot& slot = ring[number % JOURNAL_RECORDS];
+        unsigned long sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != number + 1)
+            return false;
+
+        memcpy(&entry, &slot.entry, sizeof(entry));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    //========================================================================
+    // Formatting for dump() may not use stdio, so lines are put together by
+    // hand.
+    char* append_text(char* out, const char* text, int length)
+    {
+        memcpy(out, text, length);
+        return out + length;
+    }
+
+    char* append_number(char* out, long number, int width, char pad)
+    {
+        char digits[24];
+        int count = 0;
+        bool negative = number < 0;
+        unsigned long magnitude = negative ? 0UL - (unsigned long)number : (unsigned long)number;
+
+        do {
+            digits[count++] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (negative)
+            digits[count++] = '-';
+
+        for (; width > count; --width)
+            *out++ = pad;
+        while (count)
+            *out++ = digits[--count];
+        return out;
+    }
+
+    // "seconds.microseconds descriptor name (id): command"
+    int format_entry(const journal_entry& entry, char* line)
+    {
+        char* out = line;
+        out = append_number(out, entry.seconds, 0, ' ');
+        *out++ = '.';
+        out = append_number(out, entry.microseconds, 6, '0');
+        *out++ = ' ';
+        out = append_number(out, entry.descriptor, 3, ' ');
+        *out++ = ' ';
+        out = append_text(out, entry.name, strnlen(entry.name, NAME_BYTES));
+        out = append_text(out, " (", 2);
+        out = append_number(out, entry.character, 0, ' ');
+        out = append_text(out, "): ", 3);
+        out = append_text(out, entry.command, entry.length);
+        *out++ = '\n';
+        return int(out - line);
+    }
+
+    //========================================================================
+    // Writes the commands from 'cursor' up to the head to the journal file,
+    // and moves the cursor past them.  The file is started again first if
+    // it has grown past the limit, so it always ends with the latest.
+    void stream(unsigned long& cursor)
+    {
+        unsigned long recorded = head.load(std::memory_order_acquire);
+        if (recorded - cursor > (unsigned long)JOURNAL_RECORDS) {
+            dropped += recorded - JOURNAL_RECORDS - cursor;
+            cursor = recorded - JOURNAL_RECORDS;
+        }
+        if (cursor == recorded)
+            return;
+
+        if (journal_limit > 0 && ftell(journal_file) > journal_limit) {
+            FILE* fresh = freopen(journal_path, "w", journal_file);
+            if (!fresh) {
+                perror(journal_path);
+                journal_file = 0;
+                return;
+            }
+            journal_file = fresh;
+            ++restarts;
+        }
+
+        char line[LINE_BYTES];
+        journal_entry entry;
+        for (; cursor != recorded; ++cursor) {
+            if (!copy(cursor, entry)) {
+                ++dropped;
+                continue;
+            }
+            fwrite(line, 1, format_entry(entry, line), journal_file);
+            ++streamed;
+        }
+        fflush(journal_file);
+    }
+
+    //========================================================================
+    void run_flusher(unsigned long cursor)
+    {
+        for (;;) {
+            bool last = stopping.load(std::memory_order_acquire);
+            if (journal_file)
+                stream(cursor);
+            if (last)
+                return;
+            std::this_thread::sleep_for(FLUSH_INTERVAL);
+        }
+    }
+
+    // The flusher takes no signals; their handlers work on game state and
+    // must run on the game thread.
+    std::thread* start_flusher(unsigned long cursor)
+    {
+        sigset_t all, old;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &old);
+        std::thread* started = new std::thread(run_flusher, cursor);
+        pthread_sigmask(SIG_SETMASK, &old, 0);
+        return started;
+    }
+}
+
+//============================================================================
+void record(const descriptor_data* descriptor, const char* command)
+{
+    const char_data* ch = descriptor->character;
+    unsigned long number = head.load(std::memory_order_relaxed);
+    journal_slot& slot = ring[number % JOURNAL_RECORDS];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    journal_entry& entry = slot.entry;
+    struct timeval now;
+    gettimeofday(&now, 0);
+    entry.seconds = now.tv_sec;
+    entry.microseconds = now.tv_usec;
+    entry.descriptor = descriptor->descriptor;
+    entry.character = ch ? GET_IDNUM(ch) : -1;
+    strncpy(entry.name, (ch && GET_NAME(ch)) ? GET_NAME(ch) : "", NAME_BYTES);
+    entry.length = int(strnlen(command, MAX_INPUT_LENGTH));
+    memcpy(entry.command, command, entry.length);
+
+    slot.sequence.store(number + 1, std::memory_order_release);
+    head.store(number + 1, std::memory_order_release);
+}
+
+//============================================================================
+void start(const char* path, long limit)
+{
+    if (flusher)
+        return;
+
+    journal_file = fopen(path, "w");
+    if (!journal_file) {
+        perror(path);
+        return;
+    }
+    strncpy(journal_path, path, sizeof(journal_path) - 1);
+    journal_limit = limit;
+    flusher = start_flusher(head.load(std::memory_order_acquire));
+}
+
+//============================================================================
+void stop()
+{
+    if (!flusher)
+        return;
+
+    stopping.store(true, std::memory_order_release);
+    flusher->join();
+    if (journal_file)
+        fclose(journal_file);
+    journal_file = 0;
+}
+
+//============================================================================
+void dump(const char* path)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return;
+
+    unsigned long recorded = head.load(std::memory_order_acquire);
+    unsigned long number = recorded > (unsigned long)JOURNAL_RECORDS ? recorded - JOURNAL_RECORDS : 0;
+
+    char line[LINE_BYTES];
+    journal_entry entry;
+    for (; number != recorded; ++number)
+        if (copy(number, entry) && write(fd, line, format_entry(entry, line)) < 0)
+            break;
+    close(fd);
+}
+
+//============================================================================
+journal_stats stats()
+{
+    journal_stats totals;
+    totals.recorded = head.load(std::memory_order_relaxed);
+    totals.streamed = streamed.load(std::memory_order_relaxed);
+    totals.dropped = dropped.load(std::memory_order_relaxed);
+    totals.restarts = restarts.load(std::memory_order_relaxed);
+    return totals;
+}
+}
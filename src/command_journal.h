@@ -0,0 +1,45 @@
+/* command_journal.h */
+// The last commands players typed, kept for crash forensics.  The game
+// thread records each command into a fixed ring of binary records in
+// memory, which costs a copy and no I/O.  A flusher thread streams the
+// ring to a text file behind it, and a crash handler can dump the whole
+// ring without taking a lock or allocating.
+//
+// There is one writer, the game thread.  Readers never block it: a record
+// the writer laps while a reader is copying it is dropped by the reader.
+
+#ifndef COMMAND_JOURNAL_H
+#define COMMAND_JOURNAL_H
+#pragma once
+
+struct descriptor_data;
+
+namespace game_journal {
+const int JOURNAL_RECORDS = 1024;
+
+// Records a command typed on 'descriptor'.  Game thread only.
+void record(const descriptor_data* descriptor, const char* command);
+
+// Starts streaming records to 'path', which is truncated first.  Once it
+// grows past 'limit' bytes the flusher starts it again from empty, so it
+// holds the most recent commands without growing for ever.
+void start(const char* path, long limit);
+
+// Streams what is left and stops the flusher.
+void stop();
+
+// Writes every record still in the ring, oldest first, to a new file at
+// 'path'.  Uses only open() and write(), so it is safe in a signal handler.
+void dump(const char* path);
+
+struct journal_stats {
+    unsigned long recorded;
+    unsigned long streamed;
+    unsigned long dropped; // overwritten before the flusher got to them
+    unsigned long restarts; // times the file was started again from empty
+};
+
+journal_stats stats();
+}
+
+#endif /* COMMAND_JOURNAL_H */
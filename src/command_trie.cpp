@@ -0,0 +1,121 @@
+/* command_trie.cpp */
+
+#include "command_trie.h"
+
+#include "platdef.h"
+#include "structs.h"
+#include "db.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+extern const char* command[];
+extern struct social_messg* soc_mess_list;
+extern int social_list_top;
+
+int find_action_sorted(char* arg); /* in act_soci.cpp */
+
+namespace game_commands {
+namespace {
+    // A node's children are the edges from first_edge on, sorted by
+    // character.
+    struct trie_node {
+        int first_edge;
+        int edge_count;
+        verb_match match;
+    };
+
+    std::vector<trie_node> nodes;
+    std::vector<unsigned char> edge_chars;
+    std::vector<int> edge_targets;
+
+    // The trie while it is being built.
+    struct draft_node {
+        std::map<unsigned char, int> children;
+        std::string prefix;
+        int command;
+    };
+
+    // Adds the nodes 'name' needs.  Each prefix of it that has no command
+    // yet is given 'number'.
+    void insert(std::vector<draft_node>& draft, const char* name, int number)
+    {
+        int node = 0;
+        for (const char* letter = name; *letter; ++letter) {
+            std::map<unsigned char, int>::iterator child = draft[node].children.find(*letter);
+            if (child != draft[node].children.end()) {
+                node = child->second;
+            } else {
+                draft_node added;
+                added.prefix = draft[node].prefix + *letter;
+                added.command = -1;
+                draft.push_back(added);
+                draft[node].children[*letter] = int(draft.size()) - 1;
+                node = int(draft.size()) - 1;
+            }
+            if (draft[node].command < 0)
+                draft[node].command = number;
+        }
+    }
+}
+
+//============================================================================
+void build()
+{
+    std::vector<draft_node> draft(1);
+    draft[0].command = 0; // an empty verb, as old_search_block() has it
+
+    // In table order, so a prefix keeps the first command it abbreviates.
+    for (int number = 0; *command[number] != '\n'; ++number)
+        insert(draft, command[number], number + 1);
+    for (int social = 0; social <= social_list_top; ++social)
+        insert(draft, soc_mess_list[social].command, -1);
+
+    nodes.assign(draft.size(), trie_node());
+    edge_chars.clear();
+    edge_targets.clear();
+    std::vector<char> prefix;
+    for (size_t node = 0; node < draft.size(); ++node) {
+        trie_node& built = nodes[node];
+        built.first_edge = int(edge_chars.size());
+        built.edge_count = int(draft[node].children.size());
+        for (const auto& child : draft[node].children) {
+            edge_chars.push_back(child.first);
+            edge_targets.push_back(child.second);
+        }
+
+        prefix.assign(draft[node].prefix.begin(), draft[node].prefix.end());
+        prefix.push_back(0);
+        built.match.command = draft[node].command;
+        built.match.social = find_action_sorted(&prefix[0]);
+    }
+}
+
+//============================================================================
+bool is_built()
+{
+    return !nodes.empty();
+}
+
+//============================================================================
+verb_match lookup(const char* verb, int length)
+{
+    int node = 0;
+    for (int letter = 0; letter < length; ++letter) {
+        const trie_node& at = nodes[node];
+        unsigned char wanted = verb[letter];
+        const unsigned char* first = &edge_chars[0] + at.first_edge;
+        const unsigned char* last = first + at.edge_count;
+        const unsigned char* edge = first;
+        while (edge != last && *edge < wanted)
+            ++edge;
+        if (edge == last || *edge != wanted) {
+            verb_match none = { -1, -1 };
+            return none;
+        }
+        node = edge_targets[at.first_edge + (edge - first)];
+    }
+    return nodes[node].match;
+}
+}
@@ -0,0 +1,31 @@
+/* command_trie.h */
+// Resolves the verb a player typed to a command and a social in one walk
+// down a prefix trie, so that parsing costs the length of the verb however
+// many commands and socials there are.
+//
+// Every node of the trie is a prefix of some command or social name, and
+// is built knowing what the old searches answered for that prefix: the
+// first command in command[] it abbreviates, and the social find_action()'s
+// binary search settled on.  So abbreviations resolve exactly as they did.
+
+#ifndef COMMAND_TRIE_H
+#define COMMAND_TRIE_H
+#pragma once
+
+namespace game_commands {
+struct verb_match {
+    int command; // as old_search_block() on command[]: number, or -1
+    int social; // index in soc_mess_list, or -1
+};
+
+// Builds the trie from command[] and the socials.  Call after the socials
+// are booted.
+void build();
+
+bool is_built();
+
+// Resolves the first 'length' characters of 'verb'.  Only after build().
+verb_match lookup(const char* verb, int length);
+}
+
+#endif /* COMMAND_TRIE_H */
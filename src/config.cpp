@@ -77,6 +77,25 @@ char* DFLT_DIR = "lib";
 
 int nameserver_is_slow = YES;
 
+/* How many bytes of output may pile up for a client that is not reading
+   before we give up on them and close the connection.  A player scrolling
+   through a long listing over a slow modem needs well under this. */
+int max_output_queue = 256 * 1024;
+
+/* How many idle mobiles in zones without players mobile_activity() may
+   visit per pulse, or 0 for no limit.  Zones that do not fit are visited
+   on a later pulse. */
+int mobile_activity_budget = 500;
+
+/* How large the last_cmds file may grow before the command journal starts
+   it again from empty. */
+long command_journal_bytes = 1000000;
+
+/* How many compiled act() messages to keep.  Most are string constants,
+   but messages put together with sprintf() are new every time, so past
+   this many all are thrown away and compiled again as they are used. */
+int act_template_limit = 4096;
+
 char* MENU = "\n\r"
              "Welcome to Arda!\n\r"
              "0) Exit from the MUD.\n\r"
@@ -0,0 +1,194 @@
+/* crime_ledger.cpp */
+
+#include "crime_ledger.h"
+
+#include "utils.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+namespace game_crimes {
+ledger crimes;
+
+namespace {
+    // Forgotten records are only worth compacting away once there are a few.
+    const int MIN_COMPACTION = 64;
+
+    // mudlog() wants a buffer it may write to, not a literal.
+    void report(const char* message)
+    {
+        char line[MAX_INPUT_LENGTH];
+        sprintf(line, "%s", message);
+        mudlog(line, NRM, LEVEL_IMMORT, TRUE);
+    }
+}
+
+//============================================================================
+ledger::ledger()
+    : m_live(0)
+{
+}
+
+//============================================================================
+// The file keeps idnums as sh_int, so the index compares them the same way.
+unsigned long long ledger::key(int criminal, int victim, int witness)
+{
+    return ((unsigned long long)(unsigned short)criminal << 32)
+        | ((unsigned long long)(unsigned short)victim << 16)
+        | (unsigned short)witness;
+}
+
+//============================================================================
+void ledger::load(const char* filename)
+{
+    m_filename = filename;
+    m_records.clear();
+    m_forgotten.clear();
+    m_by_key.clear();
+    m_by_witness.clear();
+    m_live = 0;
+
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        log("Crime file does not exist, creating it.");
+        return;
+    }
+
+    int read = 0;
+    crime_record_type record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        ++read;
+        if (record.crime == CRIME_FORGOTTEN) {
+            std::unordered_map<unsigned long long, int>::iterator found = m_by_key.find(key(record.criminal, record.victim, record.witness));
+            if (found != m_by_key.end())
+                erase(found->second);
+        } else if (!known(record.criminal, record.victim, record.witness))
+            insert(record);
+    }
+    fclose(file);
+
+    if (read > m_live)
+        compact();
+}
+
+//============================================================================
+bool ledger::known(int criminal, int victim, int witness) const
+{
+    return m_by_key.count(key(criminal, victim, witness)) != 0;
+}
+
+//============================================================================
+bool ledger::add(const crime_record_type& record)
+{
+    if (known(record.criminal, record.victim, record.witness))
+        return false;
+
+    insert(record);
+    if (!append(record))
+        report("Could not open crime_file for writing.");
+    return true;
+}
+
+//============================================================================
+int ledger::forget(int witness, int criminal)
+{
+    std::unordered_map<int, std::vector<int>>::iterator seen = m_by_witness.find((sh_int)witness);
+    if (seen == m_by_witness.end())
+        return 0;
+
+    std::vector<int>& positions = seen->second;
+    size_t kept = 0;
+    int count = 0;
+    for (size_t at = 0; at < positions.size(); ++at) {
+        int position = positions[at];
+        if (m_forgotten[position])
+            continue;
+
+        crime_record_type& record = m_records[position];
+        if (criminal != -1 && record.criminal != (sh_int)criminal) {
+            positions[kept++] = position;
+            continue;
+        }
+
+        erase(position);
+        crime_record_type cancel = record;
+        cancel.crime = CRIME_FORGOTTEN;
+        append(cancel);
+        ++count;
+    }
+    positions.resize(kept);
+    if (positions.empty())
+        m_by_witness.erase(seen);
+
+    int forgotten = int(m_records.size()) - m_live;
+    if (forgotten >= MIN_COMPACTION && forgotten > m_live)
+        compact();
+    return count;
+}
+
+//============================================================================
+void ledger::insert(const crime_record_type& record)
+{
+    int position = int(m_records.size());
+    m_records.push_back(record);
+    m_forgotten.push_back(0);
+    m_by_key[key(record.criminal, record.victim, record.witness)] = position;
+    m_by_witness[record.witness].push_back(position);
+    ++m_live;
+}
+
+//============================================================================
+void ledger::erase(int position)
+{
+    const crime_record_type& record = m_records[position];
+    m_by_key.erase(key(record.criminal, record.victim, record.witness));
+    m_forgotten[position] = 1;
+    --m_live;
+}
+
+//============================================================================
+bool ledger::append(const crime_record_type& record)
+{
+    FILE* file = fopen(m_filename.c_str(), "ab");
+    if (!file)
+        return false;
+
+    bool written = fwrite(&record, sizeof(record), 1, file) == 1;
+    return fclose(file) == 0 && written;
+}
+
+//============================================================================
+// Drops forgotten crimes from memory and rewrites the file with the rest.
+void ledger::compact()
+{
+    std::vector<crime_record_type> live;
+    live.reserve(m_live);
+    for (size_t position = 0; position < m_records.size(); ++position)
+        if (!m_forgotten[position])
+            live.push_back(m_records[position]);
+
+    m_records.clear();
+    m_forgotten.clear();
+    m_by_key.clear();
+    m_by_witness.clear();
+    m_live = 0;
+    for (size_t position = 0; position < live.size(); ++position)
+        insert(live[position]);
+
+    std::string temp = m_filename + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        report("Could not compact the crime file.");
+        return;
+    }
+    bool written = live.empty() || fwrite(&live[0], sizeof(crime_record_type), live.size(), file) == live.size();
+    if (fclose(file) != 0 || !written || rename(temp.c_str(), m_filename.c_str()) < 0) {
+        unlink(temp.c_str());
+        report("Could not compact the crime file.");
+        return;
+    }
+
+    sprintf(buf, "Crimes rewritten:%d.", m_live);
+    log(buf);
+}
+}
@@ -0,0 +1,60 @@
+/* crime_ledger.h */
+// The crimes players have witnessed, indexed so that guards and witnesses
+// can ask about a crime in constant time however many have piled up.
+
+#ifndef CRIME_LEDGER_H
+#define CRIME_LEDGER_H
+#pragma once
+
+#include "db.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace game_crimes {
+// Crimes are kept by player idnum.  The crime file is append-only: new
+// crimes are appended as they happen, and forgetting one appends a record
+// whose crime is CRIME_FORGOTTEN.  The file is compacted when it is loaded
+// and whenever forgotten records outnumber the rest.
+class ledger {
+public:
+    ledger();
+
+    // Replays 'filename' and compacts it if that is worthwhile.
+    void load(const char* filename);
+
+    // Records a crime unless the witness already knows of it.
+    bool add(const crime_record_type& record);
+
+    bool known(int criminal, int victim, int witness) const;
+
+    // Forgets the crimes of 'criminal' that 'witness' saw, or every crime
+    // 'witness' saw if 'criminal' is -1.  Returns how many were forgotten.
+    int forget(int witness, int criminal);
+
+    int size() const { return m_live; }
+
+private:
+    static unsigned long long key(int criminal, int victim, int witness);
+
+    void insert(const crime_record_type& record);
+    void erase(int position);
+    bool append(const crime_record_type& record);
+    void compact();
+
+    std::string m_filename;
+    std::vector<crime_record_type> m_records; // in order of arrival
+    std::vector<char> m_forgotten; // per record
+    std::unordered_map<unsigned long long, int> m_by_key; // -> position of a live record
+    std::unordered_map<int, std::vector<int>> m_by_witness; // -> positions, some perhaps forgotten
+    int m_live;
+};
+
+// The crime value of a record that cancels an earlier crime in the file.
+const int CRIME_FORGOTTEN = -1;
+
+extern ledger crimes;
+}
+
+#endif /* CRIME_LEDGER_H */
@@ -3,24 +3,39 @@
 #include "platdef.h"
 #include <ctype.h>
 #include <dirent.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
+#include "area_files.h"
 #include "color.h"
+#include "combat_roster.h"
 #include "comm.h"
+#include "command_trie.h"
+#include "crime_ledger.h"
 #include "db.h"
+#include "exploit_log.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
 #include "mail.h"
 #include "mudlle.h"
+#include "name_index.h"
+#include "pathfind.h"
 #include "pkill.h"
+#include "player_index.h"
 #include "protos.h"
+#include "save_queue.h"
+#include "script.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
+#include "vnum_index.h"
+#include "world_snapshot.h"
 #include "zone.h"
 
 #include "big_brother.h"
@@ -40,10 +55,9 @@ char buf1[MAX_STRING_LENGTH];
 char buf2[MAX_STRING_LENGTH];
 char arg[MAX_STRING_LENGTH];
 
-room_data* room_data::BASE_WORLD = 0;
-int room_data::BASE_LENGTH = 0;
+room_data** room_data::PAGES = 0;
+int room_data::PAGE_COUNT = 0;
 int room_data::TOTAL_LENGTH = 0;
-room_data_extension* room_data::BASE_EXTENSION = 0;
 
 struct room_data world; // = 0;  new room_data; /* class of rooms      	*/
 int top_of_world = 0; /* ref to the top element of world	*/
@@ -74,9 +88,6 @@ int top_of_p_table = 0; /* ref to top of table		*/
 int top_of_p_file = 0; /* ref of size of p file	*/
 long top_idnum = 0; /* highest idnum in use		*/
 
-struct crime_record_type* crime_record = 0;
-FILE* crime_file = 0;
-int num_of_crimes = 0;
 
 int no_mail = 0; /* mail disabled?		*/
 int mini_mud = 0; /* mini-mud mode?		*/
@@ -128,7 +139,9 @@ int judpavailable; // 1 if JUDP is available, 0 otherwise
 
 /* local functions */
 void setup_dir(FILE* fl, int room, int dir);
+const char* world_index_filename();
 void index_boot(int mode);
+void build_vnum_index(int mode);
 void load_rooms(FILE* fl);
 void load_mobiles(FILE* mob_f);
 void load_objects(FILE* obj_f);
@@ -180,7 +193,6 @@ extern struct help_index_summary help_content[];
 extern int help_summary_length;
 
 extern long race_affect[];
-extern struct char_data* combat_list;
 
 extern universal_list* affected_list;
 extern universal_list* affected_list_pool;
@@ -295,6 +307,11 @@ void boot_db(void)
     log("Allocating the primary memory.");
     initialize_buffers();
 
+    log("Mapping world files.");
+    const char* const world_prefixes[] = { SCR_PREFIX, ZON_PREFIX, MDL_PREFIX,
+        WLD_PREFIX, MOB_PREFIX, OBJ_PREFIX, SHP_PREFIX };
+    game_boot::map_areas(world_prefixes, no_specials ? 6 : 7, world_index_filename());
+
     log("Reading news, credits, help, bground, info & motds.");
     file_to_string_alloc(NEWS_FILE, &news);
     file_to_string_alloc(CREDITS_FILE, &credits);
@@ -374,10 +391,14 @@ void boot_db(void)
     log("Loading social messages.");
     boot_social_messages();
 
+    log("Indexing commands and socials.");
+    game_commands::build();
+
     if (!no_specials) {
         log("Loading shops.");
         index_boot(DB_BOOT_SHP);
     }
+    game_boot::unmap_areas();
 
     log("   Commands.");
     assign_command_pointers();
@@ -411,6 +432,9 @@ void boot_db(void)
         reset_zone(i);
     }
 
+    log("Building zone routing table.");
+    game_path::build_routes();
+
     log("Assigning function pointers:");
 
     if (!no_specials) {
@@ -528,6 +552,7 @@ void build_directory(char* TheDir)
 
         i = read_filename_field(i + 1, tmpch, dentry->d_name);
         player_table[top_of_p_table].idnum = atoi(tmpch);
+        game_index::players.insert(top_of_p_table);
 
         i = read_filename_field(i + 1, tmpch, dentry->d_name);
         player_table[top_of_p_table].log_time = atoi(tmpch);
@@ -546,18 +571,97 @@ void build_directory(char* TheDir)
     RELEASE(tmpch);
 }
 
+/*
+ * Reads player_table back from the copy save_player_index_file() wrote at
+ * the last clean shutdown.  The copy is removed once read, so after a crash
+ * the next boot walks the player directories instead of trusting it.
+ */
+int load_player_index_file(void)
+{
+    FILE* fl;
+    char name[100], ch_file[100];
+    int level, race, idnum, complete = 0;
+    long log_time, flags;
+
+    if (!(fl = fopen(PLAYER_INDEX_FILE, "r")))
+        return 0;
+
+    while (fscanf(fl, "%99s", name) == 1) {
+        if (!strcmp(name, "$")) {
+            complete = 1;
+            break;
+        }
+        if (fscanf(fl, "%d %d %d %ld %ld %99s", &level, &race, &idnum, &log_time, &flags, ch_file) != 6)
+            break;
+
+        create_entry(name);
+        player_table[top_of_p_table].level = level;
+        player_table[top_of_p_table].race = race;
+        player_table[top_of_p_table].idnum = idnum;
+        player_table[top_of_p_table].log_time = log_time;
+        player_table[top_of_p_table].flags = flags;
+        sprintf(player_table[top_of_p_table].ch_file, "%s", ch_file);
+        game_index::players.insert(top_of_p_table);
+
+        top_idnum = MAX(top_idnum, idnum);
+    }
+    fclose(fl);
+    unlink(PLAYER_INDEX_FILE);
+
+    if (!complete) {
+        log("SYSERR: player index file is truncated, reading the player directories.");
+        for (int nr = 0; nr <= top_of_p_table; nr++)
+            RELEASE(player_table[nr].name);
+        RELEASE(player_table);
+        game_index::players.clear();
+        top_of_p_table = -1;
+        top_idnum = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/* writes player_table out for load_player_index_file() at shutdown */
+void save_player_index_file(void)
+{
+    FILE* fl;
+    int nr;
+
+    if (!(fl = fopen(PLAYER_INDEX_FILE ".tmp", "w"))) {
+        perror("save_player_index_file");
+        return;
+    }
+
+    for (nr = 0; nr <= top_of_p_table; nr++) {
+        if (!*player_table[nr].name || !*player_table[nr].ch_file)
+            continue;
+        fprintf(fl, "%s %d %d %d %ld %ld %s\n", player_table[nr].name,
+            player_table[nr].level, player_table[nr].race, player_table[nr].idnum,
+            (long)player_table[nr].log_time, player_table[nr].flags, player_table[nr].ch_file);
+    }
+    fprintf(fl, "$\n");
+
+    if (fclose(fl) || rename(PLAYER_INDEX_FILE ".tmp", PLAYER_INDEX_FILE))
+        perror("save_player_index_file");
+}
+
 void build_player_index(void)
 {
     int nr, tt;
 
     top_of_p_file = top_of_p_table = -1;
     top_idnum = 1;
+    game_index::players.clear();
 
-    build_directory("players/A-E/");
-    build_directory("players/F-J/");
-    build_directory("players/K-O/");
-    build_directory("players/P-T/");
-    build_directory("players/U-Z/");
+    if (load_player_index_file())
+        log("   Read from " PLAYER_INDEX_FILE ".");
+    else {
+        build_directory("players/A-E/");
+        build_directory("players/F-J/");
+        build_directory("players/K-O/");
+        build_directory("players/P-T/");
+        build_directory("players/U-Z/");
+    }
 
     top_of_p_file = top_of_p_table;
 
@@ -576,30 +680,97 @@ void build_player_index(void)
     }
 }
 
-/* function to count how many hash-mark delimited records exist in a file */
-int count_hash_records(FILE* fl)
+/* the index each world directory is booted from */
+const char* world_index_filename()
 {
-    char buf[120];
-    int count = 0;
+    if (mini_mud)
+        return MINDEX_FILE;
+    if (new_mud)
+        return NEWINDEX_FILE;
+    return INDEX_FILE;
+}
 
-    int tmp;
+/* the snapshot that may stand in for a table's area files, if it has one */
+const char* snapshot_filename(int mode)
+{
+    switch (mode) {
+    case DB_BOOT_MOB:
+        return MOB_SNAPSHOT_FILE;
+    case DB_BOOT_OBJ:
+        return OBJ_SNAPSHOT_FILE;
+    default:
+        return NULL;
+    }
+}
 
-    while (fgets(buf, 120, fl)) {
+/*
+ * Everything a prototype table is parsed from.  Mobiles also look up their
+ * mudlle programs and languages as they load.  The loaders live in this
+ * file, so its build stands for theirs.
+ */
+unsigned long long prototype_key(int mode, const game_boot::area_directory& areas)
+{
+    unsigned long long extra = game_boot::DIGEST_START;
 
-        for (tmp = 0; (buf[tmp] != 0) && (buf[tmp] <= ' '); tmp++)
-            ;
-        if (buf[tmp] == '#')
+    if (mode == DB_BOOT_MOB) {
+        const game_boot::area_directory& programs = game_boot::mapped_areas(MDL_PREFIX, world_index_filename());
+        for (const game_boot::area_file& program : programs.files)
+            extra = game_boot::digest_bytes(extra, &program.digest, sizeof(program.digest));
+        extra = game_boot::digest_bytes(extra, language_skills, language_number);
+    }
+    return game_boot::snapshot_key(areas, __DATE__ " " __TIME__, extra);
+}
+
+/* fills the prototype table from its snapshot; false if it must be parsed */
+int read_prototypes(int mode, unsigned long long key, int rec_count)
+{
+    int count = -1;
 
-            count++;
+    switch (mode) {
+    case DB_BOOT_MOB:
+        count = game_boot::read_mobiles(MOB_SNAPSHOT_FILE, key, mob_proto, mob_index, rec_count);
+        if (count > 0)
+            top_of_mobt = count - 1;
+        break;
+    case DB_BOOT_OBJ:
+        count = game_boot::read_objects(OBJ_SNAPSHOT_FILE, key, obj_proto, obj_index, rec_count);
+        if (count > 0)
+            top_of_objt = count - 1;
+        break;
+    }
+    if (count <= 0)
+        return FALSE;
+
+    sprintf(buf, "   %d prototypes read from %s.", count, snapshot_filename(mode));
+    log(buf);
+    return TRUE;
+}
+
+void write_prototypes(int mode, unsigned long long key)
+{
+    int written = FALSE;
+
+    switch (mode) {
+    case DB_BOOT_MOB:
+        written = game_boot::write_mobiles(MOB_SNAPSHOT_FILE, key, mob_proto, mob_index, top_of_mobt + 1);
+        break;
+    case DB_BOOT_OBJ:
+        written = game_boot::write_objects(OBJ_SNAPSHOT_FILE, key, obj_proto, obj_index, top_of_objt + 1);
+        break;
+    }
+    if (!written) {
+        sprintf(buf, "SYSERR: could not write %s", snapshot_filename(mode));
+        log(buf);
     }
-    return (count - 1);
 }
 
 void index_boot(int mode)
 {
-    char *index_filename, *prefix = NULL;
-    FILE *index, *db_file;
+    const char* index_filename;
+    char* prefix = NULL;
+    FILE* db_file;
     int rec_count = 0;
+    unsigned long long key = 0;
 
     switch (mode) {
     case DB_BOOT_WLD:
@@ -629,38 +800,28 @@ void index_boot(int mode)
         break;
     }
 
-    if (mini_mud)
-        index_filename = MINDEX_FILE;
-    else {
-        if (new_mud)
-            index_filename = NEWINDEX_FILE;
-        else
-            index_filename = INDEX_FILE;
-    }
+    index_filename = world_index_filename();
 
-    sprintf(buf2, "%s/%s", prefix, index_filename);
-
-    if (!(index = fopen(buf2, "r"))) {
-        sprintf(buf1, "Error opening index file '%s'", buf2);
+    const game_boot::area_directory& areas = game_boot::mapped_areas(prefix, index_filename);
+    if (areas.index_missing) {
+        sprintf(buf1, "Error opening index file '%s'", areas.failed_path.c_str());
+        errno = areas.error;
         perror(buf1);
         exit(1);
     }
+    if (areas.error) {
+        errno = areas.error;
+        perror(areas.failed_path.c_str());
+        exit(1);
+    }
+
     /* first, count the number of records in the file so we can malloc */
     if (mode != DB_BOOT_SHP) {
-        fscanf(index, "%s\n", buf1);
-        while (*buf1 != '$') {
-            sprintf(buf2, "%s/%s", prefix, buf1);
-            if (!(db_file = fopen(buf2, "r"))) {
-                perror(buf2);
-                exit(1);
-            } else {
-                if (mode == DB_BOOT_ZON)
-                    rec_count++;
-                else
-                    rec_count += count_hash_records(db_file);
-            }
-            fclose(db_file);
-            fscanf(index, "%s\n", buf1);
+        for (const game_boot::area_file& area : areas.files) {
+            if (mode == DB_BOOT_ZON)
+                rec_count++;
+            else
+                rec_count += area.records;
         }
         if (!rec_count) {
             log("SYSERR: boot error - 0 records counted");
@@ -695,11 +856,18 @@ void index_boot(int mode)
             break;
         }
     }
-    rewind(index);
-    fscanf(index, "%s\n", buf1);
-    while (*buf1 != '$') {
-        sprintf(buf2, "%s/%s", prefix, buf1);
-        if (!(db_file = fopen(buf2, "r"))) {
+
+    if (snapshot_filename(mode)) {
+        key = prototype_key(mode, areas);
+        if (read_prototypes(mode, key, rec_count)) {
+            build_vnum_index(mode);
+            return;
+        }
+    }
+
+    for (const game_boot::area_file& area : areas.files) {
+        strcpy(buf2, area.path.c_str());
+        if (!(db_file = game_boot::open_area(area))) {
             perror(buf2);
             exit(1);
         }
@@ -731,7 +899,50 @@ void index_boot(int mode)
 
         fclose(db_file);
         log("closed it.");
-        fscanf(index, "%s", buf1);
+    }
+
+    if (snapshot_filename(mode))
+        write_prototypes(mode, key);
+
+    build_vnum_index(mode);
+}
+
+/*
+ * Indexes the table that index_boot just loaded by virtual number.  The
+ * table is walked from the top so that, as with the old searches, the
+ * first of any duplicate numbers is the one found.
+ */
+void build_vnum_index(int mode)
+{
+    int tmp;
+
+    switch (mode) {
+    case DB_BOOT_WLD:
+        game_index::rooms.reset(top_of_world + 1);
+        for (tmp = top_of_world; tmp >= 0; tmp--)
+            if (world[tmp].number >= 0)
+                game_index::rooms.insert(world[tmp].number, tmp);
+        break;
+    case DB_BOOT_MOB:
+        game_index::mobiles.reset(top_of_mobt + 1);
+        for (tmp = top_of_mobt; tmp >= 0; tmp--)
+            game_index::mobiles.insert(mob_index[tmp].virt, tmp);
+        break;
+    case DB_BOOT_OBJ:
+        game_index::objects.reset(top_of_objt + 1);
+        for (tmp = top_of_objt; tmp >= 0; tmp--)
+            game_index::objects.insert(obj_index[tmp].virt, tmp);
+        break;
+    case DB_BOOT_SCR:
+        game_index::scripts.reset(top_of_script_table + 1);
+        for (tmp = top_of_script_table; tmp >= 0; tmp--)
+            game_index::scripts.insert(script_table[tmp].number, tmp);
+        break;
+    case DB_BOOT_MDL:
+        game_index::programs.reset(num_of_programs + 1);
+        for (tmp = num_of_programs; tmp >= 0; tmp--)
+            game_index::programs.insert(mobile_program_zone[tmp], tmp);
+        break;
     }
 }
 
@@ -793,10 +1004,12 @@ void load_rooms(FILE* fl)
             world[room_nr].funct = 0;
             world[room_nr].contents = 0;
             world[room_nr].people = 0;
+            world[room_nr].people_tail = 0;
+            world[room_nr].script_generation = 0; /* script_triggers built on demand */
             world[room_nr].light = 0; /* Zero light sources */
 
             if (world[room_nr].room_flags) {
-                CREATE1(base_af, affected_type);
+                base_af = game_memory::affect_pool.allocate();
                 base_af->type = ROOMAFF_SPELL;
                 base_af->duration = -1;
                 base_af->modifier = 0;
@@ -829,13 +1042,14 @@ void load_rooms(FILE* fl)
                     fgets(buf, 255, fl);
                     sscanf(buf, "%d %d %d %d", &tmp, &tmp2, &tmp3, &tmp4);
 
-                    CREATE1(base_af, affected_type);
+                    base_af = game_memory::affect_pool.allocate();
 
                     if (!aff_set) { /* putting the room to the affection list */
                         tmplist = pool_to_list(&affected_list, &affected_list_pool);
                         tmplist->ptr.room = &world[room_nr];
                         tmplist->number = world[room_nr].number;
                         tmplist->type = TARGET_ROOM;
+                        schedule_affect_update(tmplist);
                         aff_set = 1;
                     }
 
@@ -1081,6 +1295,7 @@ void load_scripts(FILE* fl)
             newscript->text = fread_string(fl, buf2);
         }
 
+        compile_script(&script_table[script_no]);
         script_no++;
     } // for (; ;)
     top_of_script_table = script_no - 1;
@@ -1139,7 +1354,7 @@ struct char_data* read_mobile(int nr, int type)
     } else
         i = nr;
 
-    CREATE(mob, struct char_data, 1);
+    mob = game_memory::character_pool.allocate();
 
     *mob = mob_proto[i];
 
@@ -1251,6 +1466,7 @@ struct char_data* read_mobile(int nr, int type)
     /* insert in list */
     mob->next = character_list;
     character_list = mob;
+    game_index::add_char(mob);
 
     mob_index[i].number++;
 
@@ -1459,7 +1675,7 @@ read_object(int nr, int type)
     } else
         i = nr;
 
-    CREATE(obj, struct obj_data, 1);
+    obj = game_memory::object_pool.allocate();
     *obj = obj_proto[i];
 
     /* storing closed/locked state for containers */
@@ -1470,6 +1686,7 @@ read_object(int nr, int type)
     obj->next = object_list;
     obj->obj_flags.timer = -1;
     object_list = obj;
+    game_index::add_obj(obj);
 
     obj_index[i].number++;
 
@@ -1586,6 +1803,7 @@ void load_objects(FILE* obj_f)
 
             obj_proto[i].in_room = NOWHERE;
             obj_proto[i].next_content = 0;
+            obj_proto[i].prev_content = 0;
             obj_proto[i].carried_by = 0;
             obj_proto[i].in_obj = 0;
             obj_proto[i].contains = 0;
@@ -1679,6 +1897,8 @@ int set_exit_state(struct room_data* room, int dir, int newstate)
         }
     }
     room->dir_option[dir]->exit_info = tmp2;
+    if (tmp2 != tmp)
+        game_path::doors_changed(*room);
     return 1;
 }
 
@@ -1762,13 +1982,11 @@ int load_player(char* name, struct char_file_u* char_element)
     for (tmpchar = name; *tmpchar; tmpchar++)
         *tmpchar = tolower(*tmpchar);
 
-    for (tmp = 0; tmp <= top_of_p_table; tmp++)
-        if (!str_cmp((player_table + tmp)->name, name))
-            break;
+    tmp = game_index::players.find_name(name);
 
     return_value = 0;
 
-    if (tmp > top_of_p_table) {
+    if (tmp < 0) {
         sprintf(buf, "load_player: player %s not in player_table", name);
         log(buf);
         return -1;
@@ -1776,6 +1994,7 @@ int load_player(char* name, struct char_file_u* char_element)
 
     char_element->player_index = tmp;
     sprintf(playerfname, "%s", (player_table + tmp)->ch_file);
+    game_save::wait_for(playerfname);
 
     file_to_string_alloc(playerfname, &pf);
     file_len = strlen(pf);
@@ -2219,6 +2438,7 @@ int create_entry(char* name)
     (player_table + top_of_p_table)->totalrank = PKILL_UNRANKED;
     for (i = 0; (*(player_table[top_of_p_table].name + i) = LOWER(*(name + i))); i++)
         ;
+    game_index::players.insert(top_of_p_table);
     return (top_of_p_table);
 }
 
@@ -2277,8 +2497,10 @@ void move_char_deleted(int index)
 {
     char temp[100];
 
+    game_save::wait_for((player_table + index)->ch_file);
     sprintf(temp, "mv %s players/ZZZ/%s", (player_table + index)->ch_file, (player_table + index)->name);
     system(temp);
+    game_index::players.erase(index);
     player_table[index].name[0] = 0;
     player_table[index].idnum = 0;
 }
@@ -2287,12 +2509,9 @@ void delete_character_file(struct char_data* ch)
 {
     int tmp;
 
-    for (tmp = 0; tmp <= top_of_p_table; tmp++) {
-        if (!str_cmp((player_table + tmp)->name, ch->player.name))
-            break;
-    }
+    tmp = game_index::players.find_name(ch->player.name);
 
-    if (tmp > top_of_p_table) {
+    if (tmp < 0) {
         send_to_char("Bug: you are not in the character list: cannot delete.\n", ch);
         sprintf(buf, "delete_character_file: could not find player: cannot delete: %s\n", ch->player.name);
         log(buf);
@@ -2314,6 +2533,7 @@ void save_player(struct char_data* ch, int load_room, int index_pos)
     char temp[255];
     char* tmpchar;
     char playerfname[100];
+    game_save::save_buffer save;
     FILE* pf = NULL;
     struct char_file_u chd;
     int tmp;
@@ -2364,7 +2584,10 @@ void save_player(struct char_data* ch, int load_room, int index_pos)
         break;
     }
 
-    pf = fopen("players/temp", "w");
+    if (!(pf = save.file())) {
+        perror("save_player");
+        return;
+    }
     char_to_store(ch, &chd);
     strcpy(chd.pwd, ch->desc->pwd);
     strncpy(chd.host, ch->desc->host, HOST_LEN);
@@ -2473,17 +2696,15 @@ void save_player(struct char_data* ch, int load_room, int index_pos)
         fprintf(pf, "prof_exp    %d %ld\n", tmp, chd.profs.prof_exp[tmp]);
 
     fprintf(pf, "end\n");
-    fclose(pf);
-    sprintf(temp, "rm %s.*", playerfname);
-    system(temp);
+    sprintf(temp, "%s.*", playerfname);
     sprintf(playerfname, "%s.%d.%d.%d.%ld.%ld", playerfname,
         (player_table + index_pos)->level,
         (player_table + index_pos)->race,
         (player_table + index_pos)->idnum,
         (long)(player_table + index_pos)->log_time,
         (player_table + index_pos)->flags);
-    sprintf(temp, "cp players/temp %s", playerfname);
-    system(temp);
+    /* the new file replaces every older one of this player's */
+    save.commit(playerfname, temp);
     sprintf((player_table + index_pos)->ch_file, "%s", playerfname);
 }
 
@@ -2511,11 +2732,9 @@ void save_char(struct char_data* ch, int load_room, int notify_char)
     }
 
     /* whois update block */
-    for (tmp = 0; tmp <= top_of_p_table; tmp++)
-        if (!str_cmp((player_table + tmp)->name, ch->player.name))
-            break;
+    tmp = game_index::players.find_name(ch->player.name);
 
-    if (tmp > top_of_p_table) {
+    if (tmp < 0) {
         send_to_char("Error: you are not being saved.  Please contact an immortal.\n\r", ch);
         sprintf(buf, "save_char: could not find player %s: Not saving.\n", ch->player.name);
         log(buf);
@@ -2524,7 +2743,11 @@ void save_char(struct char_data* ch, int load_room, int notify_char)
 
     (player_table + tmp)->log_time = time(0);
     (player_table + tmp)->level = ch->player.level;
-    (player_table + tmp)->idnum = ch->specials2.idnum;
+    if ((player_table + tmp)->idnum != ch->specials2.idnum) {
+        game_index::players.erase(tmp);
+        (player_table + tmp)->idnum = ch->specials2.idnum;
+        game_index::players.insert(tmp);
+    }
     (player_table + tmp)->flags = PLR_FLAGS(ch);
     (player_table + tmp)->race = ch->player.race;
 
@@ -2690,7 +2913,7 @@ void free_char(struct char_data* ch)
     ch->extra_specialization_data.reset();
     ch->damage_details.reset();
     remove_char_exists(ch->abs_number);
-    RELEASE(ch);
+    game_memory::character_pool.release(ch);
 }
 
 /* release memory allocated for an obj struct */
@@ -2729,7 +2952,7 @@ void free_obj(struct obj_data* obj)
        }
    } */
 
-    RELEASE(obj);
+    game_memory::object_pool.release(obj);
 }
 
 /* read contets of a text file, alloc space, point buf to it */
@@ -2845,14 +3068,17 @@ void reset_char(struct char_data* ch)
 
     for (i = 0; i < MAX_WEAR; i++) /* Initialisering */
         ch->equipment[i] = 0;
+    ch->light = 0;
+    memset(&ch->gear_affects, 0, sizeof(ch->gear_affects));
 
     ch->followers = 0;
     ch->master = 0;
     ch->next_die = 0;
     ch->carrying = 0;
     ch->next = 0;
-    ch->next_fighting = 0;
+    ch->combat_slot = 0;
     ch->next_in_room = 0;
+    ch->prev_in_room = 0;
     ch->specials.fighting = 0;
     ch->specials.position = POSITION_STANDING;
     ch->specials.default_pos = POSITION_STANDING;
@@ -2977,95 +3203,33 @@ void init_char(struct char_data* ch)
 /* returns the real number of the room with given virt number */
 int real_room(int virt)
 {
-    int bot, top, mid;
-
-    bot = 0;
-    top = top_of_world;
+    int rnum;
 
-    /* perform binary search on world-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        //      if ((world + mid)->number == virt)
-        if (world[mid].number == virt)
-            return (mid);
-        if (bot >= top) {
-            if (!mini_mud && !new_mud && virt)
-                fprintf(stderr, "Room %d does not exist in database\n", virt);
-            return (-1);
-        }
-        //      if ((world + mid)->number > virt)
-        if (world[mid].number > virt)
-            top = mid - 1;
-        else
-            bot = mid + 1;
-    }
+    rnum = game_index::rooms.find(virt);
+    if (rnum < 0 && !mini_mud && !new_mud && virt)
+        fprintf(stderr, "Room %d does not exist in database\n", virt);
+    return (rnum);
 }
 
 /* returns the real number of the monster with given virt number */
 int real_mobile(int virt)
 {
-    int bot, top, mid;
-    bot = 0;
-    top = top_of_mobt;
-
-    /* perform binary search on mob-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((mob_index + mid)->virt == virt) {
-            return (mid);
-        }
-        if (bot >= top) {
-            return (-1);
-        }
-        if ((mob_index + mid)->virt > virt) {
-            top = mid - 1;
-        } else {
-            bot = mid + 1;
-        }
-    }
+    return game_index::mobiles.find(virt);
 }
 
 /* returns the real number of the object with given virt number */
 int real_object(int virt)
 {
-    int bot, top, mid;
-
-    bot = 0;
-    top = top_of_objt;
-
-    /* perform binary search on obj-table */
-    for (;;) {
-        mid = (bot + top) / 2;
-
-        if ((obj_index + mid)->virt == virt) {
-            return (mid);
-        }
-        if (bot >= top) {
-            return (-1);
-        }
-        if ((obj_index + mid)->virt > virt) {
-            top = mid - 1;
-        } else {
-            bot = mid + 1;
-        }
-    }
+    return game_index::objects.find(virt);
 }
 
 int real_program(int virt)
 {
-    int tmp = 0;
-
-    for (tmp = 0; tmp <= num_of_programs; tmp++) {
-        if (mobile_program_zone[tmp] == virt) {
-            break;
-        }
-    }
+    int tmp;
 
-    if (tmp == num_of_programs + 1) {
+    tmp = game_index::programs.find(virt);
+    if (tmp < 0)
         return 0;
-    }
 
     return tmp;
 }
@@ -3115,13 +3279,9 @@ void boot_mudlle()
 //*************************** Crime functions *****************************
 //*************************************************************************
 
-int know_of_crime(int criminal, int victim, int witness);
-// void forget_crimes(char_data *ch, int criminal);
-void read_crime_file();
-
 void boot_crimes()
 {
-    read_crime_file();
+    game_crimes::crimes.load(CRIME_FILE);
 }
 
 void record_crime(char_data* criminal, char_data* victim, int crime, int wit_type)
@@ -3139,135 +3299,36 @@ void record_crime(char_data* criminal, char_data* victim, int crime, int wit_typ
     return;
 }
 
-void read_crime_file()
-{
-    crime_record_type tmprecord;
-    int tmp, count;
-
-    num_of_crimes = 0;
-    if (!(crime_file = fopen(CRIME_FILE, "rb"))) {
-        log("Crime file does not exist, creating it.");
-        num_of_crimes = 0;
-        crime_file = 0;
-        CREATE1(crime_record, crime_record_type);
-    } else {
-        while (!feof(crime_file)) {
-            if (fread(&tmprecord, sizeof(crime_record_type), 1, crime_file))
-                num_of_crimes++;
-        }
-        CREATE(crime_record, crime_record_type, num_of_crimes);
-        fseek(crime_file, 0, SEEK_SET);
-        tmp = 0;
-        while (!feof(crime_file) && (tmp < num_of_crimes)) {
-            fread(crime_record + tmp, sizeof(crime_record_type), 1, crime_file);
-            tmp++;
-        }
-        fclose(crime_file);
-        crime_file = 0;
-    }
-    for (tmp = 0, count = 0; tmp < num_of_crimes; tmp++) {
-        crime_record[tmp].criminal = find_player_in_table("", crime_record[tmp].criminal);
-        crime_record[tmp].victim = find_player_in_table("", crime_record[tmp].victim);
-        crime_record[tmp].witness = find_player_in_table("", crime_record[tmp].witness);
-    }
-}
-
 void add_crime(int criminal, int victim, int witness, int crime, int wit_type)
 {
-    int time_kill;
-    crime_record_type* tmprecord;
+    crime_record_type record;
+
+    record.crime_time = time(0);
+    record.criminal = criminal;
+    record.victim = victim;
+    record.witness = witness;
+    record.crime = crime;
+    record.witness_type = wit_type;
 
-    if (know_of_crime(find_player_in_table("", criminal), find_player_in_table("", victim),
-            find_player_in_table("", witness)))
+    if (!game_crimes::crimes.add(record))
         return;
-    CREATE(tmprecord, crime_record_type, num_of_crimes + 1);
-    memcpy(tmprecord, crime_record, num_of_crimes * sizeof(crime_record_type));
-    RELEASE(crime_record);
-    crime_record = tmprecord;
-
-    time_kill = time(0);
-    crime_record[num_of_crimes].crime_time = time_kill;
-    crime_record[num_of_crimes].criminal = criminal;
-    crime_record[num_of_crimes].victim = victim;
-    crime_record[num_of_crimes].witness = witness;
-    crime_record[num_of_crimes].crime = crime;
-    crime_record[num_of_crimes].witness_type = wit_type;
 
     sprintf(buf, "criminal: %d, victim: %d, witness: %d", criminal, victim, witness);
     log(buf);
-
-    crime_file = fopen(CRIME_FILE, "ab");
-
-    if (crime_file) {
-        fwrite(crime_record + num_of_crimes, sizeof(crime_record_type), 1, crime_file);
-        fclose(crime_file);
-    } else
-        mudlog("Could not open crime_file for writing.", NRM, LEVEL_IMMORT, TRUE);
-
-    crime_record[num_of_crimes].criminal = find_player_in_table("", criminal);
-    crime_record[num_of_crimes].victim = find_player_in_table("", victim);
-    crime_record[num_of_crimes].witness = find_player_in_table("", witness);
-
-    num_of_crimes++;
 }
 
 int know_of_crime(int criminal, int victim, int witness)
 {
-    int tmp;
-
-    for (tmp = 0; tmp < num_of_crimes; tmp++)
-        if ((criminal == crime_record[tmp].criminal) && (victim == crime_record[tmp].victim) && (witness == crime_record[tmp].witness))
-            return 1;
-    return 0;
+    return game_crimes::crimes.known(criminal, victim, witness);
 }
 
 void forget_crimes(char_data* ch, int criminal)
 {
-    crime_record_type* tmprecord;
-    int tmp, count, not_write;
-
     if (IS_NPC(ch) || !RACE_GOOD(ch))
         return;
-    count = 0;
-    if (criminal == -1) // -1 is forget all crimes witnessed
-        for (tmp = 0; tmp < num_of_crimes; tmp++)
-            if (crime_record[tmp].witness == find_player_in_table("", ch->specials2.idnum))
-                count = 1;
-    if (!(criminal == -1))
-        for (tmp = 0; tmp < num_of_crimes; tmp++)
-            if ((crime_record[tmp].witness == find_player_in_table("", ch->specials2.idnum)) && (crime_record[tmp].criminal == find_player_in_table("", criminal)))
-                count = 1;
-    if (!count)
-        return;
 
-    crime_file = fopen(CRIME_FILE, "wb");
-    if (!crime_file)
-        return;
-    CREATE1(tmprecord, crime_record_type);
-    count = 0;
-
-    for (tmp = 0; tmp < num_of_crimes; tmp++) {
-        if (criminal == -1) // -1 is forget all - player has died etc
-            not_write = !(crime_record[tmp].witness == find_player_in_table("", ch->specials2.idnum));
-        else
-            not_write = !((crime_record[tmp].witness == find_player_in_table("", ch->specials2.idnum)) && (crime_record[tmp].criminal == find_player_in_table("", criminal)));
-        if (not_write) {
-            tmprecord[0].crime_time = crime_record[tmp].crime_time;
-            tmprecord[0].criminal = (player_table + crime_record[tmp].criminal)->idnum;
-            tmprecord[0].victim = (player_table + crime_record[tmp].victim)->idnum;
-            tmprecord[0].witness = (player_table + crime_record[tmp].witness)->idnum;
-            tmprecord[0].crime = crime_record[tmp].crime;
-            tmprecord[0].witness_type = crime_record[tmp].witness_type;
-            fwrite(tmprecord, sizeof(crime_record_type), 1, crime_file);
-            count++;
-        }
-    }
-    fclose(crime_file);
-    sprintf(buf, "Crimes rewritten:%d.", count);
-    log(buf);
-    RELEASE(tmprecord);
-    RELEASE(crime_record);
-    read_crime_file();
+    // -1 is forget all crimes witnessed - player has died etc
+    game_crimes::crimes.forget(ch->specials2.idnum, criminal);
 }
 
 //*************************************************************************
@@ -3292,6 +3353,8 @@ void dummy_room_data(room_data* room)
     room->ex_description = 0;
     room->contents = 0;
     room->people = 0;
+    room->people_tail = 0;
+    room->script_generation = 0;
 
     for (tmp = 0; tmp < NUM_OF_DIRS; tmp++) {
         room->dir_option[tmp] = 0;
@@ -3302,21 +3365,6 @@ void dummy_room_data(room_data* room)
     room->room_flags = 0;
     room->light = 0;
 }
-room_data_extension::room_data_extension()
-{
-    int tmp;
-    CREATE(extension_world, room_data, EXTENSION_SIZE);
-    for (tmp = 0; tmp < EXTENSION_SIZE; tmp++)
-        dummy_room_data(extension_world + tmp);
-    extension_next = 0;
-}
-room_data_extension::~room_data_extension()
-{
-    if (extension_next)
-        delete extension_next;
-    RELEASE(extension_world);
-}
-
 void room_data::create_exit(int dir, int room, char connect)
 {
     int this_room;
@@ -3344,6 +3392,7 @@ void room_data::create_exit(int dir, int room, char connect)
     }
     dir_option[dir]->to_room = real_room(world[room].number);
     //  printf("exit to room %d, %d\n",dir_option[dir]->to_room,world[room].number);
+    game_path::exits_changed();
     if (connect && (room != this_room))
         world[room].create_exit(rev_dir[dir], this_room, FALSE);
     //  printf("create exift returns\n");
@@ -3353,61 +3402,51 @@ int room_data::create_room(int zone)
 {
     // here adding a room, returns the real number of the room
 
-    int place;
-    room_data_extension* ext;
+    int place, tmp;
     room_data* new_room;
-    // checking the base first
-
-    new_room = 0;
-
-    // sprintf(mybuf,"create room, base, total %d %d",BASE_LENGTH, TOTAL_LENGTH);
-    //  log(mybuf);
 
+    // reuse a free slot if there is one, otherwise add some at the end
     for (place = 0; place < TOTAL_LENGTH; place++) {
-        //    printf("create_room, checking %d: %d\n",place,(BASE_WORLD+place)->number);
         if (world[place].number < 0)
             break;
     }
 
     if (place >= TOTAL_LENGTH) {
-        //    printf("could not create room\n");
-        //    exit(0);  // temporary passage
-
-        place = TOTAL_LENGTH;
-        if (!BASE_EXTENSION) {
-            BASE_EXTENSION = new room_data_extension;
-            TOTAL_LENGTH += EXTENSION_SIZE;
-            //      sprintf(mybuf,"created first, total=%d",TOTAL_LENGTH);
-            //      log(mybuf);
-            // printf(" numbersm %d %d\n",world[place].number, world[place+1].number);
-            new_room = BASE_EXTENSION->extension_world;
-        } else {
-            for (ext = BASE_EXTENSION; ext->extension_next; ext = ext->extension_next)
-                ;
-
-            ext->extension_next = new room_data_extension;
-            //      sprintf(mybuf,"created next, total=%d",TOTAL_LENGTH);
-            //      log(mybuf);
-            new_room = ext->extension_next->extension_world;
-            TOTAL_LENGTH += EXTENSION_SIZE;
-        }
-    } else
-        new_room = &world[place];
+        grow(EXTENSION_SIZE);
+        for (tmp = place; tmp < TOTAL_LENGTH; tmp++)
+            dummy_room_data(&world[tmp]);
+    }
 
+    new_room = &world[place];
     dummy_room_data(new_room);
     if (place == 0)
         new_room->number = 0;
     else
         new_room->number = world[place - 1].number + 1;
 
-    //  sprintf(mybuf,"created %d, %d",place, new_room->number);
-    //  log(mybuf);
-
     new_room->zone = zone;
     top_of_world++;
+    game_index::rooms.insert(new_room->number, place);
+    game_path::exits_changed();
     return place;
 }
 
+//************************************************************************
+void room_data::grow(int amount)
+{
+    int needed, tmp;
+
+    needed = (TOTAL_LENGTH + amount + ROOM_PAGE_SIZE - 1) >> ROOM_PAGE_SHIFT;
+    if (needed > PAGE_COUNT) {
+        RECREATE(PAGES, room_data*, needed, PAGE_COUNT);
+        for (tmp = PAGE_COUNT; tmp < needed; tmp++)
+            PAGES[tmp] = new room_data[ROOM_PAGE_SIZE];
+        PAGE_COUNT = needed;
+    }
+
+    TOTAL_LENGTH += amount;
+}
+
 /*
  * This function's only called once, after all rooms in the
  * database have been counted.  It allocates as many rooms as
@@ -3417,42 +3456,36 @@ void room_data::create_bulk(int amount)
 {
     int tmp;
 
-    if (BASE_WORLD != 0) {
+    if (PAGES != 0) {
         printf("Double allocation for room_data!\n");
         exit(0);
     }
 
-    // BASE_WORLD = (room_data *)calloc(sizeof(room_data), amount + EXTENSION_SIZE);
-    BASE_WORLD = new room_data[amount + EXTENSION_SIZE];
-    if (!BASE_WORLD) {
-        printf("Could not allocate %d rooms for room_data\n", amount);
-        exit(0);
-    }
-    BASE_LENGTH = amount + EXTENSION_SIZE - 1;
-    TOTAL_LENGTH = amount + EXTENSION_SIZE - 1;
-
-    for (tmp = 0; tmp < EXTENSION_SIZE; tmp++)
-        dummy_room_data(BASE_WORLD + amount - 1 + tmp);
+    // the loaded rooms, then the dummy EXTENSION_ROOM_HEAD room, then
+    // free slots for OLC; remember that top_of_world is increased due to
+    // the dummy room in load_rooms
+    grow(amount + EXTENSION_SIZE - 1);
+    for (tmp = amount - 1; tmp < TOTAL_LENGTH; tmp++)
+        dummy_room_data(&world[tmp]);
 
-    (BASE_WORLD + amount - 1)->number = EXTENSION_ROOM_HEAD;
-
-    // remember that top_of_world is increased due to this in load_rooms
-    BASE_EXTENSION = 0;
+    world[amount - 1].number = EXTENSION_ROOM_HEAD;
 }
 //**********************************************************************
 void room_data::delete_room()
 {
+    int tmp;
+
     printf("room_data desctructor was called.\n");
-    if (BASE_EXTENSION)
-        delete BASE_EXTENSION;
+    for (tmp = 0; tmp < PAGE_COUNT; tmp++)
+        delete[] PAGES[tmp];
+    RELEASE(PAGES);
+    PAGE_COUNT = 0;
+    TOTAL_LENGTH = 0;
 }
 
-room_data& room_data::operator[](int i)
+room_data& room_data::out_of_range(int i)
 {
-    int offset;
-    room_data_extension* ext;
-
-    if (!BASE_WORLD) {
+    if (!PAGES) {
         printf("room_data called, but not allocated\n");
         exit(0);
     }
@@ -3460,132 +3493,24 @@ room_data& room_data::operator[](int i)
     if (i < 0) {
         mudlog("world[] called for negative room number.", NRM, LEVEL_GOD, TRUE);
         //    send_to_all("****world[] called for negative room number.****");
-        return *(BASE_WORLD);
-    }
-
-    if (i >= BASE_LENGTH) {
-        offset = i - BASE_LENGTH;
-        //    printf("[] extra, offset=%d\n",offset);
-        ext = BASE_EXTENSION;
-        while (ext && (offset >= EXTENSION_SIZE)) {
-            ext = ext->extension_next;
-            offset -= EXTENSION_SIZE;
-        }
-        if (!ext) {
-            sprintf(buf, "room_data called for a room outside the world, %d\n", i);
-            mudlog(buf, NRM, LEVEL_GRGOD, TRUE);
-            if (i == r_immort_start_room)
-                exit(0);
-            else
-                return world[r_immort_start_room];
-        }
-        //    printf("return, offse=%d\n",offset);
-        return *(ext->extension_world + offset);
+        return *PAGES[0];
     }
 
-    return *(BASE_WORLD + i);
+    sprintf(buf, "room_data called for a room outside the world, %d\n", i);
+    mudlog(buf, NRM, LEVEL_GRGOD, TRUE);
+    if (i == r_immort_start_room)
+        exit(0);
+    return world[r_immort_start_room];
 }
 
 void write_exploits(char_data* ch, exploit_record* record)
 {
-    char tempfname[255];
-    FILE* exploit_file = NULL;
-    FILE* exploit_player_file = NULL;
-    exploit_record temprec;
-    char playerfname[100];
-    char temp[255];
-    char name[255];
-    char* tmpchar;
-    // Open a temp file for this record
-    sprintf(tempfname, "%s", "exploits/tempfile");
-    exploit_file = fopen(tempfname, "w");
-    if (exploit_file != NULL) {
-        fwrite(record, sizeof(struct exploit_record), 1, exploit_file);
-    } else {
-        mudlog("**ERROR: Could not open temp exploit file for writing.", NRM, LEVEL_IMMORT, TRUE);
-        return;
-    }
-    strcpy(name, GET_NAME(ch));
-    for (tmpchar = name; *tmpchar; tmpchar++)
-        *tmpchar = tolower(*tmpchar);
-
-    // determine name of player's main trophy file
-    switch (tolower(*name)) {
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-        sprintf(playerfname, "exploits/A-E/%s.exploits", name);
-        break;
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-        sprintf(playerfname, "exploits/F-J/%s.exploits", name);
-        break;
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-        sprintf(playerfname, "exploits/K-O/%s.exploits", name);
-        break;
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-        sprintf(playerfname, "exploits/P-T/%s.exploits", name);
-        break;
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-        sprintf(playerfname, "exploits/U-Z/%s.exploits", name);
-        break;
-    default:
-        sprintf(playerfname, "exploits/ZZZ/%s.exploits", name);
-        break;
-    } // switch
-
-    // open this chars main exploit file
-    exploit_player_file = fopen(playerfname, "r");
-
-    // if this is their first kill, ok, a file will be created.
-    if (exploit_player_file == NULL) {
-        mudlog("Could not open exploit file for character: creating new one", NRM, LEVEL_IMMORT, TRUE);
-    } else {
-
-        // concat all of the previous entries for this char to end of this file
-        // this is to ensure newest entries are at top of file
-
-        for (;;) {
-            // read an entry from player file
-            fread(&temprec, sizeof(struct exploit_record), 1, exploit_player_file);
-            if (feof(exploit_player_file))
-                break;
-            // write the entry to temp file
-            fwrite(&temprec, sizeof(exploit_record), 1, exploit_file);
-        }
-        fclose(exploit_player_file);
-    } // more than one entry
-
-    // close the temp file. this temp file contains entire trophy
-    fclose(exploit_file);
-
-    // mv the temp file to the new one
-    sprintf(temp, "cp %s %s", tempfname, playerfname);
-    system(temp);
-    return;
+    if (!game_exploits::append(GET_NAME(ch), *record))
+        mudlog("**ERROR: Could not append to exploit file.", NRM, LEVEL_IMMORT, TRUE);
 }
 
 void add_exploit_record(int recordtype, char_data* victim, int iIntParam, char* chParam)
 {
-    struct char_data* killer;
     struct exploit_record exploitrec;
     int iFirstDeath = 0;
     long ct;
@@ -3604,7 +3529,7 @@ void add_exploit_record(int recordtype, char_data* victim, int iIntParam, char*
     switch (recordtype) {
     case EXPLOIT_PK: {
         std::set<char_data*> seen_chars;
-        for (killer = combat_list; killer; killer = killer->next_fighting) {
+        for (char_data* killer : combat_list) {
             if (killer->specials.fighting == victim) {
                 char_data* cur_killer = killer;
                 if (IS_NPC(killer)) {
@@ -3633,7 +3558,7 @@ void add_exploit_record(int recordtype, char_data* victim, int iIntParam, char*
 
     case EXPLOIT_DEATH: {
         std::set<char_data*> seen_chars;
-        for (killer = combat_list; killer; killer = killer->next_fighting) {
+        for (char_data* killer : combat_list) {
             if (killer->specials.fighting == victim) {
                 char_data* cur_killer = killer;
                 if (IS_NPC(killer)) {
@@ -3724,7 +3649,7 @@ void add_exploit_record(int recordtype, char_data* victim, int iIntParam, char*
 
 int delete_exploits_file(char* name)
 {
-    char filename[70];
+    char filename[100];
     char tname[60];
     char* tmpchar;
     char temp[100];
@@ -3732,47 +3657,7 @@ int delete_exploits_file(char* name)
     for (tmpchar = tname; *tmpchar; tmpchar++)
         *tmpchar = tolower(*tmpchar);
 
-    switch (tolower(*tname)) {
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-        sprintf(filename, "exploits/A-E/%s.exploits", tname);
-        break;
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-        sprintf(filename, "exploits/F-J/%s.exploits", tname);
-        break;
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-        sprintf(filename, "exploits/K-O/%s.exploits", tname);
-        break;
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-        sprintf(filename, "exploits/P-T/%s.exploits", tname);
-        break;
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-        sprintf(filename, "exploits/U-Z/%s.exploits", tname);
-        break;
-    default:
-        sprintf(filename, "exploits/ZZZ/%s.exploits", tname);
-        break;
-    }
+    game_exploits::log_filename(tname, filename);
     sprintf(temp, "Deleting trophy file: %s", tname);
     mudlog(temp, NRM, LEVEL_IMMORT, TRUE);
 
@@ -3801,6 +3686,7 @@ int rename_char(struct char_data* ch, char* newname)
     add_exploit_record(EXPLOIT_ACHIEVEMENT, ch, 0, namebuf);
 
     /* remove their char file */
+    game_save::flush();
     sprintf(namebuf, "rm %s", buf);
     system(namebuf);
 
@@ -3830,6 +3716,7 @@ int rename_char(struct char_data* ch, char* newname)
 
     /* release the buffers in the player table and in their personal
      * char_data structure */
+    game_index::players.erase(player_i);
     RELEASE(player_table[player_i].name);
     RELEASE(ch->player.name);
 
@@ -3843,9 +3730,11 @@ int rename_char(struct char_data* ch, char* newname)
     /* assign and terminate */
     strncpy(player_table[player_i].name, newname, i);
     player_table[player_i].name[i] = 0;
+    game_index::players.insert(player_i);
 
     strncpy(ch->player.name, newname, i);
     ch->player.name[i] = 0;
+    game_index::rename_char(ch);
 
     return 1;
 }
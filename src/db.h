@@ -71,6 +71,9 @@
 #define MUDLLE_OLDFILE "misc/mudlle.old" /* backup from shaping        */
 #define PKILL_FILE "misc/pklist" /*the list of player killings   */
 #define CRIME_FILE "misc/crimelist" /*the list of player crimes	*/
+#define PLAYER_INDEX_FILE "misc/player_index" /* player_table as of the last shutdown */
+#define MOB_SNAPSHOT_FILE "misc/mob_snapshot" /* mob_proto as last parsed */
+#define OBJ_SNAPSHOT_FILE "misc/obj_snapshot" /* obj_proto as last parsed */
 
 // exploit types
 #define EXPLOIT_PK 1
@@ -125,6 +128,7 @@ void forget_crimes(struct char_data*, int);
 void add_exploit_record(int, struct char_data*, int, char*);
 int delete_exploits_file(char*);
 void delete_character_file(struct char_data*);
+void save_player_index_file(void);
 void move_char_deleted(int);
 int get_char_directory(char*, char*);
 int load_player(char*, struct char_file_u*);
@@ -0,0 +1,195 @@
+/* exploit_log.cpp */
+
+#include "exploit_log.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace game_exploits {
+namespace {
+    // The header's type; no real exploit type comes near it.
+    const int LOG_MAGIC = 0x676f6c78;
+    const int LOG_VERSION = 1;
+
+    exploit_record make_header()
+    {
+        exploit_record header;
+        memset(&header, 0, sizeof(header));
+        header.type = LOG_MAGIC;
+        header.iIntParam = LOG_VERSION;
+        return header;
+    }
+
+    //========================================================================
+    // Rewrites a newest-first file from before the log as a log.
+    bool convert(const char* filename)
+    {
+        FILE* old_file = fopen(filename, "rb");
+        if (!old_file)
+            return false;
+
+        std::vector<exploit_record> records;
+        exploit_record record;
+        while (fread(&record, sizeof(record), 1, old_file) == 1)
+            records.push_back(record);
+        fclose(old_file);
+        std::reverse(records.begin(), records.end());
+
+        std::string temp = std::string(filename) + ".tmp";
+        FILE* log = fopen(temp.c_str(), "wb");
+        if (!log)
+            return false;
+
+        exploit_record header = make_header();
+        bool written = fwrite(&header, sizeof(header), 1, log) == 1;
+        if (!records.empty())
+            written = written && fwrite(&records[0], sizeof(exploit_record), records.size(), log) == records.size();
+        if (fclose(log) != 0 || !written || rename(temp.c_str(), filename) < 0) {
+            unlink(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+//============================================================================
+void log_filename(const char* name, char* filename)
+{
+    std::string lowered(name);
+    for (size_t at = 0; at < lowered.size(); ++at)
+        lowered[at] = tolower(lowered[at]);
+
+    const char* directory;
+    char first = lowered.empty() ? 0 : lowered[0];
+    if (first >= 'a' && first <= 'e')
+        directory = "A-E";
+    else if (first >= 'f' && first <= 'j')
+        directory = "F-J";
+    else if (first >= 'k' && first <= 'o')
+        directory = "K-O";
+    else if (first >= 'p' && first <= 't')
+        directory = "P-T";
+    else if (first >= 'u' && first <= 'z')
+        directory = "U-Z";
+    else
+        directory = "ZZZ";
+
+    sprintf(filename, "exploits/%s/%s.exploits", directory, lowered.c_str());
+}
+
+//============================================================================
+bool append(const char* name, const exploit_record& record)
+{
+    char filename[100];
+    log_filename(name, filename);
+
+    FILE* log = fopen(filename, "a+b");
+    if (!log)
+        return false;
+
+    exploit_record first;
+    bool empty = fread(&first, sizeof(first), 1, log) != 1;
+    if (!empty && first.type != LOG_MAGIC) {
+        fclose(log);
+        if (!convert(filename) || !(log = fopen(filename, "a+b")))
+            return false;
+    }
+
+    // Drop the tail of a record cut short by a crash, so that every record
+    // stays at its computed offset.
+    fseek(log, 0, SEEK_END);
+    long length = ftell(log);
+    if (length % sizeof(exploit_record)) {
+        length -= length % sizeof(exploit_record);
+        fflush(log);
+        if (ftruncate(fileno(log), length) < 0) {
+            fclose(log);
+            return false;
+        }
+        fseek(log, 0, SEEK_END);
+    }
+
+    bool written = true;
+    if (empty || length == 0) {
+        exploit_record header = make_header();
+        written = fwrite(&header, sizeof(header), 1, log) == 1;
+    }
+    written = written && fwrite(&record, sizeof(record), 1, log) == 1;
+    return fclose(log) == 0 && written;
+}
+
+//============================================================================
+reader::reader(const char* name)
+    : m_oldest_first(false)
+    , m_unread(0)
+    , m_count(0)
+    , m_chunk_left(0)
+{
+    char filename[100];
+    log_filename(name, filename);
+    if (!(m_file = fopen(filename, "rb")))
+        return;
+
+    fseek(m_file, 0, SEEK_END);
+    m_count = ftell(m_file) / long(sizeof(exploit_record));
+
+    exploit_record first;
+    fseek(m_file, 0, SEEK_SET);
+    if (m_count > 0 && fread(&first, sizeof(first), 1, m_file) == 1 && first.type == LOG_MAGIC) {
+        m_oldest_first = true;
+        --m_count;
+    }
+    m_unread = m_count;
+}
+
+//============================================================================
+reader::~reader()
+{
+    if (m_file)
+        fclose(m_file);
+}
+
+//============================================================================
+// Reads the next CHUNK records into m_chunk so that the newest of them is
+// last, ready to be handed out from the back.
+bool reader::fill()
+{
+    if (!m_file || m_unread == 0)
+        return false;
+
+    long wanted = std::min(long(CHUNK), m_unread);
+    long record;
+    if (m_oldest_first)
+        record = m_unread - wanted + 1; // +1 for the header
+    else
+        record = m_count - m_unread;
+
+    if (fseek(m_file, record * long(sizeof(exploit_record)), SEEK_SET) < 0)
+        return false;
+    long got = long(fread(m_chunk, sizeof(exploit_record), wanted, m_file));
+    if (got < wanted) {
+        m_unread = 0;
+        return false;
+    }
+
+    if (!m_oldest_first)
+        std::reverse(m_chunk, m_chunk + got);
+    m_unread -= got;
+    m_chunk_left = int(got);
+    return true;
+}
+
+//============================================================================
+bool reader::next(exploit_record& record)
+{
+    if (m_chunk_left == 0 && !fill())
+        return false;
+
+    record = m_chunk[--m_chunk_left];
+    return true;
+}
+}
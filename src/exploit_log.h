@@ -0,0 +1,56 @@
+/* exploit_log.h */
+// Each player's exploits file is an append-only log: a header record, then
+// exploit_records oldest first.  Recording an exploit appends one record, and
+// readers walk the log backwards so that the newest exploits still come
+// first.  Records have a fixed size, so record n always sits at
+//   sizeof(exploit_record) * (n + 1)
+// and a reader needs no index beyond the file's length.
+//
+// Files written before the log are newest first with no header.  Readers
+// accept them as they are; the first append converts one to a log.
+
+#ifndef EXPLOIT_LOG_H
+#define EXPLOIT_LOG_H
+#pragma once
+
+#include <stdio.h>
+
+#include "db.h"
+
+namespace game_exploits {
+// Writes the path of the named player's exploits file into 'filename'.
+void log_filename(const char* name, char* filename);
+
+// Appends 'record' to the named player's exploits.
+bool append(const char* name, const exploit_record& record);
+
+// Reads a player's exploits, newest first.
+class reader {
+public:
+    explicit reader(const char* name);
+    ~reader();
+
+    // False if the player has no exploits file.
+    bool is_open() const { return m_file != 0; }
+
+    // Fills 'record' with the next exploit, or returns false at the end.
+    bool next(exploit_record& record);
+
+private:
+    reader(const reader&);
+    reader& operator=(const reader&);
+
+    bool fill();
+
+    static const int CHUNK = 64;
+
+    FILE* m_file;
+    bool m_oldest_first; // false for a file written before the log
+    long m_unread; // records not yet read into the chunk
+    long m_count; // records in the file
+    exploit_record m_chunk[CHUNK];
+    int m_chunk_left;
+};
+}
+
+#endif /* EXPLOIT_LOG_H */
@@ -15,13 +15,16 @@
 #include <string.h>
 
 #include "color.h"
+#include "combat_roster.h"
 #include "comm.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "name_index.h"
 #include "pkill.h"
 #include "script.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -38,8 +41,7 @@
     ((_at) >= TYPE_HIT && (_at) <= TYPE_CRUSH ? TRUE : FALSE)
 
 /* Structures */
-struct char_data* combat_list = 0; /* head of l-list of fighting chars */
-struct char_data* combat_next_dude = 0; /* Next dude global trick */
+game_rules::combat_roster combat_list; /* the fighting chars */
 
 /* External structures */
 extern struct room_data world;
@@ -221,9 +223,6 @@ void update_pos(struct char_data* victim)
 /* start one char fighting another (yes, it is horrible, I know... )  */
 void set_fighting(struct char_data* ch, struct char_data* vict)
 {
-
-    struct char_data* tmpch;
-
     if (ch == vict)
         return;
 
@@ -233,14 +232,7 @@ void set_fighting(struct char_data* ch, struct char_data* vict)
         return;
     }
 
-    for (tmpch = combat_list; tmpch; tmpch = tmpch->next_fighting)
-        if (tmpch == ch)
-            break;
-
-    if (!tmpch) {
-        ch->next_fighting = combat_list;
-        combat_list = ch;
-    }
+    combat_list.add(ch);
 
     ch->specials.fighting = vict;
     if (vict)
@@ -267,10 +259,13 @@ void stop_fighting(struct char_data* ch)
      * ch is not directly fighting that_char, and ch CAN_SEE that_char,
      * tmp = that_char, otherwise (if no characters are found) tmp = NULL.
      */
-    for (tmp = combat_list; tmp; tmp = tmp->next_fighting)
-        if (tmp->specials.fighting == ch && tmp != oppon
-            && CAN_SEE(ch, tmp))
+    tmp = 0;
+    for (char_data* fighter : combat_list)
+        if (fighter->specials.fighting == ch && fighter != oppon
+            && CAN_SEE(ch, fighter)) {
+            tmp = fighter;
             break;
+        }
 
     /*
      *If we didn't find a character above, and ch has not regenned energy or
@@ -287,28 +282,15 @@ void stop_fighting(struct char_data* ch)
 
     /* here remain only cases with Energy >= Ene_to_hit already, or dead ones */
     if (!tmp) {
-        if (ch == combat_next_dude)
-            combat_next_dude = ch->next_fighting;
-
-        if (combat_list == ch)
-            combat_list = ch->next_fighting;
-        else {
-            for (tmp = combat_list; tmp && (tmp->next_fighting != ch);
-                 tmp = tmp->next_fighting)
-                ;
-
-            if (!tmp) {
-                ch->next_fighting = 0;
-                ch->specials.fighting = 0;
-                if (GET_POS(ch) == POSITION_FIGHTING)
-                    GET_POS(ch) = POSITION_STANDING;
-                update_pos(ch);
-                return; /* he's not fighting */
-            }
-            tmp->next_fighting = ch->next_fighting;
+        if (!combat_list.contains(ch)) {
+            ch->specials.fighting = 0;
+            if (GET_POS(ch) == POSITION_FIGHTING)
+                GET_POS(ch) = POSITION_STANDING;
+            update_pos(ch);
+            return; /* he's not fighting */
         }
 
-        ch->next_fighting = 0;
+        combat_list.remove(ch);
         ch->specials.fighting = 0;
         if (GET_POS(ch) == POSITION_FIGHTING) {
             GET_POS(ch) = POSITION_STANDING;
@@ -322,14 +304,9 @@ void stop_fighting(struct char_data* ch)
 
 void stop_fighting_him(struct char_data* ch)
 {
-
-    struct char_data *tmp, *next_fighter;
-
-    for (tmp = combat_list; tmp; tmp = next_fighter) {
-        next_fighter = tmp->next_fighting;
+    for (char_data* tmp : combat_list)
         if (tmp->specials.fighting == ch)
             stop_fighting(tmp);
-    }
 }
 
 /*
@@ -691,13 +668,14 @@ obj_data* make_physical_corpse(char_data* character, char_data* killer, int atta
     }
 
     if (!corpse) {
-        CREATE(corpse, struct obj_data, 1);
+        corpse = game_memory::object_pool.allocate();
         clear_object(corpse);
         corpse->next = object_list;
         object_list = corpse;
         corpse->item_number = NOWHERE;
         corpse->in_room = NOWHERE;
         corpse->name = str_dup("corpse");
+        game_index::add_obj(corpse);
 
         /* We call this function to retrieve our corpse "type"*/
         get_corpse_desc(corpse, character, attack_type);
@@ -2754,14 +2732,12 @@ void perform_violence(int mini_tics)
     timeval time_difference = timediff(&current_time, &last_time);
 
     float time_delta = time_difference.tv_sec + time_difference.tv_usec / 1000000.0f;
-    for (char_data* fighter = combat_list; fighter; fighter = combat_next_dude) {
+    for (char_data* fighter : combat_list) {
         fighter->damage_details.tick(time_delta);
         if (fighter->group) {
             fighter->group->track_combat_time(fighter, time_delta);
         }
 
-        combat_next_dude = fighter->next_fighting;
-
         SET_CURRENT_PARRY(fighter) = std::min(GET_CURRENT_PARRY(fighter) + 3, 100);
 
         if (GET_MENTAL_DELAY(fighter) && (GET_MENTAL_DELAY(fighter) > -120)) {
@@ -2826,6 +2802,9 @@ void perform_violence(int mini_tics)
             }
         }
     }
+
+    /* close up the places of those who left the fight this round */
+    combat_list.compact();
 }
 
 #define SWORD_HAND WIELD
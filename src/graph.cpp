@@ -8,14 +8,6 @@
  *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
  ************************************************************************ */
 
-#define TRACK_THROUGH_DOORS
-
-/*
- * You can define or not define TRACK_THOUGH_DOORS, above, depending on
- * whether or not you want track to find paths which lead through closed
- * or hidden doors.
- */
-
 #include "platdef.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,6 +16,7 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "pathfind.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -41,113 +34,17 @@ extern struct skill_data skills[];
 ACMD(do_say);
 ACMD(do_move);
 
-struct bfs_queue_struct {
-    int room;
-    char dir;
-    struct bfs_queue_struct* next;
-};
-
-static struct room_data *queue_head = 0, *queue_tail = 0;
-
-/* Utility macros */
-#define MARK(room) (SET_BIT((room)->room_flags, BFS_MARK))
-#define UNMARK(room) (REMOVE_BIT((room)->room_flags, BFS_MARK))
-#define IS_MARKED(room) (IS_SET((room)->room_flags, BFS_MARK | NO_MOB | DEATH))
-#define TOROOM(x, y) ((x)->dir_option[(y)]->to_room)
-
-#ifdef TRACK_THROUGH_DOORS
-#define IS_CLOSED(x, y) (IS_SET((x)->dir_option[(y)]->exit_info, EX_LOCKED | EX_ISHIDDEN) && (IS_SET((x)->dir_option[(y)]->exit_info, EX_CLOSED) || !IS_SET((x)->dir_option[(y)]->exit_info, EX_ISDOOR)))
-#else
-#define IS_CLOSED(x, y) (IS_SET((x)->dir_option[(y)]->exit_info, EX_CLOSED))
-#endif
-
-#define VALID_EDGE(x, y) ((x)->dir_option[(y)] && (TOROOM(x, y) != NOWHERE) && (!IS_CLOSED(x, y)) && (!IS_MARKED(&world[TOROOM(x, y)])))
-
-void bfs_enqueue(room_data* room, char dir)
-{
-
-    room_data* curr;
-    curr = room;
-    curr->bfs_next = 0;
-    curr->bfs_dir = dir;
-    if (queue_tail) {
-        queue_tail->bfs_next = curr;
-        queue_tail = curr;
-    } else
-        queue_head = queue_tail = curr;
-}
-
-void bfs_dequeue(void)
-{
-
-    room_data* curr;
-    curr = queue_head;
-    if (!(queue_head = queue_head->bfs_next))
-        queue_tail = 0;
-}
-
-void bfs_clear_queue(void)
-{
-    while (queue_head)
-        bfs_dequeue();
-}
-
 /*
  * find_first_step: given a source room and a target room, find the first
  * step on the shortest path from the source to the target.
  * Intended usage: in mobile_activity, give a mob a dir to go if they're
  * tracking another mob or a PC.  Or, a 'track' skill for PCs.
+ * The search itself lives in pathfind.cpp.
  */
 
 int find_first_step(int src, int target)
 {
-
-    int curr_room, curr_dir;
-    room_data *src_room, *target_room;
-
-    if (src < 0 || src > top_of_world || target < 0 || target > top_of_world) {
-        log("Illegal value passed to find_first_step (graph.c)");
-        return BFS_ERROR;
-    }
-
-    if (src == target)
-        return BFS_ALREADY_THERE;
-
-    /* clear marks first */
-    for (curr_room = 0; curr_room <= top_of_world; curr_room++)
-        UNMARK(&world[curr_room]);
-
-    src_room = &world[src];
-    target_room = &world[target];
-    MARK(src_room);
-
-    /*
-     * first, enqueue the first steps, saving which
-     * direction we're going.
-     */
-    for (curr_dir = 0; curr_dir < NUM_OF_DIRS; curr_dir++)
-        if (VALID_EDGE(src_room, curr_dir)) {
-            MARK(&world[(int)TOROOM(src_room, curr_dir)]);
-            bfs_enqueue(&world[(int)TOROOM(src_room, curr_dir)], curr_dir);
-        }
-
-    /* now, do the classic BFS. */
-    while (queue_head) {
-        if (queue_head == target_room) {
-            curr_dir = queue_head->bfs_dir;
-            bfs_clear_queue();
-            return curr_dir;
-        } else {
-            for (curr_dir = 0; curr_dir < NUM_OF_DIRS; curr_dir++)
-                if (VALID_EDGE(queue_head, curr_dir)) {
-                    MARK(&world[TOROOM(queue_head, curr_dir)]);
-                    bfs_enqueue(&world[TOROOM(queue_head, curr_dir)],
-                        queue_head->bfs_dir);
-                }
-            bfs_dequeue();
-        }
-    }
-    return BFS_NO_PATH;
+    return game_path::first_step(src, target);
 }
 
 /*
@@ -21,13 +21,12 @@
  *    present in ch->affected.                                             *
  *                                                                         *
  *  affected_type_pool                                                     *
- *    This is a linked list of unused affections which can be allocated to *
- *    characters as and when they are needed.  Once the affection is       *
- *    removed from a character it returns to the pool until it is needed.  *
- *    If the pool becomes empty then a call to get_from_affected_type_pool *
- *    will allocate resources for a new affection. Rooms also use this     *
- *    pool since their affection handling should be almost identical to    *
- *    characters.                                                          *
+ *    Affections are allocated from game_memory::affect_pool as and when   *
+ *    they are needed.  Once the affection is removed from a character it  *
+ *    returns to the pool until it is needed.  If the pool becomes empty   *
+ *    then a call to get_from_affected_type_pool will make it take a new   *
+ *    slab of affections.  Rooms also use this pool since their affection  *
+ *    handling should be almost identical to characters.                   *
  **************************************************************************/
 
 #include "platdef.h"
@@ -37,10 +36,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "combat_roster.h"
 #include "comm.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "limits.h"
+#include "mob_activity.h"
+#include "name_index.h"
+#include "script.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -86,15 +91,9 @@ int dummy_affected_var = 17;
 universal_list* affected_list = 0;
 universal_list* affected_list_pool = 0;
 
-affected_type* affected_type_pool = 0;
-int affected_type_counter = 0;
-
 struct affected_type* get_from_affected_type_pool();
 void put_to_affected_type_pool(struct affected_type*);
 
-follow_type* follow_type_pool = 0;
-int follow_type_counter = 0;
-
 struct follow_type* get_from_follow_type_pool();
 void put_to_follow_type_pool(struct follow_type*);
 
@@ -171,18 +170,14 @@ void recount_light_room(int room)
 {
     struct char_data* tmpch;
     struct obj_data* tmpobj;
-    int count, tmp;
+    int count;
 
     if ((room < 0) || (room >= top_of_world))
         return;
 
     count = 0;
     for (tmpch = world[room].people; tmpch; tmpch = tmpch->next_in_room)
-        for (tmp = 0; tmp < MAX_WEAR; tmp++)
-            if (tmpch->equipment[tmp])
-                if (tmpch->equipment[tmp]->obj_flags.type_flag == ITEM_LIGHT)
-                    if ((tmpch->equipment[tmp]->obj_flags.value[2] != 0) && (tmpch->equipment[tmp]->obj_flags.value[3] != 0))
-                        count++;
+        count += tmpch->light;
 
     for (tmpobj = world[room].contents; tmpobj; tmpobj = tmpobj->next_content)
         if ((tmpobj->obj_flags.value[2] != 0) && (tmpobj->obj_flags.value[3] != 0))
@@ -517,31 +512,177 @@ void affect_naked(char_data* ch)
     }
 }
 
-void apply_gear_affects(char_data* character, const obj_data* item, int modify_flag)
+/*
+ * Locations whose modifiers can be summed and applied in one call:
+ * affect_modify() just adds them to a field.  Strength is left out since
+ * GET_STR_BASE() treats 0 specially, and speed since APPLY_BEND scales it.
+ */
+static bool order_free_apply(int location)
 {
-    for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
+    switch (location) {
+    case APPLY_DEX:
+    case APPLY_INT:
+    case APPLY_WILL:
+    case APPLY_CON:
+    case APPLY_LEA:
+    case APPLY_AGE:
+    case APPLY_CHAR_WEIGHT:
+    case APPLY_CHAR_HEIGHT:
+    case APPLY_DODGE:
+    case APPLY_OB:
+    case APPLY_DAMROLL:
+    case APPLY_SAVING_SPELL:
+    case APPLY_WILLPOWER:
+    case APPLY_PERCEPTION:
+    case APPLY_MANA_REGEN:
+    case APPLY_SPELL_PEN:
+    case APPLY_SPELL_POW:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Locations affect_modify() does nothing with, beyond the bitvector. */
+static bool inert_apply(int location)
+{
+    switch (location) {
+    case APPLY_NONE:
+    case APPLY_PROF:
+    case APPLY_LEVEL:
+    case APPLY_GOLD:
+    case APPLY_EXP:
+    case APPLY_REGEN:
+    case APPLY_ARMOR:
+        return true;
+    default:
+        return false;
+    }
+}
 
+static void gather_gear_bits(gear_affect_ledger& ledger)
+{
+    ledger.bits = 0;
+    for (int slot = 0; slot < MAX_WEAR; ++slot)
+        ledger.bits |= ledger.slot_bits[slot];
+}
+
+/* Enters the item in 'slot' into the ledger, the way affect_total() used
+   to walk it: a held item that cannot be held applies nothing, and neither
+   do APPLY_SPELL affects. */
+static void add_gear_affects(gear_affect_ledger& ledger, const obj_data* item, int slot)
+{
+    if (item == nullptr || (slot == HOLD && !CAN_WEAR(item, ITEM_HOLD)))
+        return;
+
+    bool applies = false;
+    for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
         const obj_affected_type& obj_affect = item->affected[count];
+        ledger.applied[slot][count] = obj_affect;
         if (obj_affect.location == APPLY_SPELL)
             continue;
 
-        affect_modify(character, obj_affect.location, obj_affect.modifier, item->obj_flags.bitvector, modify_flag, 0);
+        applies = true;
+        if (order_free_apply(obj_affect.location))
+            ledger.totals[obj_affect.location] += obj_affect.modifier;
+        else if (!inert_apply(obj_affect.location))
+            ledger.ordered_slots |= 1L << slot;
     }
+
+    if (applies) {
+        ledger.worn_slots |= 1L << slot;
+        ledger.slot_bits[slot] = item->obj_flags.bitvector;
+        gather_gear_bits(ledger);
+    }
+}
+
+/* Takes back exactly what add_gear_affects() entered for 'slot'. */
+static void remove_gear_affects(gear_affect_ledger& ledger, int slot)
+{
+    if (!(ledger.worn_slots & (1L << slot)))
+        return;
+
+    for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
+        const obj_affected_type& obj_affect = ledger.applied[slot][count];
+        if (obj_affect.location != APPLY_SPELL && order_free_apply(obj_affect.location))
+            ledger.totals[obj_affect.location] -= obj_affect.modifier;
+    }
+
+    ledger.worn_slots &= ~(1L << slot);
+    ledger.ordered_slots &= ~(1L << slot);
+    ledger.slot_bits[slot] = 0;
+    gather_gear_bits(ledger);
 }
 
-void apply_gear_affects(char_data* character, int modify_flag)
+/* Applies (or removes) everything the equipment contributes. */
+static void apply_gear_affects(char_data* character, int modify_flag)
 {
-    for (int item_index = 0; item_index < MAX_WEAR; ++item_index) {
-        const obj_data* item = character->equipment[item_index];
-        if (item == nullptr)
+    const gear_affect_ledger& ledger = character->gear_affects;
+    if (!ledger.worn_slots)
+        return;
+
+    affect_modify(character, APPLY_NONE, 0, ledger.bits, modify_flag, 0);
+
+    for (int location = 0; location < MAX_APPLY; ++location)
+        if (ledger.totals[location])
+            affect_modify(character, location, ledger.totals[location], 0, modify_flag, 0);
+
+    for (int slot = 0; slot < MAX_WEAR; ++slot) {
+        if (!(ledger.ordered_slots & (1L << slot)))
             continue;
 
-        if (item_index == HOLD && !CAN_WEAR(item, ITEM_HOLD))
+        for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
+            const obj_affected_type& obj_affect = ledger.applied[slot][count];
+            if (obj_affect.location != APPLY_SPELL && !order_free_apply(obj_affect.location) && !inert_apply(obj_affect.location))
+                affect_modify(character, obj_affect.location, obj_affect.modifier, 0, modify_flag, 0);
+        }
+    }
+}
+
+#if CHECK_AFFECT_LEDGER
+/* Rebuilds the ledger from the equipment and complains if it differs. */
+static void check_gear_affects(char_data* character)
+{
+    gear_affect_ledger fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    for (int slot = 0; slot < MAX_WEAR; ++slot)
+        add_gear_affects(fresh, character->equipment[slot], slot);
+
+    gear_affect_ledger& ledger = character->gear_affects;
+    bool same = fresh.bits == ledger.bits && fresh.worn_slots == ledger.worn_slots
+        && fresh.ordered_slots == ledger.ordered_slots
+        && memcmp(fresh.totals, ledger.totals, sizeof(fresh.totals)) == 0;
+    for (int slot = 0; same && slot < MAX_WEAR; ++slot)
+        if (fresh.worn_slots & (1L << slot))
+            for (int count = 0; count < MAX_OBJ_AFFECT; ++count)
+                if (fresh.applied[slot][count].location != ledger.applied[slot][count].location
+                    || fresh.applied[slot][count].modifier != ledger.applied[slot][count].modifier)
+                    same = false;
+
+    if (!same) {
+        sprintf(buf, "SYSERR: gear affects of %s out of step with their equipment.", GET_NAME(character));
+        mudlog(buf, NRM, LEVEL_GOD, TRUE);
+        ledger = fresh;
+    }
+}
+
+/* What affect_total() did with the equipment before the ledger: every
+   affect of every item, one at a time. */
+static void legacy_gear_affects(char_data* character, int modify_flag)
+{
+    for (int slot = 0; slot < MAX_WEAR; ++slot) {
+        const obj_data* item = character->equipment[slot];
+        if (item == nullptr || (slot == HOLD && !CAN_WEAR(item, ITEM_HOLD)))
             continue;
 
-        apply_gear_affects(character, item, modify_flag);
+        for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
+            const obj_affected_type& obj_affect = item->affected[count];
+            if (obj_affect.location != APPLY_SPELL)
+                affect_modify(character, obj_affect.location, obj_affect.modifier, item->obj_flags.bitvector, modify_flag, 0);
+        }
     }
 }
+#endif
 
 void modify_affects(char_data* character, int modify_flag)
 {
@@ -554,10 +695,28 @@ void modify_affects(char_data* character, int modify_flag)
     }
 }
 
-void affect_total(struct char_data* ch, int mode)
+static void clamp_abilities(char_data* ch)
+{
+    /* Make certain values are between 0..100, not < 0 and not > 100! */
+
+    signed char max_value = 100;
+    signed char min_dex_str = 1;
+    signed char min_others = 0;
+
+    ch->abilities.dex = std::max(min_dex_str, std::min(ch->abilities.dex, max_value));
+    ch->abilities.intel = std::max(min_others, std::min(ch->abilities.intel, max_value));
+    ch->abilities.wil = std::max(min_others, std::min(ch->abilities.wil, max_value));
+    ch->abilities.con = std::max(min_others, std::min(ch->abilities.con, max_value));
+    ch->abilities.str = std::max(min_dex_str, std::min(ch->abilities.str, max_value));
+    ch->abilities.lea = std::max(min_others, std::min(ch->abilities.lea, max_value));
+}
+
+#if CHECK_AFFECT_LEDGER
+/* affect_total() as it was before the ledger. */
+static void legacy_affect_total(char_data* ch, int mode)
 {
     if (mode & AFFECT_TOTAL_REMOVE) {
-        apply_gear_affects(ch, AFFECT_MODIFY_REMOVE);
+        legacy_gear_affects(ch, AFFECT_MODIFY_REMOVE);
         modify_affects(ch, AFFECT_MODIFY_REMOVE);
 
         recalc_abilities(ch);
@@ -565,57 +724,79 @@ void affect_total(struct char_data* ch, int mode)
     }
 
     if (mode & AFFECT_TOTAL_SET) {
-        apply_gear_affects(ch, AFFECT_MODIFY_SET);
+        legacy_gear_affects(ch, AFFECT_MODIFY_SET);
         modify_affects(ch, AFFECT_MODIFY_SET);
     }
 
     if (mode & AFFECT_TOTAL_TIME) {
-        apply_gear_affects(ch, AFFECT_MODIFY_TIME);
+        legacy_gear_affects(ch, AFFECT_MODIFY_TIME);
         modify_affects(ch, AFFECT_MODIFY_TIME);
     }
-    /* Make certain values are between 0..100, not < 0 and not > 100! */
+    clamp_abilities(ch);
+}
 
-    signed char max_value = 100;
-    signed char min_dex_str = 1;
-    signed char min_others = 0;
+/* Complains if the ledger left 'ch' with other stats than the legacy
+   recompute gives on 'before', a copy of it from before affect_total(). */
+static void check_affect_total(char_data* ch, char_data& before, int mode)
+{
+    legacy_affect_total(&before, mode);
 
-    ch->abilities.dex = std::max(min_dex_str, std::min(ch->abilities.dex, max_value));
-    ch->abilities.intel = std::max(min_others, std::min(ch->abilities.intel, max_value));
-    ch->abilities.wil = std::max(min_others, std::min(ch->abilities.wil, max_value));
-    ch->abilities.con = std::max(min_others, std::min(ch->abilities.con, max_value));
-    ch->abilities.str = std::max(min_dex_str, std::min(ch->abilities.str, max_value));
-    ch->abilities.lea = std::max(min_others, std::min(ch->abilities.lea, max_value));
+    if (memcmp(&before.abilities, &ch->abilities, sizeof(ch->abilities)) != 0
+        || memcmp(&before.tmpabilities, &ch->tmpabilities, sizeof(ch->tmpabilities)) != 0
+        || memcmp(&before.points, &ch->points, sizeof(ch->points)) != 0
+        || before.specials.affected_by != ch->specials.affected_by) {
+        sprintf(buf, "SYSERR: affect_total(%d) on %s differs from the full recompute.", mode, GET_NAME(ch));
+        mudlog(buf, NRM, LEVEL_GOD, TRUE);
+    }
 }
+#endif
 
-/*  If there is a structure of affected_type in the affected_type_pool list then
-        it is removed, if not then one is CREATEd.  A pointer to an available affected_type
-        structure is returned to be applied to a character or room. */
-
-struct affected_type* get_from_affected_type_pool()
+void affect_total(struct char_data* ch, int mode)
 {
-    struct affected_type* afnew;
+#if CHECK_AFFECT_LEDGER
+    check_gear_affects(ch);
+    char_data before(*ch);
+#endif
+
+    if (mode & AFFECT_TOTAL_REMOVE) {
+        apply_gear_affects(ch, AFFECT_MODIFY_REMOVE);
+        modify_affects(ch, AFFECT_MODIFY_REMOVE);
 
-    if (affected_type_pool) {
-        afnew = affected_type_pool;
-        affected_type_pool = afnew->next;
+        recalc_abilities(ch);
+        affect_naked(ch);
+    }
 
-        bzero(afnew, sizeof(affected_type));
-    } else {
-        CREATE(afnew, struct affected_type, 1);
-        affected_type_counter++;
+    if (mode & AFFECT_TOTAL_SET) {
+        apply_gear_affects(ch, AFFECT_MODIFY_SET);
+        modify_affects(ch, AFFECT_MODIFY_SET);
+    }
+
+    if (mode & AFFECT_TOTAL_TIME) {
+        /* all affect_modify() does for a time update */
+        if (ch->gear_affects.worn_slots || ch->affected)
+            ch->specials.affected_by |= race_affect[GET_RACE(ch)];
     }
-    return afnew;
+    clamp_abilities(ch);
+
+#if CHECK_AFFECT_LEDGER
+    check_affect_total(ch, before, mode);
+#endif
 }
 
-/* Puts a struct affected_type into the head of the pool.
- ** Replaced with free at the moment to aid bughunting. */
+/*  Returns a cleared affected_type from the affect pool, to be applied to a
+        character or room. */
 
-void put_to_affected_type_pool(struct affected_type* oldaf)
+struct affected_type* get_from_affected_type_pool()
 {
+    return game_memory::affect_pool.allocate();
+}
+
+/* Gives a struct affected_type back to the pool.  Debug builds poison it,
+ ** which does the bughunting plain free() used to be here for. */
 
-    free(oldaf);
-    //  oldaf->next = affected_type_pool;
-    //  affected_type_pool = oldaf;
+void put_to_affected_type_pool(struct affected_type* oldaf)
+{
+    game_memory::affect_pool.release(oldaf);
 }
 
 /* Insert an affect_type in a char_data structure
@@ -637,6 +818,7 @@ void affect_to_char(struct char_data* ch, struct affected_type* af)
         return;
 
     // 1
+    tmplist = 0;
     if (!ch->affected) {
         tmplist = pool_to_list(&affected_list, &affected_list_pool);
         tmplist->ptr.ch = ch;
@@ -658,6 +840,11 @@ void affect_to_char(struct char_data* ch, struct affected_type* af)
 
     affected_alloc->time_phase = get_current_time_phase();
 
+    if (tmplist)
+        schedule_affect_update(tmplist);
+    else
+        hasten_affect_update(ch, affected_alloc);
+
     // 5
     affect_modify(ch, af->location, af->modifier, af->bitvector,
         AFFECT_MODIFY_SET, af->counter);
@@ -685,6 +872,7 @@ void affect_to_room(struct room_data* room, struct affected_type* af)
         tmplist->ptr.room = room;
         tmplist->number = room->number;
         tmplist->type = TARGET_ROOM;
+        schedule_affect_update(tmplist);
     }
 
     affected_alloc = get_from_affected_type_pool();
@@ -741,8 +929,10 @@ void affect_remove(struct char_data* ch, struct affected_type* af)
     if (!ch->affected && affected_list) {
         for (tmplist = affected_list; tmplist; tmplist = tmplist2) {
             tmplist2 = tmplist->next;
-            if ((tmplist->type == TARGET_CHAR) && (tmplist->ptr.ch == ch))
+            if ((tmplist->type == TARGET_CHAR) && (tmplist->ptr.ch == ch)) {
+                cancel_affect_update(tmplist);
                 from_list_to_pool(&affected_list, &affected_list_pool, tmplist);
+            }
         }
     }
 
@@ -802,8 +992,10 @@ void affect_remove_room(struct room_data* room, struct affected_type* af)
     if (perms_only && affected_list) {
         for (tmplist = affected_list; tmplist; tmplist = tmplist2) {
             tmplist2 = tmplist->next;
-            if ((tmplist->type == TARGET_ROOM) && (tmplist->ptr.room == room))
+            if ((tmplist->type == TARGET_ROOM) && (tmplist->ptr.room == room)) {
+                cancel_affect_update(tmplist);
                 from_list_to_pool(&affected_list, &affected_list_pool, tmplist);
+            }
         }
     }
 
@@ -924,22 +1116,12 @@ void affect_join(struct char_data* ch, struct affected_type* af,
 
 struct follow_type* get_from_follow_type_pool()
 {
-    struct follow_type* folnew;
-
-    if (follow_type_pool) {
-        folnew = follow_type_pool;
-        follow_type_pool = folnew->next;
-    } else {
-        CREATE(folnew, struct follow_type, 1);
-        follow_type_counter++;
-    }
-    return folnew;
+    return game_memory::follower_pool.allocate();
 }
 
 void put_to_follow_type_pool(struct follow_type* oldfol)
 {
-    oldfol->next = follow_type_pool;
-    follow_type_pool = oldfol;
+    game_memory::follower_pool.release(oldfol);
 }
 
 /* Do NOT call this before having checked if a circle of followers */
@@ -1118,33 +1300,32 @@ void die_follower(char_data* character)
 /* move a player out of a room */
 void char_from_room(struct char_data* ch)
 {
-    struct char_data* i;
     int tmp;
+    game_activity::leave_room(ch);
     if (ch->in_room == NOWHERE) {
         //      log("SYSERR: NOWHERE extracting char from room (handler.c, char_from_room)");
         //      exit(1);
         return; // he's already nowehre
     }
 
-    for (tmp = 0; tmp < MAX_WEAR; tmp++)
-        if (ch->equipment[tmp])
-            if (ch->equipment[tmp]->obj_flags.type_flag == ITEM_LIGHT)
-                if (ch->equipment[tmp]->obj_flags.value[2] && (ch->equipment[tmp]->obj_flags.value[3])) /* Light is ON */
-                    world[ch->in_room].light--;
+    world[ch->in_room].light -= ch->light;
 
-    if (ch == world[ch->in_room].people) /* head of list */
-        world[ch->in_room].people = ch->next_in_room;
+    room_data& room = world[ch->in_room];
+    if (ch != room.people && !ch->prev_in_room)
+        return; /* not in the room's list */
 
-    else /* locate the previous element */ {
-        for (i = world[ch->in_room].people;
-             i && (i->next_in_room != ch); i = i->next_in_room)
-            ;
+    if (ch->prev_in_room)
+        ch->prev_in_room->next_in_room = ch->next_in_room;
+    else /* head of list */
+        room.people = ch->next_in_room;
 
-        if (!i)
-            return;
+    if (ch->next_in_room)
+        ch->next_in_room->prev_in_room = ch->prev_in_room;
+    else /* tail of list */
+        room.people_tail = ch->prev_in_room;
 
-        i->next_in_room = ch->next_in_room;
-    }
+    if (ch->specials.script_number)
+        room_script_departure(&room);
 
     tmp = char_power(GET_LEVEL(ch));
 
@@ -1158,6 +1339,7 @@ void char_from_room(struct char_data* ch)
 
     ch->in_room = NOWHERE;
     ch->next_in_room = 0;
+    ch->prev_in_room = 0;
     for (tmp = 0; ch->specials.fighting && (tmp < 100); tmp++) {
         if (ch->specials.fighting->specials.fighting == ch)
             stop_fighting(ch->specials.fighting);
@@ -1173,26 +1355,24 @@ void char_from_room(struct char_data* ch)
 /* place a character in a room */
 void char_to_room(struct char_data* ch, int room)
 {
-    struct char_data* tmpch;
     int tmp;
 
     /* append ch to the room's list */
-    if (!world[room].people)
-        world[room].people = ch;
-    else {
-        for (tmpch = world[room].people; tmpch->next_in_room; tmpch = tmpch->next_in_room)
-            ;
-        tmpch->next_in_room = ch;
-    }
+    ch->prev_in_room = world[room].people_tail;
     ch->next_in_room = 0;
+    if (world[room].people_tail)
+        world[room].people_tail->next_in_room = ch;
+    else
+        world[room].people = ch;
+    world[room].people_tail = ch;
     ch->in_room = room;
+    game_activity::enter_room(ch);
+
+    if (ch->specials.script_number)
+        room_script_arrival(&world[room], ch->specials.script_number);
 
     /* do they have a light? */
-    for (tmp = 0; tmp < MAX_WEAR; tmp++)
-        if (ch->equipment[tmp])
-            if (ch->equipment[tmp]->obj_flags.type_flag == ITEM_LIGHT)
-                if (ch->equipment[tmp]->obj_flags.value[2] && (ch->equipment[tmp]->obj_flags.value[3])) /* Light is ON */
-                    world[room].light++;
+    world[room].light += ch->light;
 
     tmp = char_power(GET_LEVEL(ch));
 
@@ -1209,6 +1389,9 @@ void char_to_room(struct char_data* ch, int room)
 void obj_to_char(struct obj_data* object, struct char_data* ch)
 {
     object->next_content = ch->carrying;
+    object->prev_content = 0;
+    if (ch->carrying)
+        ch->carrying->prev_content = object;
     ch->carrying = object;
     object->carried_by = ch;
     object->in_room = NOWHERE;
@@ -1227,29 +1410,23 @@ void obj_to_char(struct obj_data* object, struct char_data* ch)
 /* take an object from a char */
 void obj_from_char(struct obj_data* object)
 {
-    struct obj_data* tmp;
     int i;
 
-    if (object->carried_by->carrying == object) { /* head of list */
-        object->carried_by->carrying = object->next_content;
+    if (object->carried_by->carrying == object || object->prev_content) {
+        if (object->prev_content)
+            object->prev_content->next_content = object->next_content;
+        else /* head of list */
+            object->carried_by->carrying = object->next_content;
+        if (object->next_content)
+            object->next_content->prev_content = object->prev_content;
         IS_CARRYING_N(object->carried_by)
         --;
     } else {
-        for (tmp = object->carried_by->carrying;
-             tmp && (tmp->next_content != object);
-             tmp = tmp->next_content)
-            ; /* locate previous */
-        if (tmp) {
-            tmp->next_content = object->next_content;
-            IS_CARRYING_N(object->carried_by)
-            --;
-        } else {
-            for (i = 0; i < MAX_WEAR; i++)
-                if (object->carried_by->equipment[i] == object)
-                    break;
-            if (i < MAX_WEAR)
-                unequip_char(object->carried_by, i);
-        }
+        for (i = 0; i < MAX_WEAR; i++)
+            if (object->carried_by->equipment[i] == object)
+                break;
+        if (i < MAX_WEAR)
+            unequip_char(object->carried_by, i);
     }
 
     /* set flag for crash-save system */
@@ -1262,6 +1439,7 @@ void obj_from_char(struct obj_data* object)
     IS_CARRYING_W(object->carried_by) -= GET_OBJ_WEIGHT(object);
     object->carried_by = 0;
     object->next_content = 0;
+    object->prev_content = 0;
     object->in_room = NOWHERE;
 
     if (IS_OBJ_STAT(object, ITEM_WILLPOWER))
@@ -1311,6 +1489,7 @@ void equip_char(char_data* character, obj_data* item, int item_slot)
     }
 
     character->equipment[item_slot] = item;
+    add_gear_affects(character->gear_affects, item, item_slot);
     item->carried_by = character;
     item->obj_flags.timer = -1;
 
@@ -1344,10 +1523,12 @@ void equip_char(char_data* character, obj_data* item, int item_slot)
         SET_DODGE(character) += item->obj_flags.value[0];
         SET_PARRY(character) += item->obj_flags.value[1];
     } else if (GET_ITEM_TYPE(item) == ITEM_LIGHT) {
-        if ((character->in_room != NOWHERE) && (item->obj_flags.value[2] != 0)) {
-            if (item->obj_flags.value[3] == 0)
-                item->obj_flags.value[3] = 1;
-            world[character->in_room].light++;
+        if ((character->in_room != NOWHERE) && (item->obj_flags.value[2] != 0) && (item->obj_flags.value[3] == 0))
+            item->obj_flags.value[3] = 1;
+        if (item->obj_flags.value[2] && item->obj_flags.value[3]) { /* Light is ON */
+            character->light++;
+            if (character->in_room != NOWHERE)
+                world[character->in_room].light++;
         }
     }
 
@@ -1393,6 +1574,7 @@ struct obj_data* unequip_char(struct char_data* ch, int pos)
     obj = ch->equipment[pos];
 
     ch->equipment[pos] = 0;
+    remove_gear_affects(ch->gear_affects, pos);
 
     ch->points.encumb -= obj->obj_flags.value[2] * encumb_table[pos];
     ch->specials2.leg_encumb -= obj->obj_flags.value[2] * leg_encumb_table[pos];
@@ -1419,10 +1601,13 @@ struct obj_data* unequip_char(struct char_data* ch, int pos)
         SET_PARRY(ch) -= obj->obj_flags.value[1];
 
     } else if (GET_ITEM_TYPE(obj) == ITEM_LIGHT) {
-        if ((ch->in_room != NOWHERE) && (obj->obj_flags.value[2] != 0) && (obj->obj_flags.value[3] != 0)) {
-            if (obj->obj_flags.value[3] > 0)
-                obj->obj_flags.value[3] = 0;
-            world[ch->in_room].light--;
+        if ((obj->obj_flags.value[2] != 0) && (obj->obj_flags.value[3] != 0)) { /* Light is ON */
+            ch->light--;
+            if (ch->in_room != NOWHERE) {
+                if (obj->obj_flags.value[3] > 0)
+                    obj->obj_flags.value[3] = 0;
+                world[ch->in_room].light--;
+            }
         }
     }
 
@@ -1565,6 +1750,18 @@ struct obj_data* get_obj(char* name)
     if (!(number = get_number(&tmp)))
         return (0);
 
+    std::vector<obj_data*> found;
+    if (game_index::find_objs(tmp, found)) {
+        j = 1;
+        for (size_t k = 0; k < found.size() && (j <= number); k++)
+            if (isname(tmp, found[k]->name)) {
+                if (j == number)
+                    return (found[k]);
+                j++;
+            }
+        return (0);
+    }
+
     for (i = object_list, j = 1; i && (j <= number); i = i->next)
         if (isname(tmp, i->name)) {
             if (j == number)
@@ -1623,6 +1820,18 @@ struct char_data* get_char(char* name)
     if (!(number = get_number(&tmp)))
         return (0);
 
+    std::vector<char_data*> found;
+    if (game_index::find_chars(tmp, found)) {
+        j = 1;
+        for (size_t k = 0; k < found.size() && (j <= number); k++)
+            if (isname(tmp, found[k]->player.name)) {
+                if (j == number)
+                    return (found[k]);
+                j++;
+            }
+        return (0);
+    }
+
     for (i = character_list, j = 1; i && (j <= number); i = i->next)
         if (isname(tmp, i->player.name)) {
             if (j == number)
@@ -1648,35 +1857,28 @@ struct char_data* get_char_num(int nr)
 /* put an object in a room */
 void obj_to_room(struct obj_data* object, int room)
 {
-    int tmp;
-    obj_data* tmpobj;
-
     if (!object)
         return;
 
-    for (tmpobj = world[room].contents; tmpobj; tmpobj = tmpobj->next_content)
-        if (tmpobj == object) {
-            sprintf(buf, "obj_to_room: double call for room %d, object %s\n", world[room].number, object->short_description);
-            mudlog(buf, NRM, LEVEL_IMPL, TRUE);
-            return;
-        }
+    if (object->in_room == room && (world[room].contents == object || object->prev_content)) {
+        sprintf(buf, "obj_to_room: double call for room %d, object %s\n", world[room].number, object->short_description);
+        mudlog(buf, NRM, LEVEL_IMPL, TRUE);
+        return;
+    }
     object->next_content = world[room].contents;
+    object->prev_content = 0;
+    if (world[room].contents)
+        world[room].contents->prev_content = object;
     world[room].contents = object;
 
+    if (object->obj_flags.script_number)
+        room_script_arrival(&world[room], object->obj_flags.script_number);
+
     if (GET_ITEM_TYPE(object) == ITEM_LIGHT) {
         if (object->obj_flags.value[2] && object->obj_flags.value[3]) {
             world[room].light++;
         }
     }
-    for (tmp = 0, tmpobj = world[room].contents; tmpobj && (tmp < 1000);
-         tmpobj = tmpobj->next_content, tmp++)
-        ;
-    if (tmp >= 1000) {
-        mudlog("obj_to_room: infinite loop in room contents.",
-            NRM, LEVEL_GOD, TRUE);
-        world[room].contents = object;
-        object->next_content = 0;
-    }
     object->in_room = room;
     object->carried_by = 0;
     //   printf("obj_to_room %d, %p, descr:%s\n",world[room].number,object,object->description);
@@ -1685,22 +1887,20 @@ void obj_to_room(struct obj_data* object, int room)
 /* Take an object from a room */
 void obj_from_room(struct obj_data* object)
 {
-    struct obj_data* i;
-
     /* remove object from room */
 
     if (!object)
         return;
 
-    if (object == world[object->in_room].contents) /* head of list */
+    if (object->prev_content)
+        object->prev_content->next_content = object->next_content;
+    else /* head of list */
         world[object->in_room].contents = object->next_content;
+    if (object->next_content)
+        object->next_content->prev_content = object->prev_content;
 
-    else /* locate previous element in list */ {
-        for (i = world[object->in_room].contents; i && (i->next_content != object); i = i->next_content)
-            ;
-
-        i->next_content = object->next_content;
-    }
+    if (object->obj_flags.script_number)
+        room_script_departure(&world[object->in_room]);
 
     if (GET_ITEM_TYPE(object) == ITEM_LIGHT) {
         if (object->obj_flags.value[2] && object->obj_flags.value[3]) {
@@ -1711,6 +1911,7 @@ void obj_from_room(struct obj_data* object)
     }
     object->in_room = NOWHERE;
     object->next_content = 0;
+    object->prev_content = 0;
 }
 
 /* put an object in an object (quaint)  */
@@ -1720,6 +1921,9 @@ void obj_to_obj(obj_data* item, obj_data* container, char change_weight)
         return;
 
     item->next_content = container->contains;
+    item->prev_content = 0;
+    if (container->contains)
+        container->contains->prev_content = item;
     container->contains = item;
     item->in_obj = container;
 
@@ -1746,20 +1950,16 @@ void obj_from_obj(obj_data* item)
     if (item->in_obj) {
         obj_data* tmp;
         obj_data* obj_from = item->in_obj;
-        if (item == obj_from->contains) /* head of list */
-        {
+        if (item->prev_content)
+            item->prev_content->next_content = item->next_content;
+        else if (item == obj_from->contains) /* head of list */
             obj_from->contains = item->next_content;
-        } else {
-            for (tmp = obj_from->contains; tmp && (tmp->next_content != item); tmp = tmp->next_content)
-                ; /* locate previous */
-
-            if (!tmp) {
-                perror("SYSERR: Fatal error in object structures.");
-                abort();
-            }
-
-            tmp->next_content = item->next_content;
+        else {
+            perror("SYSERR: Fatal error in object structures.");
+            abort();
         }
+        if (item->next_content)
+            item->next_content->prev_content = item->prev_content;
 
         /* Subtract weight from containers container */
         for (tmp = item->in_obj; tmp->in_obj; tmp = tmp->in_obj) {
@@ -1774,6 +1974,7 @@ void obj_from_obj(obj_data* item)
 
         item->in_obj = 0;
         item->next_content = 0;
+        item->prev_content = 0;
     } else {
         perror("SYSERR: Trying to object from object when in no object.");
         abort();
@@ -1790,10 +1991,33 @@ void object_list_new_owner(struct obj_data* list, struct char_data* ch)
     }
 }
 
+/*
+ * A light lit or put out in place.  Worn lights count towards their
+ * wearer's light as well as the room's; lights in an inventory or a
+ * container count towards neither.
+ */
+void adjust_light(struct obj_data* light, int change)
+{
+    int pos;
+    struct char_data* wearer = light->carried_by;
+
+    if (wearer) {
+        for (pos = 0; pos < MAX_WEAR; pos++)
+            if (wearer->equipment[pos] == light)
+                break;
+        if (pos == MAX_WEAR)
+            return;
+        wearer->light += change;
+        if (wearer->in_room != NOWHERE)
+            world[wearer->in_room].light += change;
+    } else if (light->in_room != NOWHERE)
+        world[light->in_room].light += change;
+}
+
 /* Extract an object from the world */
 void extract_obj(struct obj_data* obj)
 {
-    struct obj_data *temp1, *temp2;
+    struct obj_data* temp1;
 
     if (obj->in_room != NOWHERE)
         obj_from_room(obj);
@@ -1801,24 +2025,19 @@ void extract_obj(struct obj_data* obj)
         obj_from_char(obj);
     else if (obj->in_obj) {
         temp1 = obj->in_obj;
-        if (temp1->contains == obj) /* head of list */
+        if (obj->prev_content)
+            obj->prev_content->next_content = obj->next_content;
+        else if (temp1->contains == obj) /* head of list */
             temp1->contains = obj->next_content;
-        else {
-            for (temp2 = temp1->contains;
-                 temp2 && (temp2->next_content != obj);
-                 temp2 = temp2->next_content)
-                ;
-
-            if (temp2) {
-                temp2->next_content = obj->next_content;
-            }
-        }
+        if (obj->next_content)
+            obj->next_content->prev_content = obj->prev_content;
     }
 
     for (; obj->contains; extract_obj(obj->contains))
         ;
     /* leaves nothing ! */
 
+    game_index::remove_obj(obj);
     if (object_list == obj) /* head of list */
         object_list = obj->next;
     else {
@@ -1888,11 +2107,10 @@ void extract_char(struct char_data* ch)
 void extract_char(struct char_data* ch, int new_room)
 {
     struct obj_data* i;
-    struct char_data *k, *k2, *next_char;
+    struct char_data *k, *k2;
     struct descriptor_data* t_desc;
     int l, was_in;
 
-    extern struct char_data* combat_list;
     extern struct char_data* waiting_list;
 
     if (!IS_NPC(ch) && !ch->desc) {
@@ -1935,6 +2153,7 @@ void extract_char(struct char_data* ch, int new_room)
 
                 /* append ch's stuff to room-contents */
                 i->next_content = ch->carrying;
+                ch->carrying->prev_content = i;
             } else
                 world[ch->in_room].contents = ch->carrying;
 
@@ -1944,6 +2163,7 @@ void extract_char(struct char_data* ch, int new_room)
                 i->in_room = ch->in_room;
             }
             ch->carrying = 0;
+            room_script_departure(&world[ch->in_room]); /* rebuild its trigger mask */
         } else {
             struct obj_data* j;
             for (i = ch->carrying; i; i = j) {
@@ -1956,11 +2176,9 @@ void extract_char(struct char_data* ch, int new_room)
     //    while (ch->affected)
     //       affect_remove(ch, ch->affected);
 
-    for (k = combat_list; k; k = next_char) {
-        next_char = k->next_fighting;
-        if (k->specials.fighting == ch)
-            stop_fighting(k);
-    }
+    for (char_data* fighter : combat_list)
+        if (fighter->specials.fighting == ch)
+            stop_fighting(fighter);
     for (k2 = 0, k = waiting_list; k; k = k->delay.next) {
         if (k == ch)
             break;
@@ -1990,9 +2208,12 @@ void extract_char(struct char_data* ch, int new_room)
     }
     for (l = 0; l < MAX_WEAR; l++)
         ch->equipment[l] = 0;
+    ch->light = 0;
+    memset(&ch->gear_affects, 0, sizeof(ch->gear_affects));
 
     if (IS_NPC(ch) || !(ch->desc) || (!ch->desc->descriptor) || (new_room < 0)) {
         /* pull the char from the list */
+        game_index::remove_char(ch);
 
         if (ch == character_list)
             character_list = ch->next;
@@ -2010,6 +2231,10 @@ void extract_char(struct char_data* ch, int new_room)
         }
     }
 
+    /* stop_fighting() leaves someone who has not regained the energy to
+       hit in the combat list; the list must not outlive them */
+    combat_list.remove(ch);
+
     if (ch->desc) {
         if (ch->desc->original) {
             do_return(ch, "", 0, 0, 0);
@@ -2102,6 +2327,14 @@ struct char_data* get_char_room_vis(struct char_data* ch, char* name, int dark_o
 struct char_data* get_player_vis(struct char_data* ch, char* name)
 {
     struct char_data* i;
+    std::vector<char_data*> found;
+
+    if (game_index::find_chars(name, found)) {
+        for (char_data* candidate : found)
+            if (!IS_NPC(candidate) && !str_cmp(candidate->player.name, name) && CAN_SEE(ch, candidate))
+                return candidate;
+        return 0;
+    }
 
     for (i = character_list; i; i = i->next)
         if (!IS_NPC(i) && !str_cmp(i->player.name, name) && CAN_SEE(ch, i))
@@ -2110,6 +2343,27 @@ struct char_data* get_player_vis(struct char_data* ch, char* name)
     return 0;
 }
 
+/*
+ * Could `word' pick out someone on the other side of the race war by
+ * their race, as get_char_vis() lets it?  Only players and the charmed
+ * can see someone as being on the other side.
+ */
+static int may_name_race(struct char_data* ch, char* word)
+{
+    int race;
+
+    if (IS_NPC(ch) && !IS_AFFECTED(ch, AFF_CHARM))
+        return 0;
+    if (GET_RACE(ch) == RACE_GOD)
+        return 0;
+
+    for (race = 0; *pc_race_keywords[race] != '\n'; race++)
+        if (isname(word, pc_race_keywords[race]))
+            return 1;
+
+    return 0;
+}
+
 struct char_data* get_char_vis(struct char_data* ch, char* name, int dark_ok)
 {
     struct char_data* i;
@@ -2126,6 +2380,27 @@ struct char_data* get_char_vis(struct char_data* ch, char* name, int dark_ok)
     if (!(number = get_number(&tmp)))
         return (0);
 
+    /* the index only knows names, so a race keyword means a full search */
+    std::vector<char_data*> found;
+    if (!may_name_race(ch, tmp) && game_index::find_chars(tmp, found)) {
+        j = 1;
+        for (size_t k = 0; k < found.size() && (j <= number); k++) {
+            i = found[k];
+            if (other_side(ch, i))
+                check = isname(tmp, pc_race_keywords[i->player.race]);
+            else
+                check = isname(tmp, i->player.name);
+
+            if (check)
+                if (CAN_SEE(ch, i, dark_ok)) {
+                    if (j == number)
+                        return (i);
+                    j++;
+                }
+        }
+        return (0);
+    }
+
     for (i = character_list, j = 1; i && (j <= number); i = i->next) {
         if (other_side(ch, i))
             check = isname(tmp, pc_race_keywords[i->player.race]);
@@ -2193,7 +2468,21 @@ struct obj_data* get_obj_vis(struct char_data* ch, char* name)
     if (!(number = get_number(&tmp)))
         return (0);
 
-    /* ok.. no luck yet. scan the entire obj list   */
+    /* ok.. no luck yet. scan the objects that may answer to it */
+    std::vector<obj_data*> found;
+    if (game_index::find_objs(tmp, found)) {
+        j = 1;
+        for (size_t k = 0; k < found.size() && (j <= number); k++)
+            if (isname(tmp, found[k]->name, 0))
+                if (CAN_SEE_OBJ(ch, found[k])) {
+                    if (j == number)
+                        return (found[k]);
+                    j++;
+                }
+        return (0);
+    }
+
+    /* no index for this name.. scan the entire obj list   */
     for (i = object_list, j = 1; i && (j <= number); i = i->next)
         if (isname(tmp, i->name, 0))
             if (CAN_SEE_OBJ(ch, i)) {
@@ -2229,7 +2518,7 @@ struct obj_data* create_money(int amount)
         exit(1);
     }
 
-    CREATE(obj, struct obj_data, 1);
+    obj = game_memory::object_pool.allocate();
     CREATE(new_descr, struct extra_descr_data, 1);
     clear_object(obj);
     if (amount == 1) {
@@ -2286,6 +2575,7 @@ struct obj_data* create_money(int amount)
 
     obj->next = object_list;
     object_list = obj;
+    game_index::add_obj(obj);
 
     return (obj);
 }
@@ -24,6 +24,13 @@
 #define AFFECT_MODIFY_REMOVE 0
 #define AFFECT_MODIFY_TIME 2
 
+/* Build with -DCHECK_AFFECT_LEDGER=1 to have affect_total() rebuild each
+   gear ledger from the equipment, repeat its work the old way on a copy of
+   the character, and log any difference. */
+#ifndef CHECK_AFFECT_LEDGER
+#define CHECK_AFFECT_LEDGER 0
+#endif
+
 void affect_total_room(struct room_data* room, int mode = AFFECT_TOTAL_UPDATE);
 void affect_modify_room(struct room_data* room, byte loc, int mod, long bitv, char add);
 void affect_to_room(struct room_data* room, struct affected_type* af);
@@ -76,6 +83,9 @@ void object_list_new_owner(struct obj_data* list, struct char_data* ch);
 
 void extract_obj(struct obj_data* obj);
 
+/* call after lighting (change 1) or putting out (change -1) a light */
+void adjust_light(struct obj_data* light, int change);
+
 /* ******* characters ********* */
 int other_side(const char_data* character, const char_data* other);
 int other_side_num(int ch_race, int i_race);
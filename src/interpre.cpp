@@ -16,14 +16,17 @@
 
 #include "color.h"
 #include "comm.h"
+#include "command_trie.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
 #include "mail.h"
 #include "pkill.h"
+#include "player_index.h"
 #include "profs.h"
 #include "protos.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -1316,7 +1319,7 @@ void command_interpreter(struct char_data* ch, char* argument_chr,
             for (look_at = 0; *(argument + begin + look_at) > ' '; look_at++)
                 *(argument + begin + look_at) = LOWER(*(argument + begin + look_at));
 
-            cmd = old_search_block(argument, begin, look_at, command, 0);
+            cmd = game_commands::lookup(argument + begin, look_at).command;
         }
     } else {
         /* if you're hazed, you have a 10% chance of forgetting targ1 */
@@ -2231,13 +2234,7 @@ void assign_command_pointers(void)
 int find_name(char* name)
 /* locate entry in p_table with entry->name == name. -1 mrks failed search */
 {
-    int i;
-
-    for (i = 0; i <= top_of_p_table; i++)
-        if (!str_cmp((player_table + i)->name, name))
-            return i;
-
-    return -1;
+    return game_index::players.find_name(name);
 }
 
 int _parse_name(char* arg, char* name)
@@ -2278,7 +2275,7 @@ void nanny(struct descriptor_data* d, char* arg)
     switch (STATE(d)) {
     case CON_NME: /* wait for input of name */
         if (!d->character) {
-            CREATE(d->character, struct char_data, 1);
+            d->character = game_memory::character_pool.allocate();
             clear_char(d->character, MOB_VOID);
             register_pc_char(d->character);
             d->character->desc = d;
@@ -2311,7 +2308,7 @@ void nanny(struct descriptor_data* d, char* arg)
 
             if (PLR_FLAGGED(d->character, PLR_DELETED)) {
                 free_char(d->character);
-                CREATE(d->character, struct char_data, 1);
+                d->character = game_memory::character_pool.allocate();
                 clear_char(d->character, MOB_VOID);
                 register_pc_char(d->character);
                 d->character->desc = d;
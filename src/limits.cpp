@@ -27,8 +27,11 @@
 
 #include "big_brother.h"
 #include "char_utils.h"
+#include "timer_wheel.h"
 #include <algorithm>
 #include <cmath>
+#include <stdint.h>
+#include <unordered_map>
 
 extern char* pc_race_types[];
 
@@ -574,6 +577,7 @@ int check_idling(char_data* character)
                 character->equipment[j] = NULL;
             }
         }
+        memset(&character->gear_affects, 0, sizeof(character->gear_affects));
         Crash_extract_objs(character->carrying);
 
         if (character->desc && character->desc->descriptor) {
@@ -781,20 +785,21 @@ void point_update(void)
             //      printf("resetting fountain %s\n",j->name);
             j->obj_flags.value[1] = j->obj_flags.value[0];
         } else if (GET_ITEM_TYPE(j) == ITEM_LIGHT) {
+            int was_lit = j->obj_flags.value[2] && j->obj_flags.value[3];
             if ((j->obj_flags.value[2] > 0) && (j->obj_flags.value[3] > 0) && !(IS_NPC(j->carried_by)))
                 j->obj_flags.value[2]--;
             if ((j->obj_flags.value[2] == 0) && (j->obj_flags.value[3] > 0)) {
                 // the torch went out messages
                 j->obj_flags.value[3] = 0;
+                if (was_lit)
+                    adjust_light(j, -1);
 
                 if (j->carried_by) {
                     act("Your $o went out.", FALSE, j->carried_by, j, 0, TO_CHAR);
                     act("$n's $o went out.", TRUE, j->carried_by, j, 0, TO_ROOM);
-                    recount_light_room(j->carried_by->in_room);
                 } else if (j->in_room != NOWHERE) {
                     sprintf(buf, "%s here went out.\n\r", j->short_description);
                     send_to_room(buf, j->in_room);
-                    recount_light_room(j->in_room);
                 }
                 extract_obj(j);
             } else if ((j->obj_flags.value[2] < 3) && (j->obj_flags.value[2] >= 0) && (j->obj_flags.value[3] > 0)) {
@@ -1461,15 +1466,94 @@ extern universal_list* affected_list;
 
 extern universal_list* affected_list_pool;
 
+/* Every entry of affected_list waits on affect_wheel, which moves on once
+   per affect_update(), until the next update at which one of its affects is
+   due: rooms and characters with fast affects every update, other
+   characters at the next time phase one of their affects was set in.
+   There are FAST_UPDATE_RATE time phases to an hour. */
+
+static game_timer::timer_wheel affect_wheel;
+static std::unordered_map<universal_list*, game_timer::timer_handle> affect_timers;
+static universal_list* affect_visiting = 0; /* entry being updated, if any */
+static int affect_phase = 0; /* time phase of the last affect_update */
+
+/* Updates before affect af is next due, counting the coming one as 1. */
+static int affect_due_in(struct affected_type* af)
+{
+    int next_phase = (affect_phase + 1) % FAST_UPDATE_RATE;
+
+    if ((af->type >= 0) && (af->type < MAX_SKILLS) && skills[af->type].is_fast)
+        return 1;
+    if (af->time_phase >= FAST_UPDATE_RATE)
+        return FAST_UPDATE_RATE; /* never due; look again in an hour */
+
+    return (af->time_phase - next_phase + FAST_UPDATE_RATE) % FAST_UPDATE_RATE + 1;
+}
+
+/* Schedules the entry for its next due update, unless it is already
+   scheduled for that one or an earlier one. */
+void schedule_affect_update(universal_list* entry)
+{
+    struct affected_type* af;
+    int delay;
+
+    delay = 1;
+    if ((entry->type == TARGET_CHAR) && char_exists(entry->number) && entry->ptr.ch && entry->ptr.ch->affected) {
+        delay = FAST_UPDATE_RATE;
+        for (af = entry->ptr.ch->affected; af && (delay > 1); af = af->next)
+            delay = std::min(delay, affect_due_in(af));
+    }
+
+    game_timer::timer_handle& timer = affect_timers[entry];
+    if (affect_wheel.pending(timer) && (affect_wheel.remaining(timer) <= delay))
+        return;
+
+    affect_wheel.cancel(timer);
+    timer = affect_wheel.schedule(delay, (uintptr_t)entry);
+}
+
+/* Must be called before the entry is returned to the pool. */
+void cancel_affect_update(universal_list* entry)
+{
+    std::unordered_map<universal_list*, game_timer::timer_handle>::iterator found;
+
+    found = affect_timers.find(entry);
+    if (found != affect_timers.end()) {
+        affect_wheel.cancel(found->second);
+        affect_timers.erase(found);
+    }
+    if (entry == affect_visiting)
+        affect_visiting = 0;
+}
+
+/* Called when af has joined ch's existing affects; brings ch's update
+   forward if af is due at the very next one. */
+void hasten_affect_update(struct char_data* ch, struct affected_type* af)
+{
+    universal_list* tmplist;
+
+    if (affect_due_in(af) > 1)
+        return;
+
+    for (tmplist = affected_list; tmplist; tmplist = tmplist->next)
+        if ((tmplist->type == TARGET_CHAR) && (tmplist->ptr.ch == ch)) {
+            schedule_affect_update(tmplist);
+            return;
+        }
+}
+
 void affect_update()
 {
-    universal_list *tmplist, *tmplist2, *tmplist3;
-    ;
+    universal_list* tmplist;
+    unsigned long long key;
     char mybuf[1000];
 
-    tmplist3 = 0;
-    for (tmplist = affected_list; tmplist; tmplist = tmplist2) {
-        tmplist2 = tmplist->next;
+    affect_phase = get_current_time_phase();
+
+    affect_wheel.advance();
+    while (affect_wheel.next_expired(key)) {
+        tmplist = (universal_list*)(uintptr_t)key;
+        affect_visiting = tmplist;
 
         if (tmplist->type == TARGET_CHAR) {
 
@@ -1481,13 +1565,18 @@ void affect_update()
                 else
                     strcpy(mybuf, "Getting Unknown char off the affected_list.");
                 mudlog(mybuf, CMP, LEVEL_GRGOD, TRUE);
+                cancel_affect_update(tmplist);
                 from_list_to_pool(&affected_list, &affected_list_pool, tmplist);
             }
         } else if (tmplist->type == TARGET_ROOM) {
             affect_update_room(tmplist->ptr.room);
         }
-        tmplist3 = tmplist; /* prev item */
+
+        /* The update may have taken the entry off the list. */
+        if (affect_visiting)
+            schedule_affect_update(tmplist);
     }
+    affect_visiting = 0;
 }
 
 void fast_update()
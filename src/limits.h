@@ -13,6 +13,7 @@
 
 struct char_data;
 struct affected_type;
+struct universal_list;
 
 /* Public Procedures */
 float mana_gain(const char_data* ch);
@@ -35,6 +36,10 @@ void gain_condition(struct char_data* ch, int condition, int value);
 int check_idling(struct char_data* ch);
 // returns non-zero if ch was extracted
 void point_update(void);
+void affect_update(void);
+void schedule_affect_update(struct universal_list* entry);
+void cancel_affect_update(struct universal_list* entry);
+void hasten_affect_update(struct char_data* ch, struct affected_type* af);
 void update_pos(struct char_data* victim);
 void remove_fame_war_bonuses(struct char_data* ch, struct affected_type* pkaff);
 
@@ -13,6 +13,7 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "pathfind.h"
 #include "platdef.h"
 #include "spells.h"
 #include "structs.h"
@@ -1650,11 +1651,13 @@ ASPELL(spell_earthquake)
                     act("The way down crashes open!", FALSE, caster, 0, 0, TO_ROOM);
                     send_to_char("The way down crashes open!\n\r", caster);
                     cur_room->dir_option[DOWN]->exit_info = 0;
+                    game_path::doors_changed(*cur_room);
                     if (world[crack].dir_option[UP] && (world[crack].dir_option[UP]->to_room == caster->in_room) && world[crack].dir_option[UP]->exit_info) {
                         tmp = caster->in_room;
                         caster->in_room = crack;
                         act("The way up crashes open!", FALSE, caster, 0, 0, TO_ROOM);
                         world[crack].dir_option[UP]->exit_info = 0;
+                        game_path::doors_changed(world[crack]);
                         caster->in_room = tmp;
                     }
                 }
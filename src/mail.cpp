@@ -97,6 +97,8 @@ Send comments, bug reports, etc. to jelson@server.cs.jhu.edu
 #include "handler.h"
 #include "interpre.h"
 #include "mail.h"
+#include "name_index.h"
+#include "slab_pool.h"
 #include "structs.h"
 #include "utils.h"
 
@@ -632,7 +634,7 @@ void postmaster_receive_mail(struct char_data* ch, int cmd, char* arg, char_data
     }
 
     while (has_mail(recipient)) {
-        CREATE(tmp_obj, struct obj_data, 1);
+        tmp_obj = game_memory::object_pool.allocate();
         clear_object(tmp_obj);
 
         tmp_obj->name = str_dup("mail paper letter");
@@ -651,6 +653,7 @@ void postmaster_receive_mail(struct char_data* ch, int cmd, char* arg, char_data
 
         tmp_obj->next = object_list;
         object_list = tmp_obj;
+        game_index::add_obj(tmp_obj);
 
         obj_to_char(tmp_obj, ch);
 
@@ -0,0 +1,217 @@
+/* mob_activity.cpp */
+
+#include "mob_activity.h"
+
+#include "platdef.h"
+#include "structs.h"
+#include "utils.h"
+
+#include <unordered_set>
+#include <vector>
+
+extern struct room_data world;
+extern int mobile_activity_budget; /* see config.c */
+
+namespace game_activity {
+activity_stats activity_totals;
+
+namespace {
+    enum { NOT_FILED,
+        IDLE,
+        BUSY };
+
+    struct zone_bucket {
+        std::vector<char_data*> idle;
+        std::vector<char_data*> busy;
+        int players;
+        unsigned int awake_until; // pulse the zone stays awake until
+        unsigned int next_visit; // pulse its idle mobiles are next due
+    };
+
+    std::vector<zone_bucket> zones;
+    unsigned int pulse = 0;
+    int sleep_cursor = 0; // first zone to consider for a sleeping visit
+
+    // The characters due this pulse, and those among them that have left
+    // a room without entering another since the pulse started.
+    std::vector<char_data*> batch;
+    std::unordered_set<char_data*> departed;
+    bool running = false;
+
+    std::vector<char_data*>& members(zone_bucket& zone, int list)
+    {
+        return list == BUSY ? zone.busy : zone.idle;
+    }
+
+    bool is_awake(const zone_bucket& zone)
+    {
+        return zone.players > 0 || pulse < zone.awake_until;
+    }
+
+    bool is_busy(const char_data* ch)
+    {
+        if (!IS_NPC(ch) || ch->specials.fighting || ch->master)
+            return true;
+
+        long act = ch->specials2.act;
+        if (IS_SET(act, MOB_SPEC))
+            return true;
+        if (ch->specials.memory && (IS_SET(act, MOB_MEMORY | MOB_HUNTER) || IS_AFFECTED(ch, AFF_HUNT)))
+            return true;
+        return IS_SET(act, MOB_SCAVENGER) && world[ch->in_room].contents;
+    }
+
+    void file(char_data* ch, int zone_number, int list)
+    {
+        if (zone_number >= int(zones.size())) {
+            int first = int(zones.size());
+            zones.resize(zone_number + 1);
+            // Spread the sleeping visits of new zones over the sleep period.
+            for (int number = first; number <= zone_number; ++number)
+                zones[number].next_visit = pulse + number % SLEEP_PULSES;
+        }
+
+        std::vector<char_data*>& list_members = members(zones[zone_number], list);
+        ch->activity.zone = zone_number;
+        ch->activity.list = list;
+        ch->activity.slot = int(list_members.size());
+        list_members.push_back(ch);
+
+        ++activity_totals.filed;
+        if (list == BUSY)
+            ++activity_totals.busy;
+    }
+
+    void unfile(char_data* ch)
+    {
+        std::vector<char_data*>& list_members = members(zones[ch->activity.zone], ch->activity.list);
+        char_data* last = list_members.back();
+        list_members[ch->activity.slot] = last;
+        last->activity.slot = ch->activity.slot;
+        list_members.pop_back();
+
+        --activity_totals.filed;
+        if (ch->activity.list == BUSY)
+            --activity_totals.busy;
+        ch->activity.list = NOT_FILED;
+    }
+
+    void queue(const std::vector<char_data*>& list_members)
+    {
+        batch.insert(batch.end(), list_members.begin(), list_members.end());
+    }
+
+    // Queues the idle mobiles of sleeping zones that are due, starting at
+    // the cursor, until the budget is spent.  A zone is visited whole, and
+    // the first zone due is visited whatever its size, so a small budget
+    // slows the sleeping world down rather than stopping it.
+    void queue_sleeping_zones()
+    {
+        int zone_count = int(zones.size());
+        int budget = mobile_activity_budget;
+        int spent = 0;
+        int resume = -1;
+
+        for (int count = 0; count < zone_count; ++count) {
+            int number = (sleep_cursor + count) % zone_count;
+            zone_bucket& zone = zones[number];
+            if (is_awake(zone) || pulse < zone.next_visit)
+                continue;
+
+            int size = int(zone.idle.size());
+            if (budget > 0 && spent > 0 && spent + size > budget) {
+                ++activity_totals.deferred;
+                if (resume < 0)
+                    resume = number;
+                continue;
+            }
+
+            queue(zone.idle);
+            spent += size;
+            zone.next_visit = pulse + SLEEP_PULSES;
+        }
+
+        activity_totals.sleeping_visits += spent;
+        if (resume >= 0)
+            sleep_cursor = resume;
+    }
+}
+
+//============================================================================
+void enter_room(char_data* ch)
+{
+    leave_room(ch);
+    if (ch->in_room == NOWHERE)
+        return;
+
+    int zone_number = world[ch->in_room].zone;
+    file(ch, zone_number, is_busy(ch) ? BUSY : IDLE);
+    if (!IS_NPC(ch))
+        ++zones[zone_number].players;
+
+    if (running)
+        departed.erase(ch);
+}
+
+//============================================================================
+void leave_room(char_data* ch)
+{
+    if (ch->activity.list == NOT_FILED)
+        return;
+
+    zone_bucket& zone = zones[ch->activity.zone];
+    if (!IS_NPC(ch) && --zone.players == 0)
+        zone.awake_until = pulse + WAKE_PULSES;
+    unfile(ch);
+
+    if (running)
+        departed.insert(ch);
+}
+
+//============================================================================
+void run_pulse(void (*visit)(char_data*))
+{
+    ++pulse;
+    ++activity_totals.pulses;
+
+    batch.clear();
+    int awake_zones = 0;
+    for (zone_bucket& zone : zones) {
+        if (is_awake(zone)) {
+            ++awake_zones;
+            queue(zone.idle);
+            zone.next_visit = pulse + SLEEP_PULSES;
+        }
+        queue(zone.busy);
+    }
+    queue_sleeping_zones();
+
+    running = true;
+    departed.clear();
+    int visits = 0;
+    for (char_data* ch : batch) {
+        if (!departed.empty() && departed.count(ch))
+            continue;
+
+        visit(ch);
+        ++visits;
+
+        // It may have been killed or left the game.
+        if (!departed.empty() && departed.count(ch))
+            continue;
+        if (ch->activity.list != NOT_FILED) {
+            int list = is_busy(ch) ? BUSY : IDLE;
+            if (list != ch->activity.list) {
+                int zone_number = ch->activity.zone;
+                unfile(ch);
+                file(ch, zone_number, list);
+            }
+        }
+    }
+    running = false;
+
+    activity_totals.visits += visits;
+    activity_totals.last_visits = visits;
+    activity_totals.awake_zones = awake_zones;
+}
+}
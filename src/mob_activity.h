@@ -0,0 +1,50 @@
+/* mob_activity.h */
+// Decides which characters mobile_activity() visits on each pulse, so that
+// the cost of mobile AI follows the part of the world that players are in
+// rather than everything that is loaded.
+//
+// Characters in rooms are filed by zone, and within a zone as busy or idle.
+// Busy characters are visited every pulse: players, and mobiles that are
+// fighting, hunting, following someone, running a special procedure or
+// standing where there is something to scavenge.  Idle mobiles are visited
+// every pulse while their zone is awake, which is while players are in it
+// and for WAKE_PULSES pulses after the last one leaves.  In a sleeping zone
+// they are visited once every SLEEP_PULSES pulses, as many zones at a time
+// as mobile_activity_budget allows.
+
+#ifndef MOB_ACTIVITY_H
+#define MOB_ACTIVITY_H
+#pragma once
+
+struct char_data;
+
+namespace game_activity {
+// Must be called whenever a character is put into a room or taken out of
+// one, including when its in_room is changed behind char_to_room()'s back.
+void enter_room(char_data* ch);
+void leave_room(char_data* ch);
+
+// Calls 'visit' for every character due this pulse.  Characters that leave
+// the game during the pulse are skipped; those that move are still visited.
+// Visited characters are filed again as busy or idle afterwards.
+void run_pulse(void (*visit)(char_data*));
+
+const int WAKE_PULSES = 20;
+const int SLEEP_PULSES = 8;
+
+// Totals since boot, and the shape of the last pulse, for 'show stats'.
+struct activity_stats {
+    unsigned long pulses;
+    unsigned long visits; // characters visited
+    unsigned long sleeping_visits; // idle mobiles visited in sleeping zones
+    unsigned long deferred; // sleeping zone visits put off by the budget
+    int last_visits; // characters visited on the last pulse
+    int awake_zones; // zones awake on the last pulse
+    int filed; // characters filed now
+    int busy; // of which busy
+};
+
+extern activity_stats activity_totals;
+}
+
+#endif /* MOB_ACTIVITY_H */
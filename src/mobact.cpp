@@ -17,6 +17,8 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "mob_activity.h"
+#include "slab_pool.h"
 #include "structs.h"
 #include "utils.h"
 
@@ -44,22 +46,28 @@ int find_first_step(int, int);
 
 void enforce_position(struct char_data*, int);
 
-void mobile_activity(void)
+static void visit_character(struct char_data* ch)
 {
-    struct char_data* ch;
     SPECIAL(*tmpfunc);
 
-    for (ch = character_list; ch; ch = ch->next)
-        if (!number(0, 3)) {
-            if (IS_NPC(ch))
-                one_mobile_activity(ch);
-            else {
-                tmpfunc = (SPECIAL(*))
-                    virt_program_number(ch->specials.store_prog_number);
-                if (tmpfunc)
-                    tmpfunc(ch, ch, 0, "", SPECIAL_SELF, 0);
-            }
+    if (!number(0, 3)) {
+        if (IS_NPC(ch))
+            one_mobile_activity(ch);
+        else {
+            tmpfunc = (SPECIAL(*))
+                virt_program_number(ch->specials.store_prog_number);
+            if (tmpfunc)
+                tmpfunc(ch, ch, 0, "", SPECIAL_SELF, 0);
         }
+    }
+}
+
+/* Only the characters the activity scheduler finds due are visited: those
+ * in zones with players, those busy fighting, hunting and the like, and,
+ * now and then, the rest of the world. */
+void mobile_activity(void)
+{
+    game_activity::run_pulse(visit_character);
 }
 
 void one_mobile_activity(char_data* ch)
@@ -396,8 +404,6 @@ void one_mobile_activity(char_data* ch)
 }
 
 /* Mob Memory Routines */
-int memory_rec_counter = 0;
-struct memory_rec* memory_rec_pool = 0;
 struct memory_rec* memory_rec_active = 0;
 
 struct memory_rec*
@@ -405,13 +411,7 @@ get_from_memory_rec_pool()
 {
     struct memory_rec* afnew;
 
-    if (memory_rec_pool) {
-        afnew = memory_rec_pool;
-        memory_rec_pool = afnew->next;
-    } else {
-        CREATE(afnew, memory_rec, 1);
-        memory_rec_counter++;
-    }
+    afnew = game_memory::memory_pool.allocate();
     afnew->next = memory_rec_active;
     memory_rec_active = afnew;
 
@@ -432,9 +432,7 @@ void put_to_memory_rec_pool(struct memory_rec* oldaf)
             }
         }
     }
-    oldaf->next = memory_rec_pool;
-    oldaf->next_on_mob = 0;
-    memory_rec_pool = oldaf;
+    game_memory::memory_pool.release(oldaf);
 }
 
 /* make ch remember victim */
@@ -20,6 +20,7 @@
 #include "handler.h"
 #include "interpre.h"
 #include "mail.h"
+#include "name_index.h"
 #include "protos.h"
 #include "structs.h"
 #include "utils.h"
@@ -551,6 +552,7 @@ ACMD(do_string)
                 return;
             }
             ch->desc->str = &(mob->player.name);
+            game_index::loosen_char(mob);
             if (!IS_NPC(mob))
                 send_to_char("WARNING: You have changed the name of a player.\n\r", ch);
             break;
@@ -596,6 +598,7 @@ ACMD(do_string)
         switch (field) {
         case 1:
             ch->desc->str = &obj->name;
+            game_index::loosen_obj(obj);
             break;
         case 2:
             ch->desc->str = &obj->short_description;
@@ -0,0 +1,316 @@
+/* name_index.cpp */
+
+#include "name_index.h"
+
+#include "platdef.h"
+#include "structs.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <string>
+#include <unordered_map>
+
+// An entity's keywords, as they were when it was last filed.
+struct keyword_record {
+    unsigned long serial; // larger is nearer the head of the list
+    bool loose;
+    std::vector<std::string> keywords; // lower case, each once, in name order
+};
+
+namespace game_index {
+namespace {
+    // Keywords are filed under this many of their first letters, or the
+    // whole keyword if it is shorter.  isname() abbreviates only words of
+    // three or four letters, so every keyword a word can match shares its
+    // key.
+    const size_t KEY_LETTERS = 3;
+
+    bool is_letter(char letter)
+    {
+        return isalpha((unsigned char)letter) != 0;
+    }
+
+    char lower(char letter)
+    {
+        return (letter >= 'A' && letter <= 'Z') ? char(letter + ('a' - 'A')) : letter;
+    }
+
+    std::string key_of(const std::string& keyword)
+    {
+        return keyword.substr(0, KEY_LETTERS);
+    }
+
+    // The runs of letters in 'namelist', as isname() reads it.
+    void split(const char* namelist, std::vector<std::string>& keywords)
+    {
+        keywords.clear();
+        if (!namelist)
+            return;
+
+        for (const char* letter = namelist; *letter;) {
+            if (!is_letter(*letter)) {
+                ++letter;
+                continue;
+            }
+
+            std::string keyword;
+            for (; is_letter(*letter); ++letter)
+                keyword += lower(*letter);
+            if (std::find(keywords.begin(), keywords.end(), keyword) == keywords.end())
+                keywords.push_back(keyword);
+        }
+    }
+
+    class name_index {
+    public:
+        name_index()
+            : m_next_serial(1)
+            , m_searches(0)
+            , m_candidates(0)
+        {
+        }
+
+        void add(void* entity, keyword_record*& record, const char* namelist)
+        {
+            record = new keyword_record;
+            record->serial = m_next_serial++;
+            record->loose = false;
+            split(namelist, record->keywords);
+            post(entity, record);
+        }
+
+        void remove(keyword_record*& record)
+        {
+            if (!record)
+                return;
+            unpost(record);
+            delete record;
+            record = 0;
+        }
+
+        void rename(void* entity, keyword_record* record, const char* namelist)
+        {
+            if (!record)
+                return;
+            unpost(record);
+            record->loose = false;
+            split(namelist, record->keywords);
+            post(entity, record);
+        }
+
+        void loosen(void* entity, keyword_record* record)
+        {
+            if (!record || record->loose)
+                return;
+            unpost(record);
+            record->loose = true;
+            record->keywords.clear();
+            post(entity, record);
+        }
+
+        bool find(const char* word, std::vector<void*>& found)
+        {
+            found.clear();
+            if (!*word)
+                return false;
+
+            std::string keyword;
+            for (const char* letter = word; *letter; ++letter) {
+                if (!is_letter(*letter))
+                    return false;
+                keyword += lower(*letter);
+            }
+
+            static const postings none;
+            std::unordered_map<std::string, postings>::const_iterator bucket = m_buckets.find(key_of(keyword));
+            const postings& filed = bucket == m_buckets.end() ? none : bucket->second;
+
+            // Both are in list order from the tail; merge them from the head.
+            postings::const_reverse_iterator next_filed = filed.rbegin();
+            postings::const_reverse_iterator next_loose = m_loose.rbegin();
+            while (next_filed != filed.rend() || next_loose != m_loose.rend()) {
+                if (next_loose == m_loose.rend()
+                    || (next_filed != filed.rend() && next_filed->serial > next_loose->serial))
+                    found.push_back((next_filed++)->entity);
+                else
+                    found.push_back((next_loose++)->entity);
+            }
+
+            ++m_searches;
+            m_candidates += found.size();
+            return true;
+        }
+
+        name_index_stats stats() const
+        {
+            name_index_stats totals;
+            totals.keys = int(m_buckets.size());
+            totals.postings = 0;
+            for (const auto& bucket : m_buckets)
+                totals.postings += int(bucket.second.size());
+            totals.loose = int(m_loose.size());
+            totals.searches = m_searches;
+            totals.candidates = m_candidates;
+            return totals;
+        }
+
+    private:
+        struct posting {
+            unsigned long serial;
+            void* entity;
+        };
+        typedef std::vector<posting> postings; // by serial
+
+        static bool earlier(const posting& filed, unsigned long serial)
+        {
+            return filed.serial < serial;
+        }
+
+        static void insert(postings& list, void* entity, unsigned long serial)
+        {
+            posting added = { serial, entity };
+            list.insert(std::lower_bound(list.begin(), list.end(), serial, earlier), added);
+        }
+
+        static void erase(postings& list, unsigned long serial)
+        {
+            postings::iterator filed = std::lower_bound(list.begin(), list.end(), serial, earlier);
+            if (filed != list.end() && filed->serial == serial)
+                list.erase(filed);
+        }
+
+        // Calls 'file' once with each distinct key of the record.
+        template <class Filing>
+        static void each_key(const keyword_record* record, Filing file)
+        {
+            std::vector<std::string> keys;
+            for (const std::string& keyword : record->keywords) {
+                std::string key = key_of(keyword);
+                if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+                    keys.push_back(key);
+                    file(key);
+                }
+            }
+        }
+
+        void post(void* entity, const keyword_record* record)
+        {
+            if (record->loose) {
+                insert(m_loose, entity, record->serial);
+                return;
+            }
+            each_key(record, [&](const std::string& key) {
+                insert(m_buckets[key], entity, record->serial);
+            });
+        }
+
+        void unpost(const keyword_record* record)
+        {
+            if (record->loose) {
+                erase(m_loose, record->serial);
+                return;
+            }
+            each_key(record, [&](const std::string& key) {
+                std::unordered_map<std::string, postings>::iterator bucket = m_buckets.find(key);
+                if (bucket == m_buckets.end())
+                    return;
+                erase(bucket->second, record->serial);
+                if (bucket->second.empty())
+                    m_buckets.erase(bucket);
+            });
+        }
+
+        std::unordered_map<std::string, postings> m_buckets;
+        postings m_loose;
+        unsigned long m_next_serial;
+        unsigned long m_searches;
+        unsigned long m_candidates;
+    };
+
+    name_index characters;
+    name_index objects;
+
+    template <class T>
+    bool find_in(name_index& index, const char* word, std::vector<T*>& found)
+    {
+        static std::vector<void*> entities;
+        bool searched = index.find(word, entities);
+        found.clear();
+        for (void* entity : entities)
+            found.push_back(static_cast<T*>(entity));
+        return searched;
+    }
+}
+
+//============================================================================
+void add_char(char_data* ch)
+{
+    characters.add(ch, ch->name_keys, ch->player.name);
+}
+
+//============================================================================
+void remove_char(char_data* ch)
+{
+    characters.remove(ch->name_keys);
+}
+
+//============================================================================
+void add_obj(obj_data* obj)
+{
+    objects.add(obj, obj->name_keys, obj->name);
+}
+
+//============================================================================
+void remove_obj(obj_data* obj)
+{
+    objects.remove(obj->name_keys);
+}
+
+//============================================================================
+void rename_char(char_data* ch)
+{
+    characters.rename(ch, ch->name_keys, ch->player.name);
+}
+
+//============================================================================
+void rename_obj(obj_data* obj)
+{
+    objects.rename(obj, obj->name_keys, obj->name);
+}
+
+//============================================================================
+void loosen_char(char_data* ch)
+{
+    characters.loosen(ch, ch->name_keys);
+}
+
+//============================================================================
+void loosen_obj(obj_data* obj)
+{
+    objects.loosen(obj, obj->name_keys);
+}
+
+//============================================================================
+bool find_chars(const char* word, std::vector<char_data*>& found)
+{
+    return find_in(characters, word, found);
+}
+
+//============================================================================
+bool find_objs(const char* word, std::vector<obj_data*>& found)
+{
+    return find_in(objects, word, found);
+}
+
+//============================================================================
+name_index_stats char_name_stats()
+{
+    return characters.stats();
+}
+
+//============================================================================
+name_index_stats obj_name_stats()
+{
+    return objects.stats();
+}
+}
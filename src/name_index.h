@@ -0,0 +1,61 @@
+/* name_index.h */
+// Indexes character_list and object_list by the keywords in the names of
+// what is on them, so that get_char_vis(), get_obj_vis() and the other
+// world-wide searches look only at the entities that might answer to a
+// word instead of calling isname() on everything in the game.
+//
+// Each entity keeps its keywords lower cased and split up, and is filed
+// under the first letters of each.  A search returns the entities filed
+// under the word's first letters, in the order they stand on their list,
+// and the caller tests them just as it tested every entity before, so 'N.'
+// counting and visibility come out as they did.
+//
+// isname() treats a name as runs of letters, so only words made of letters
+// can be looked up.  For anything else find_chars() and find_objs() return
+// false and the caller walks the list as it used to.
+
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+#pragma once
+
+#include <vector>
+
+struct char_data;
+struct obj_data;
+
+namespace game_index {
+// Call as the entity goes onto the head of its list, once its name is set,
+// and as it comes off the list.
+void add_char(char_data* ch);
+void remove_char(char_data* ch);
+void add_obj(obj_data* obj);
+void remove_obj(obj_data* obj);
+
+// Call after the name of a listed entity has been replaced.
+void rename_char(char_data* ch);
+void rename_obj(obj_data* obj);
+
+// Call when a listed entity's name is handed to something that may change
+// it at any time, such as the string editor.  Until it is renamed again it
+// is offered for every word.
+void loosen_char(char_data* ch);
+void loosen_obj(obj_data* obj);
+
+// Fills 'found' with the entities that may answer to 'word', nearest the
+// head of their list first.  False if 'word' cannot be looked up.
+bool find_chars(const char* word, std::vector<char_data*>& found);
+bool find_objs(const char* word, std::vector<obj_data*>& found);
+
+struct name_index_stats {
+    int keys;
+    int postings;
+    int loose;
+    unsigned long searches;
+    unsigned long candidates; // offered by those searches
+};
+
+name_index_stats char_name_stats();
+name_index_stats obj_name_stats();
+}
+
+#endif /* NAME_INDEX_H */
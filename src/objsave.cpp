@@ -21,7 +21,9 @@
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "name_index.h"
 #include "pkill.h"
+#include "save_queue.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -131,6 +133,7 @@ FILE* Crash_get_file_by_name(char* name, char* mode)
 
     if (!Crash_get_filename(name, buf))
         return 0;
+    game_save::wait_for(buf);
     if (!(fp = fopen(buf, mode))) {
         log("crashsave: mark0");
         return 0;
@@ -146,6 +149,7 @@ int Crash_delete_file(char* name)
 
     if (!Crash_get_filename(name, filename))
         return 0;
+    game_save::wait_for(filename);
     if (!(fl = fopen(filename, "rb"))) {
         if (errno != ENOENT) { /* if it fails but NOT because of no file */
             sprintf(buf1, "SYSERR: deleting crash file %s (1)", filename);
@@ -174,6 +178,7 @@ int Crash_delete_crashfile(struct char_data* ch)
 
     if (!Crash_get_filename(GET_NAME(ch), fname))
         return 0;
+    game_save::wait_for(fname);
     if (!(fl = fopen(fname, "rb"))) {
         if (errno != ENOENT) { /* if it fails, NOT because of no file */
             sprintf(buf1, "SYSERR: checking for crash file %s (3)", fname);
@@ -200,6 +205,7 @@ int Crash_clean_file(char* name)
 
     if (!Crash_get_filename(name, fname))
         return 0;
+    game_save::wait_for(fname);
     /*
      * open for write so that permission problems will be flagged now,
      * at boot time.
@@ -557,6 +563,7 @@ void load_character(struct char_data* ch)
 
     ch->next = character_list;
     character_list = ch;
+    game_index::add_char(ch);
 
     char_to_room(ch, ch->specials2.load_room);
     act("$n has entered the game.", TRUE, ch, 0, 0, TO_ROOM);
@@ -720,10 +727,8 @@ void Crash_follower_save(struct char_data* ch, FILE* fp)
         for (x = 0; x < MAX_WEAR; x++)
             if (k->follower->equipment[x])
                 if (!Crash_is_unrentable(k->follower->equipment[x]))
-                    if (!Crash_save(k->follower->equipment[x], k->follower, x, fp)) {
-                        fclose(fp);
+                    if (!Crash_save(k->follower->equipment[x], k->follower, x, fp))
                         return;
-                    }
         if (fwrite(&dummy_object, sizeof(struct obj_file_elem), 1, fp) < 1) {
             perror("Writing dummy_object Crash_follower_save");
             return;
@@ -1084,14 +1089,16 @@ void Crash_calculate_rent(struct obj_data* obj, int* cost)
 
 void Crash_crashsave(struct char_data* ch, int rent_code)
 {
+    char fname[MAX_INPUT_LENGTH];
     struct rent_info rent;
     int j;
+    game_save::save_buffer save;
     FILE* fp;
 
     if (IS_NPC(ch))
         return;
 
-    if (!(fp = Crash_get_file_by_name(GET_NAME(ch), "wb"))) {
+    if (!Crash_get_filename(GET_NAME(ch), fname) || !(fp = save.file())) {
         log("Couldn't open save file.");
         return;
     }
@@ -1100,11 +1107,9 @@ void Crash_crashsave(struct char_data* ch, int rent_code)
     rent.time = time(0);
     if (!Crash_write_rentcode(ch, fp, &rent)) {
         log("crashsave: mark1");
-        fclose(fp);
         return;
     }
     if (!Crash_save(ch->carrying, ch, MAX_WEAR, fp)) {
-        fclose(fp);
         log("crashsave: mark2");
         return;
     }
@@ -1112,15 +1117,13 @@ void Crash_crashsave(struct char_data* ch, int rent_code)
 
     for (j = 0; j < MAX_WEAR; j++)
         if (ch->equipment[j]) {
-            if (!Crash_save(ch->equipment[j], ch, j, fp)) {
-                fclose(fp);
+            if (!Crash_save(ch->equipment[j], ch, j, fp))
                 return;
-            }
             Crash_restore_weight(ch->equipment[j]);
         }
     Crash_alias_save(ch, fp);
     Crash_follower_save(ch, fp);
-    fclose(fp);
+    save.commit(fname);
     REMOVE_BIT(PLR_FLAGS(ch), PLR_CRASH);
 }
 
@@ -1130,6 +1133,7 @@ void Crash_idlesave(struct char_data* ch)
     struct rent_info rent;
     int j;
     int cost;
+    game_save::save_buffer save;
     FILE* fp;
 
     if (IS_NPC(ch))
@@ -1137,7 +1141,7 @@ void Crash_idlesave(struct char_data* ch)
 
     if (!Crash_get_filename(GET_NAME(ch), buf))
         return;
-    if (!(fp = fopen(buf, "w+b")))
+    if (!(fp = save.file()))
         return;
 
     Crash_extract_norents(ch->carrying);
@@ -1152,24 +1156,18 @@ void Crash_idlesave(struct char_data* ch)
     rent.rentcode = RENT_TIMEDOUT;
     rent.time = time(0);
     rent.gold = GET_GOLD(ch);
-    if (!Crash_write_rentcode(ch, fp, &rent)) {
-        fclose(fp);
+    if (!Crash_write_rentcode(ch, fp, &rent))
         return;
-    }
 
-    if (!Crash_save(ch->carrying, ch, MAX_WEAR, fp)) {
-        fclose(fp);
+    if (!Crash_save(ch->carrying, ch, MAX_WEAR, fp))
         return;
-    }
     for (j = 0; j < MAX_WEAR; j++)
         if (ch->equipment[j]) {
-            if (!Crash_save(ch->equipment[j], ch, j, fp)) {
-                fclose(fp);
+            if (!Crash_save(ch->equipment[j], ch, j, fp))
                 return;
-            }
         }
     Crash_alias_save(ch, fp);
-    fclose(fp);
+    save.commit(buf);
 
     Crash_extract_objs(ch->carrying);
 }
@@ -1180,6 +1178,7 @@ void Crash_rentsave(struct char_data* ch, int cost)
     struct rent_info rent;
     struct obj_data* tmpobj;
     int j;
+    game_save::save_buffer save;
     FILE* fp;
 
     if (IS_NPC(ch))
@@ -1187,7 +1186,7 @@ void Crash_rentsave(struct char_data* ch, int cost)
 
     if (!Crash_get_filename(GET_NAME(ch), buf))
         return;
-    if (!(fp = fopen(buf, "w+b")))
+    if (!(fp = save.file()))
         return;
 
     Crash_extract_norents(ch->carrying);
@@ -1200,14 +1199,10 @@ void Crash_rentsave(struct char_data* ch, int cost)
     rent.rentcode = RENT_RENTED;
     rent.time = time(0);
     rent.gold = GET_GOLD(ch);
-    if (!Crash_write_rentcode(ch, fp, &rent)) {
-        fclose(fp);
+    if (!Crash_write_rentcode(ch, fp, &rent))
         return;
-    }
-    if (!Crash_save(ch->carrying, ch, MAX_WEAR, fp)) {
-        fclose(fp);
+    if (!Crash_save(ch->carrying, ch, MAX_WEAR, fp))
         return;
-    }
     for (j = 0; j < MAX_WEAR; j++)
         if (ch->equipment[j]) {
             tmpobj = unequip_char(ch, j);
@@ -1218,7 +1213,7 @@ void Crash_rentsave(struct char_data* ch, int cost)
     Crash_alias_save(ch, fp);
     Crash_follower_save(ch, fp);
     extract_followers(ch);
-    fclose(fp);
+    save.commit(buf);
 
     Crash_extract_objs(ch->carrying);
 }
@@ -1676,6 +1671,7 @@ void Crash_save_all(void)
 void Emergency_save(void)
 {
     struct descriptor_data* d;
+
     for (d = descriptor_list; d; d = d->next) {
         if ((d->connected == CON_PLYNG) && !IS_NPC(d->character)) {
             Crash_crashsave(d->character);
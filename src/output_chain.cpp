@@ -0,0 +1,70 @@
+/* output_chain.cpp */
+
+#include "output_chain.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+namespace game_net {
+output_segment_stats output_segments;
+
+namespace {
+    // Segments are shared by every connection; a chain only holds on to them
+    // between a write and the next flush.
+    output_segment* segment_pool = 0;
+
+    output_segment* get_segment()
+    {
+        output_segment* segment = segment_pool;
+        if (segment) {
+            segment_pool = segment->next;
+            --output_segments.pooled;
+        } else {
+            segment = (output_segment*)malloc(sizeof(output_segment));
+            ++output_segments.allocated;
+        }
+
+        segment->next = 0;
+        segment->used = 0;
+        return segment;
+    }
+}
+
+//============================================================================
+void output_chain::append(const char* text, int size)
+{
+    while (size > 0) {
+        if (!tail || tail->used == OUTPUT_SEGMENT_SIZE) {
+            output_segment* segment = get_segment();
+            if (tail)
+                tail->next = segment;
+            else
+                head = segment;
+            tail = segment;
+        }
+
+        int piece = std::min(size, OUTPUT_SEGMENT_SIZE - tail->used);
+        memcpy(tail->text + tail->used, text, piece);
+        tail->used += piece;
+        length += piece;
+        text += piece;
+        size -= piece;
+    }
+}
+
+//============================================================================
+void output_chain::clear()
+{
+    while (head) {
+        output_segment* segment = head;
+        head = segment->next;
+        segment->next = segment_pool;
+        segment_pool = segment;
+        ++output_segments.pooled;
+    }
+
+    tail = 0;
+    length = 0;
+}
+}
@@ -0,0 +1,45 @@
+/* output_chain.h */
+// Text composed for a connection before it is handed to the send queue.
+
+#ifndef OUTPUT_CHAIN_H
+#define OUTPUT_CHAIN_H
+#pragma once
+
+namespace game_net {
+const int OUTPUT_SEGMENT_SIZE = 1024;
+
+struct output_segment {
+    output_segment* next;
+    int used;
+    char text[OUTPUT_SEGMENT_SIZE];
+};
+
+// A chain of fixed-size segments.  Appending fills the tail segment and links
+// a new one when it runs out, so text already in the chain is never moved and
+// there is no upper bound on how much a single pass can produce.  Like
+// send_queue, this is plain data so a zero-filled descriptor is a valid,
+// empty chain.
+struct output_chain {
+    output_segment* head;
+    output_segment* tail;
+    int length; // total bytes in all segments
+
+    // Copies 'size' bytes onto the end of the chain.
+    void append(const char* text, int size);
+
+    // Returns every segment to the shared pool.
+    void clear();
+
+    bool is_empty() const { return length == 0; }
+};
+
+// Segment pool counters, for 'show stats'.
+struct output_segment_stats {
+    int allocated; // segments ever taken from the heap
+    int pooled; // segments waiting for reuse
+};
+
+extern output_segment_stats output_segments;
+}
+
+#endif /* OUTPUT_CHAIN_H */
@@ -0,0 +1,725 @@
+/* pathfind.cpp */
+
+#define TRACK_THROUGH_DOORS
+
+/*
+ * You can define or not define TRACK_THOUGH_DOORS, above, depending on
+ * whether or not you want track to find paths which lead through closed
+ * or hidden doors.
+ */
+
+#include "pathfind.h"
+
+#include "platdef.h"
+#include "structs.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <vector>
+
+extern int top_of_world;
+extern struct room_data world;
+
+namespace game_path {
+path_stats path_totals;
+
+namespace {
+    // Direct-mapped, so a busy hunter can only ever evict one other entry.
+    const int CACHE_SIZE = 4096;
+
+    struct cache_entry {
+        int src;
+        int target;
+        unsigned int epoch; // door_epoch the entry was computed under
+        int step; // direction, or BFS_NO_PATH
+    };
+
+    cache_entry step_cache[CACHE_SIZE];
+    unsigned int door_epoch = 1;
+    bool structure_stale = true;
+
+    // An exit seen from the room it leads to.
+    struct reverse_exit {
+        int from;
+        int dir;
+    };
+
+    // Per-room search state.  A room counts as visited by a search only if its
+    // mark equals that search's generation, so nothing needs clearing between
+    // searches.
+    struct room_state {
+        unsigned int forward_mark;
+        unsigned int backward_mark;
+        int forward_dist; // steps from the source
+        int backward_dist; // steps to the target
+        int forward_from; // previous room on the way from the source
+        int backward_to; // next room on the way to the target
+        signed char forward_dir; // exit of forward_from that leads here
+        signed char backward_dir; // exit of this room that leads to backward_to
+        unsigned int link_mark; // the same, for measuring portal distances
+        int link_dist;
+    };
+
+    struct open_node {
+        int estimate; // steps so far plus the zone heuristic
+        int dist;
+        int portal;
+
+        // Orders the heap so the smallest estimate comes out first, preferring
+        // the node furthest along on ties.
+        bool operator<(const open_node& other) const
+        {
+            if (estimate != other.estimate)
+                return estimate > other.estimate;
+            return dist < other.dist;
+        }
+    };
+
+    int room_count = 0;
+    unsigned int generation = 0;
+    std::vector<room_state> rooms;
+
+    // Every exit, indexed by destination: the exits into room r are
+    // reverse_exits[reverse_start[r] .. reverse_start[r + 1] - 1].
+    std::vector<int> reverse_start;
+    std::vector<reverse_exit> reverse_exits;
+
+    // Zones that some exit connects, in the same layout.
+    int zone_count = 0;
+    std::vector<int> zone_start;
+    std::vector<int> zone_links;
+    std::vector<int> zone_hops; // zone-graph distance to 'hops_target'
+    int hops_target = -1;
+
+    // Walking distance from one portal to another of the same zone, without
+    // leaving the zone.
+    struct portal_link {
+        int portal;
+        int dist;
+    };
+
+    // A room on either side of an exit that joins two zones.
+    struct portal {
+        int room;
+        int zone;
+        std::vector<portal_link> links;
+    };
+
+    // Per-portal state of a cross-zone search, marked like room_state.
+    struct portal_state {
+        unsigned int mark;
+        int dist; // steps from the source
+        int seed; // room next to the source zone that this route leaves by
+        unsigned int exit_mark;
+        int exit_dist; // steps from here to the target, within its zone
+    };
+
+    // Portals are grouped by zone: the portals of zone z are
+    // portals[zone_portal_start[z] .. zone_portal_start[z + 1] - 1].
+    std::vector<portal> portals;
+    std::vector<int> zone_portal_start;
+    std::vector<int> room_portal; // portal index of each room, or -1
+    std::vector<char> zone_stale; // portal distances need measuring again
+    std::vector<int> stale_zones;
+    std::vector<portal_state> portal_states;
+    unsigned int route_generation = 0;
+    unsigned int link_generation = 0;
+
+    // Reused between searches so that a search does not allocate once the
+    // buffers have grown to the size of the largest search so far.
+    std::vector<int> frontier;
+    std::vector<int> next_frontier;
+    std::vector<int> grown;
+    std::vector<int> link_frontier;
+    std::vector<open_node> open_list;
+    std::vector<int> path_rooms;
+    std::vector<int> path_dirs;
+
+    //========================================================================
+    bool is_blocked(int room)
+    {
+        return IS_SET(world[room].room_flags, NO_MOB | DEATH);
+    }
+
+    //========================================================================
+    // Returns the room that 'dir' leads to from 'room', or NOWHERE if there is
+    // no exit or it cannot be passed.
+    int passable_exit(int room, int dir)
+    {
+        room_direction_data* exit = world[room].dir_option[dir];
+        if (!exit || exit->to_room == NOWHERE)
+            return NOWHERE;
+
+#ifdef TRACK_THROUGH_DOORS
+        if (IS_SET(exit->exit_info, EX_LOCKED | EX_ISHIDDEN) && (IS_SET(exit->exit_info, EX_CLOSED) || !IS_SET(exit->exit_info, EX_ISDOOR)))
+            return NOWHERE;
+#else
+        if (IS_SET(exit->exit_info, EX_CLOSED))
+            return NOWHERE;
+#endif
+
+        return exit->to_room;
+    }
+
+    //========================================================================
+    int zone_of(int room)
+    {
+        int zone = world[room].zone;
+        return (zone >= 0 && zone < zone_count) ? zone : -1;
+    }
+
+    //========================================================================
+    // Rebuilds the reverse exit index and the zone graph.
+    void rebuild_structure()
+    {
+        room_count = top_of_world + 1;
+        rooms.assign(room_count, room_state());
+        generation = 0;
+
+        reverse_start.assign(room_count + 1, 0);
+        zone_count = 0;
+        for (int room = 0; room < room_count; ++room) {
+            zone_count = std::max(zone_count, world[room].zone + 1);
+            for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                room_direction_data* exit = world[room].dir_option[dir];
+                if (exit && exit->to_room >= 0 && exit->to_room < room_count)
+                    ++reverse_start[exit->to_room + 1];
+            }
+        }
+
+        for (int room = 0; room < room_count; ++room)
+            reverse_start[room + 1] += reverse_start[room];
+
+        std::vector<int> fill(reverse_start.begin(), reverse_start.end() - 1);
+        std::vector<std::pair<int, int> > borders;
+        reverse_exits.resize(reverse_start[room_count]);
+        for (int room = 0; room < room_count; ++room) {
+            for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                room_direction_data* exit = world[room].dir_option[dir];
+                if (!exit || exit->to_room < 0 || exit->to_room >= room_count)
+                    continue;
+
+                reverse_exit& entry = reverse_exits[fill[exit->to_room]++];
+                entry.from = room;
+                entry.dir = dir;
+
+                int from_zone = world[room].zone;
+                int to_zone = world[exit->to_room].zone;
+                if (from_zone != to_zone && from_zone >= 0 && to_zone >= 0) {
+                    borders.push_back(std::make_pair(from_zone, to_zone));
+                    borders.push_back(std::make_pair(to_zone, from_zone));
+                }
+            }
+        }
+
+        // The zone graph is undirected: that can only shorten zone distances,
+        // which keeps the heuristic a lower bound on the real path length.
+        std::sort(borders.begin(), borders.end());
+        borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+        zone_start.assign(zone_count + 1, 0);
+        zone_links.resize(borders.size());
+        for (size_t index = 0; index < borders.size(); ++index) {
+            ++zone_start[borders[index].first + 1];
+            zone_links[index] = borders[index].second;
+        }
+        for (int zone = 0; zone < zone_count; ++zone)
+            zone_start[zone + 1] += zone_start[zone];
+
+        // Portals, grouped by zone.
+        portals.clear();
+        room_portal.assign(room_count, -1);
+        zone_portal_start.assign(zone_count + 1, 0);
+        for (int room = 0; room < room_count; ++room) {
+            int zone = world[room].zone;
+            if (zone < 0 || is_blocked(room))
+                continue;
+
+            bool border = false;
+            for (int dir = 0; dir < NUM_OF_DIRS && !border; ++dir) {
+                room_direction_data* exit = world[room].dir_option[dir];
+                border = exit && exit->to_room >= 0 && exit->to_room < room_count
+                    && world[exit->to_room].zone != zone;
+            }
+            for (int entry = reverse_start[room]; entry < reverse_start[room + 1] && !border; ++entry)
+                border = world[reverse_exits[entry].from].zone != zone;
+
+            if (border) {
+                room_portal[room] = 1;
+                ++zone_portal_start[zone + 1];
+            }
+        }
+        for (int zone = 0; zone < zone_count; ++zone)
+            zone_portal_start[zone + 1] += zone_portal_start[zone];
+
+        fill.assign(zone_portal_start.begin(), zone_portal_start.end() - 1);
+        portals.resize(zone_portal_start[zone_count]);
+        for (int room = 0; room < room_count; ++room) {
+            if (room_portal[room] < 0)
+                continue;
+
+            int zone = world[room].zone;
+            int index = fill[zone]++;
+            portals[index].room = room;
+            portals[index].zone = zone;
+            room_portal[room] = index;
+        }
+
+        portal_states.assign(portals.size(), portal_state());
+        route_generation = 0;
+        zone_stale.assign(zone_count, 1);
+        stale_zones.clear();
+        for (int zone = 0; zone < zone_count; ++zone)
+            stale_zones.push_back(zone);
+
+        hops_target = -1;
+        structure_stale = false;
+    }
+
+    //========================================================================
+    // Measures the walking distance between every pair of portals in 'zone',
+    // taking the current state of its doors into account.
+    void measure_zone(int zone)
+    {
+        for (int index = zone_portal_start[zone]; index < zone_portal_start[zone + 1]; ++index) {
+            portal& from = portals[index];
+            from.links.clear();
+
+            if (++link_generation == 0) {
+                for (size_t room = 0; room < rooms.size(); ++room)
+                    rooms[room].link_mark = 0;
+                link_generation = 1;
+            }
+
+            rooms[from.room].link_mark = link_generation;
+            rooms[from.room].link_dist = 0;
+            link_frontier.assign(1, from.room);
+            for (size_t next_index = 0; next_index < link_frontier.size(); ++next_index) {
+                int room = link_frontier[next_index];
+                for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                    int next = passable_exit(room, dir);
+                    if (next == NOWHERE || rooms[next].link_mark == link_generation)
+                        continue;
+                    if (world[next].zone != zone || is_blocked(next))
+                        continue;
+
+                    rooms[next].link_mark = link_generation;
+                    rooms[next].link_dist = rooms[room].link_dist + 1;
+                    link_frontier.push_back(next);
+                    if (room_portal[next] >= 0) {
+                        portal_link link = { room_portal[next], rooms[next].link_dist };
+                        from.links.push_back(link);
+                    }
+                }
+            }
+        }
+
+        zone_stale[zone] = 0;
+        ++path_totals.zones_measured;
+    }
+
+    //========================================================================
+    void measure_stale_zones()
+    {
+        for (size_t index = 0; index < stale_zones.size(); ++index)
+            if (zone_stale[stale_zones[index]])
+                measure_zone(stale_zones[index]);
+        stale_zones.clear();
+    }
+
+    //========================================================================
+    unsigned int next_generation()
+    {
+        if (++generation == 0) {
+            rooms.assign(room_count, room_state());
+            generation = 1;
+        }
+        return generation;
+    }
+
+    //========================================================================
+    // Fills zone_hops with the number of zone borders between each zone and
+    // 'target_zone', or -1 for zones that cannot reach it at all.
+    void compute_zone_hops(int target_zone)
+    {
+        if (hops_target == target_zone)
+            return;
+
+        zone_hops.assign(zone_count, -1);
+        frontier.clear();
+        zone_hops[target_zone] = 0;
+        frontier.push_back(target_zone);
+        for (size_t index = 0; index < frontier.size(); ++index) {
+            int zone = frontier[index];
+            for (int link = zone_start[zone]; link < zone_start[zone + 1]; ++link) {
+                int next = zone_links[link];
+                if (zone_hops[next] < 0) {
+                    zone_hops[next] = zone_hops[zone] + 1;
+                    frontier.push_back(next);
+                }
+            }
+        }
+
+        hops_target = target_zone;
+    }
+
+    //========================================================================
+    // Appends the path from the source to 'room' using the forward links.
+    void trace_forward(int room)
+    {
+        size_t first = path_rooms.size();
+        while (rooms[room].forward_from != NOWHERE) {
+            path_rooms.push_back(rooms[room].forward_from);
+            path_dirs.push_back(rooms[room].forward_dir);
+            room = rooms[room].forward_from;
+        }
+        std::reverse(path_rooms.begin() + first, path_rooms.end());
+        std::reverse(path_dirs.begin() + first, path_dirs.end());
+    }
+
+    //========================================================================
+    // Appends the path from 'room' to the target using the backward links.
+    void trace_backward(int room)
+    {
+        while (rooms[room].backward_to != NOWHERE) {
+            path_rooms.push_back(room);
+            path_dirs.push_back(rooms[room].backward_dir);
+            room = rooms[room].backward_to;
+        }
+    }
+
+    //========================================================================
+    // Breadth-first search from both ends at once, expanding whichever side
+    // has the smaller frontier.  Used within a zone, where the zone heuristic
+    // has nothing to offer.  Returns true if a path was found.
+    bool search_bidirectional(int src, int target)
+    {
+        unsigned int mark = next_generation();
+        room_state& start = rooms[src];
+        start.forward_mark = mark;
+        start.forward_dist = 0;
+        start.forward_from = NOWHERE;
+        room_state& goal = rooms[target];
+        goal.backward_mark = mark;
+        goal.backward_dist = 0;
+        goal.backward_to = NOWHERE;
+
+        std::vector<int>& forward = frontier;
+        std::vector<int>& backward = next_frontier;
+        forward.assign(1, src);
+        backward.assign(1, target);
+
+        int meeting = NOWHERE;
+        int best = -1;
+        while (!forward.empty() && !backward.empty() && meeting == NOWHERE) {
+            // Expand one whole level, then take the shortest of any meetings
+            // it found; stopping at the first meeting could miss a shorter one.
+            grown.clear();
+            if (forward.size() <= backward.size()) {
+                for (size_t index = 0; index < forward.size(); ++index) {
+                    int room = forward[index];
+                    ++path_totals.rooms_expanded;
+                    for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                        int next = passable_exit(room, dir);
+                        if (next == NOWHERE || rooms[next].forward_mark == mark || is_blocked(next))
+                            continue;
+
+                        room_state& state = rooms[next];
+                        state.forward_mark = mark;
+                        state.forward_dist = rooms[room].forward_dist + 1;
+                        state.forward_from = room;
+                        state.forward_dir = dir;
+                        if (state.backward_mark == mark && (best < 0 || state.forward_dist + state.backward_dist < best)) {
+                            best = state.forward_dist + state.backward_dist;
+                            meeting = next;
+                        }
+                        grown.push_back(next);
+                    }
+                }
+                forward.swap(grown);
+            } else {
+                for (size_t index = 0; index < backward.size(); ++index) {
+                    int room = backward[index];
+                    ++path_totals.rooms_expanded;
+                    for (int entry = reverse_start[room]; entry < reverse_start[room + 1]; ++entry) {
+                        int previous = reverse_exits[entry].from;
+                        int dir = reverse_exits[entry].dir;
+                        if (rooms[previous].backward_mark == mark || passable_exit(previous, dir) != room)
+                            continue;
+                        if (previous != src && is_blocked(previous))
+                            continue;
+
+                        room_state& state = rooms[previous];
+                        state.backward_mark = mark;
+                        state.backward_dist = rooms[room].backward_dist + 1;
+                        state.backward_to = room;
+                        state.backward_dir = dir;
+                        if (state.forward_mark == mark && (best < 0 || state.forward_dist + state.backward_dist < best)) {
+                            best = state.forward_dist + state.backward_dist;
+                            meeting = previous;
+                        }
+                        grown.push_back(previous);
+                    }
+                }
+                backward.swap(grown);
+            }
+        }
+
+        if (meeting == NOWHERE)
+            return false;
+
+        trace_forward(meeting);
+        trace_backward(meeting);
+        return true;
+    }
+
+    //========================================================================
+    // Records that 'portal' can be reached in 'dist' steps by a route that
+    // leaves the source zone through 'seed', and queues it for expansion.
+    void reach_portal(int portal, int dist, int seed)
+    {
+        portal_state& state = portal_states[portal];
+        if (state.mark == route_generation && state.dist <= dist)
+            return;
+
+        int hops = zone_hops[portals[portal].zone];
+        if (hops < 0)
+            return; // no way from that zone to the target's
+
+        state.mark = route_generation;
+        state.dist = dist;
+        state.seed = seed;
+
+        open_node added = { dist + hops, dist, portal };
+        open_list.push_back(added);
+        std::push_heap(open_list.begin(), open_list.end());
+    }
+
+    //========================================================================
+    // Finds a path between two zones in three parts: a walk out of the source
+    // zone, an A* search over the routing table guided by the number of zone
+    // borders left to cross, and a walk into the target from the portals of
+    // its zone.  Each border costs at least one step and a step crosses at
+    // most one border, so the estimate never overshoots and the route found
+    // is a shortest one.  Returns true if a path was found; only the walk out
+    // of the source zone is traced.
+    bool search_routes(int src, int target)
+    {
+        int src_zone = zone_of(src);
+        int target_zone = zone_of(target);
+
+        compute_zone_hops(target_zone);
+        if (zone_hops[src_zone] < 0)
+            return false;
+
+        measure_stale_zones();
+
+        unsigned int mark = next_generation();
+        if (++route_generation == 0) {
+            portal_states.assign(portals.size(), portal_state());
+            route_generation = 1;
+        }
+
+        // Walk back from the target, staying in its zone, to find how far each
+        // of its portals is from it.
+        room_state& goal = rooms[target];
+        goal.backward_mark = mark;
+        goal.backward_dist = 0;
+        frontier.assign(1, target);
+        for (size_t index = 0; index < frontier.size(); ++index) {
+            int room = frontier[index];
+            ++path_totals.rooms_expanded;
+            if (room_portal[room] >= 0) {
+                portal_state& state = portal_states[room_portal[room]];
+                state.exit_mark = route_generation;
+                state.exit_dist = rooms[room].backward_dist;
+            }
+
+            for (int entry = reverse_start[room]; entry < reverse_start[room + 1]; ++entry) {
+                int previous = reverse_exits[entry].from;
+                if (rooms[previous].backward_mark == mark || world[previous].zone != target_zone)
+                    continue;
+                if (is_blocked(previous) || passable_exit(previous, reverse_exits[entry].dir) != room)
+                    continue;
+
+                rooms[previous].backward_mark = mark;
+                rooms[previous].backward_dist = rooms[room].backward_dist + 1;
+                frontier.push_back(previous);
+            }
+        }
+
+        // Walk out from the source, staying in its zone.  Every room just
+        // across its border is where a route starts.
+        open_list.clear();
+        room_state& start = rooms[src];
+        start.forward_mark = mark;
+        start.forward_dist = 0;
+        start.forward_from = NOWHERE;
+        frontier.assign(1, src);
+        for (size_t index = 0; index < frontier.size(); ++index) {
+            int room = frontier[index];
+            ++path_totals.rooms_expanded;
+            for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                int next = passable_exit(room, dir);
+                if (next == NOWHERE || rooms[next].forward_mark == mark || is_blocked(next))
+                    continue;
+
+                room_state& state = rooms[next];
+                state.forward_mark = mark;
+                state.forward_dist = rooms[room].forward_dist + 1;
+                state.forward_from = room;
+                state.forward_dir = dir;
+                if (world[next].zone == src_zone)
+                    frontier.push_back(next);
+                else if (room_portal[next] >= 0)
+                    reach_portal(room_portal[next], state.forward_dist, next);
+            }
+        }
+
+        int best = -1;
+        int best_seed = NOWHERE;
+        while (!open_list.empty()) {
+            std::pop_heap(open_list.begin(), open_list.end());
+            open_node node = open_list.back();
+            open_list.pop_back();
+
+            if (best >= 0 && node.estimate >= best)
+                break;
+
+            portal_state& state = portal_states[node.portal];
+            if (node.dist > state.dist)
+                continue; // superseded by a shorter route to the same portal
+
+            if (state.exit_mark == route_generation && (best < 0 || state.dist + state.exit_dist < best)) {
+                best = state.dist + state.exit_dist;
+                best_seed = state.seed;
+            }
+
+            ++path_totals.portals_expanded;
+            const portal& from = portals[node.portal];
+            if (zone_stale[from.zone])
+                measure_zone(from.zone);
+
+            for (size_t index = 0; index < from.links.size(); ++index)
+                reach_portal(from.links[index].portal, state.dist + from.links[index].dist, state.seed);
+
+            for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+                int next = passable_exit(from.room, dir);
+                if (next == NOWHERE || world[next].zone == from.zone || is_blocked(next))
+                    continue;
+                if (room_portal[next] >= 0)
+                    reach_portal(room_portal[next], state.dist + 1, state.seed);
+            }
+        }
+
+        if (best_seed == NOWHERE)
+            return false;
+
+        trace_forward(best_seed);
+        return true;
+    }
+
+    //========================================================================
+    // Makes every cached first step out of date.
+    void next_epoch()
+    {
+        if (++door_epoch == 0) {
+            std::fill(step_cache, step_cache + CACHE_SIZE, cache_entry());
+            door_epoch = 1;
+        }
+    }
+
+    //========================================================================
+    cache_entry& cache_slot(int src, int target)
+    {
+        unsigned int hash = unsigned(src) * 2654435761u ^ unsigned(target);
+        return step_cache[hash & (CACHE_SIZE - 1)];
+    }
+
+    //========================================================================
+    void remember(int src, int target, int step)
+    {
+        cache_entry& entry = cache_slot(src, target);
+        entry.src = src;
+        entry.target = target;
+        entry.epoch = door_epoch;
+        entry.step = step;
+    }
+}
+
+//============================================================================
+int first_step(int src, int target)
+{
+    if (src < 0 || src > top_of_world || target < 0 || target > top_of_world) {
+        log("Illegal value passed to find_first_step (graph.c)");
+        return BFS_ERROR;
+    }
+
+    if (src == target)
+        return BFS_ALREADY_THERE;
+
+    cache_entry& entry = cache_slot(src, target);
+    if (entry.epoch == door_epoch && entry.src == src && entry.target == target) {
+        ++path_totals.cache_hits;
+        return entry.step;
+    }
+
+    if (structure_stale || room_count != top_of_world + 1)
+        rebuild_structure();
+
+    ++path_totals.searches;
+
+    bool found = false;
+    path_rooms.clear();
+    path_dirs.clear();
+    if (!is_blocked(target)) {
+        int src_zone = zone_of(src);
+        int target_zone = zone_of(target);
+        if (src_zone == target_zone || src_zone < 0 || target_zone < 0)
+            found = search_bidirectional(src, target);
+        else
+            found = search_routes(src, target);
+    }
+
+    if (!found) {
+        remember(src, target, BFS_NO_PATH);
+        return BFS_NO_PATH;
+    }
+
+    // Every room on a shortest path has the rest of that path as its own
+    // shortest path, so a hunter following it finds each step traced here
+    // already cached.
+    for (size_t index = 0; index < path_rooms.size(); ++index)
+        remember(path_rooms[index], target, path_dirs[index]);
+
+    return path_dirs[0];
+}
+
+//============================================================================
+void doors_changed(const room_data& room)
+{
+    next_epoch();
+
+    // Until the table has been built there is nothing to measure again.
+    if (structure_stale || room.zone < 0 || room.zone >= zone_count)
+        return;
+
+    if (!zone_stale[room.zone]) {
+        zone_stale[room.zone] = 1;
+        stale_zones.push_back(room.zone);
+    }
+}
+
+//============================================================================
+void exits_changed()
+{
+    structure_stale = true;
+    next_epoch();
+}
+
+//============================================================================
+void build_routes()
+{
+    rebuild_structure();
+    measure_stale_zones();
+}
+}
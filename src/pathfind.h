@@ -0,0 +1,49 @@
+/* pathfind.h */
+// Shortest-path queries over the room graph, used by hunting mobiles and
+// tracking.  Search state lives here rather than in room_data, so a search
+// touches only the rooms it reaches and never has to clear the whole world.
+//
+// Searches that cross zones run over a routing table of portals, the rooms on
+// either side of an exit between two zones.  Walking distances between the
+// portals of each zone are kept in the table, so a long hunt costs a walk
+// within the source and target zones plus a search over portals.
+
+#ifndef PATHFIND_H
+#define PATHFIND_H
+#pragma once
+
+struct room_data;
+
+namespace game_path {
+// Returns the direction of the first step on a shortest path from real room
+// 'src' to real room 'target', or BFS_ERROR, BFS_ALREADY_THERE or
+// BFS_NO_PATH.  Rooms flagged NO_MOB or DEATH are never entered.
+int first_step(int src, int target);
+
+// Must be called whenever a door in 'room' is opened, closed, locked,
+// unlocked, broken or hidden, so that cached first steps through it are
+// forgotten and the walking distances of its zone are measured again.
+void doors_changed(const room_data& room);
+
+// Must be called whenever an exit is added, removed or pointed at a different
+// room, or a room is created or has its flags changed.  The routing table is
+// rebuilt on the next search.
+void exits_changed();
+
+// Builds the routing table for every zone.  Called once the world is loaded
+// and the zones have been reset, so that no search pays for it.
+void build_routes();
+
+// Totals since boot, for 'show stats'.
+struct path_stats {
+    unsigned long searches; // queries that needed a search
+    unsigned long cache_hits; // queries answered from the first-step cache
+    unsigned long rooms_expanded; // rooms whose exits were examined
+    unsigned long portals_expanded; // portals examined by cross-zone searches
+    unsigned long zones_measured; // zones whose portal distances were rebuilt
+};
+
+extern path_stats path_totals;
+}
+
+#endif /* PATHFIND_H */
@@ -19,6 +19,7 @@
 #include <string.h>
 #include <time.h>
 
+#include "combat_roster.h"
 #include "db.h"
 #include "handler.h"
 #include "pkill.h"
@@ -111,11 +112,9 @@ int pkill_expired(PKILL* p)
 int pkill_weight(struct char_data* victim)
 {
     int total_levels;
-    struct char_data* c;
-    extern struct char_data* combat_list;
 
     total_levels = 0;
-    for (c = combat_list; c != NULL; c = c->next_fighting)
+    for (char_data* c : combat_list)
         if (c->specials.fighting == victim)
             total_levels += GET_LEVEL(c);
 
@@ -160,11 +159,9 @@ int pkill_valid_killer(struct char_data* killer, struct char_data* victim)
 int pkill_opponents(struct char_data* victim)
 {
     int total_opponents;
-    struct char_data* c;
-    extern struct char_data* combat_list;
 
     total_opponents = 0;
-    for (c = combat_list; c != NULL; c = c->next_fighting)
+    for (char_data* c : combat_list)
         if (c->specials.fighting == victim && pkill_valid_killer(c, victim))
             ++total_opponents;
 
@@ -508,8 +505,6 @@ int pkill_update_pkill_tab(struct char_data* victim, int w, int n)
     int i, start;
     int points;
     time_t t;
-    struct char_data* c;
-    extern struct char_data* combat_list;
 
     /* Record where the list of new PKILL records start */
     start = pkill_tab_len;
@@ -519,7 +514,7 @@ int pkill_update_pkill_tab(struct char_data* victim, int w, int n)
 
     i = 0;
     t = time(0);
-    for (c = combat_list; c != NULL; c = c->next_fighting) {
+    for (char_data* c : combat_list) {
         if (c->specials.fighting == victim && pkill_valid_killer(c, victim)) {
             vmudlog(CMP, "Creating pkill: %s killed %s.",
                 GET_NAME(c), GET_NAME(victim));
@@ -0,0 +1,121 @@
+/* player_index.cpp */
+
+#include "player_index.h"
+
+#include "db.h"
+#include "utils.h"
+
+extern struct player_index_element* player_table;
+extern int top_of_p_table;
+
+namespace game_index {
+player_index players;
+
+//============================================================================
+void player_index::clear()
+{
+    m_names.clear();
+    m_idnums.clear();
+}
+
+//============================================================================
+std::string player_index::key(const char* name)
+{
+    std::string lowered(name);
+    for (size_t at = 0; at < lowered.size(); ++at)
+        lowered[at] = LOWER(lowered[at]);
+    return lowered;
+}
+
+//============================================================================
+void player_index::insert(int position)
+{
+    const player_index_element& entry = player_table[position];
+
+    if (entry.name && *entry.name) {
+        std::unordered_map<std::string, int>::iterator found = m_names.find(key(entry.name));
+        if (found == m_names.end())
+            m_names[key(entry.name)] = position;
+        else if (found->second > position)
+            found->second = position;
+    }
+
+    // Entries that have not been saved yet, and deleted ones, have idnum 0.
+    if (entry.idnum > 0) {
+        std::unordered_map<int, int>::iterator found = m_idnums.find(entry.idnum);
+        if (found == m_idnums.end())
+            m_idnums[entry.idnum] = position;
+        else if (found->second > position)
+            found->second = position;
+    }
+}
+
+//============================================================================
+void player_index::erase(int position)
+{
+    const player_index_element& entry = player_table[position];
+
+    if (entry.name && *entry.name) {
+        std::string name = key(entry.name);
+        std::unordered_map<std::string, int>::iterator found = m_names.find(name);
+        if (found != m_names.end() && found->second == position) {
+            m_names.erase(found);
+            rescan_name(name, position);
+        }
+    }
+
+    if (entry.idnum > 0) {
+        std::unordered_map<int, int>::iterator found = m_idnums.find(entry.idnum);
+        if (found != m_idnums.end() && found->second == position) {
+            m_idnums.erase(found);
+            rescan_idnum(entry.idnum, position);
+        }
+    }
+}
+
+//============================================================================
+// A duplicate name or idnum may be hiding behind the entry just erased.
+// Renames, deletions and first saves are rare enough that a scan is cheaper
+// than counting duplicates on every insert.
+void player_index::rescan_name(const std::string& name, int erased)
+{
+    for (int position = 0; position <= top_of_p_table; ++position) {
+        const char* other = player_table[position].name;
+        if (position != erased && other && *other && key(other) == name) {
+            m_names[name] = position;
+            return;
+        }
+    }
+}
+
+//============================================================================
+void player_index::rescan_idnum(int idnum, int erased)
+{
+    for (int position = 0; position <= top_of_p_table; ++position) {
+        if (position != erased && player_table[position].idnum == idnum) {
+            m_idnums[idnum] = position;
+            return;
+        }
+    }
+}
+
+//============================================================================
+int player_index::find_name(const char* name) const
+{
+    if (!name || !*name)
+        return -1;
+
+    std::unordered_map<std::string, int>::const_iterator found = m_names.find(key(name));
+    return found == m_names.end() ? -1 : found->second;
+}
+
+//============================================================================
+int player_index::find_idnum(int idnum) const
+{
+    if (idnum <= 0)
+        return -1;
+
+    std::unordered_map<int, int>::const_iterator found = m_idnums.find(idnum);
+    return found == m_idnums.end() ? -1 : found->second;
+}
+}
@@ -0,0 +1,46 @@
+/* player_index.h */
+// Indexes player_table by name and by idnum, so logins, finger, mail and
+// saves find a player without scanning every entry.
+
+#ifndef PLAYER_INDEX_H
+#define PLAYER_INDEX_H
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+namespace game_index {
+// Both maps hold the lowest position with a given key, which is the entry
+// the old linear scans stopped at.  Names are compared as str_cmp() does.
+class player_index {
+public:
+    void clear();
+
+    // Indexes player_table[position] under its current name and idnum.
+    void insert(int position);
+
+    // Forgets player_table[position].  Call it before the entry's name or
+    // idnum changes, then insert() it again afterwards.
+    void erase(int position);
+
+    // Returns the position of the named player, or -1.
+    int find_name(const char* name) const;
+
+    // Returns the position of the player with this idnum, or -1.
+    int find_idnum(int idnum) const;
+
+    int size() const { return int(m_names.size()); }
+
+private:
+    static std::string key(const char* name);
+    void rescan_name(const std::string& name, int erased);
+    void rescan_idnum(int idnum, int erased);
+
+    std::unordered_map<std::string, int> m_names;
+    std::unordered_map<int, int> m_idnums;
+};
+
+extern player_index players; // player_table
+}
+
+#endif /* PLAYER_INDEX_H */
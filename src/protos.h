@@ -172,6 +172,8 @@ struct info_script { //  The structure which each char/obj/zon will have if it h
     room_data* rm[3]; //  Variables
 };
 
+#define MAX_SCRIPT_TRIGGER 32 //  Trigger command types (see script.h) lie below this
+
 struct script_head { //  The header structure for a linked list of scripts - forms the index for scripts.
     int number; //  Real script number.
     char* name; //  Name of the script
@@ -179,6 +181,10 @@ struct script_head { //  The header structure for a linked list of scripts - for
     char* description; //  Description of what the script does.  ** Saved to script file **
     int* host; //  Whether the script is for char, obj or room _data - the structure calling the script
     struct script_data* script; //  The first command in the script
+    struct script_data* trigger[MAX_SCRIPT_TRIGGER]; //  First command of each trigger type, if any
+    unsigned int triggers; //  Bit (1 << type) set for each trigger type in the script
+    struct script_op* program; //  The script compiled for run_script, one op per command
+    int program_size; //  Number of ops in program
 };
 
 struct script_data {
@@ -189,6 +195,15 @@ struct script_data {
     int command_type; //  See script.h - type of command
     char* text; //  General text field - eg for do_say, send_to_room etc (also for comments)
     int param[6]; //  Parameters for command (if needed)  Refers to a char_script variable
+    int op; //  Position of the command's op in the compiled script
+};
+
+struct script_op { //  A command as run_script executes it - see compile_script (script.cc)
+    int opcode; //  The command's command_type
+    int next; //  Op that follows, -1 at the end of the script
+    int skip; //  Op an if goes to when it fails and an else jumps to, -1 to stop
+    signed char slot[6]; //  Each param decoded as a plain variable slot, -1 if it is something else
+    struct script_data* command; //  The command itself, for its text and literal params
 };
 
 struct shape_script {
@@ -18,6 +18,7 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "pathfind.h"
 #include "script.h"
 #include "spells.h"
 #include "structs.h"
@@ -608,6 +609,7 @@ ACMD(do_pick)
                 return;
             }
             REMOVE_BIT(EXIT(ch, door)->exit_info, EX_LOCKED);
+            game_path::doors_changed(world[ch->in_room]);
             if (EXIT(ch, door)->keyword)
                 act("$n skillfully picks the lock of the $F.", 0, ch, 0,
                     EXIT(ch, door)->keyword, TO_ROOM);
@@ -620,8 +622,10 @@ ACMD(do_pick)
              */
             if ((other_room = EXIT(ch, door)->to_room) != NOWHERE)
                 if ((back = world[other_room].dir_option[rev_dir[door]]) != NULL)
-                    if (back->to_room == ch->in_room)
+                    if (back->to_room == ch->in_room) {
                         REMOVE_BIT(back->exit_info, EX_LOCKED);
+                        game_path::doors_changed(world[other_room]);
+                    }
         }
 }
 
@@ -0,0 +1,173 @@
+/* reactor.cpp */
+
+#include "reactor.h"
+
+#include "structs.h"
+#include "utils.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+namespace game_net {
+//============================================================================
+reactor::reactor()
+    : m_epoll_fd(-1)
+    , m_timer_fd(-1)
+    , m_mother(0)
+    , m_new_connection(false)
+    , m_pulses_due(0)
+    , m_dropped_pulses(0)
+{
+}
+
+//============================================================================
+reactor::~reactor()
+{
+    close();
+}
+
+//============================================================================
+bool reactor::open(SocketType mother, long pulse_usec)
+{
+    m_mother = mother;
+
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll_fd < 0) {
+        perror("epoll_create1");
+        return false;
+    }
+
+    // The pulse timer runs on the monotonic clock, so it is not disturbed by
+    // the system clock being adjusted.
+    m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_timer_fd < 0) {
+        perror("timerfd_create");
+        return false;
+    }
+
+    itimerspec period;
+    period.it_interval.tv_sec = pulse_usec / 1000000;
+    period.it_interval.tv_nsec = (pulse_usec % 1000000) * 1000;
+    period.it_value = period.it_interval;
+    if (timerfd_settime(m_timer_fd, 0, &period, NULL) < 0) {
+        perror("timerfd_settime");
+        return false;
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &m_timer_fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_timer_fd, &event) < 0) {
+        perror("epoll_ctl timer");
+        return false;
+    }
+
+    // The mother socket stays level-triggered; we accept one connection per
+    // wake and rely on epoll to tell us there are more.
+    event.events = EPOLLIN;
+    event.data.ptr = &m_mother;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_mother, &event) < 0) {
+        perror("epoll_ctl mother");
+        return false;
+    }
+
+    return true;
+}
+
+//============================================================================
+void reactor::close()
+{
+    if (m_timer_fd >= 0) {
+        ::close(m_timer_fd);
+        m_timer_fd = -1;
+    }
+
+    if (m_epoll_fd >= 0) {
+        ::close(m_epoll_fd);
+        m_epoll_fd = -1;
+    }
+}
+
+//============================================================================
+bool reactor::watch(descriptor_data* d)
+{
+    epoll_event event;
+    // EPOLLOUT is edge-triggered as well, so it only fires when a full socket
+    // buffer drains and never keeps the loop spinning.
+    event.events = EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = d;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, d->descriptor, &event) < 0) {
+        perror("epoll_ctl add");
+        return false;
+    }
+
+    // Anything that arrived before we started watching would not produce an
+    // edge, so have the loop try a read straight away.
+    SET_BIT(d->dflags, DFLAG_INPUT_READY);
+    return true;
+}
+
+//============================================================================
+void reactor::unwatch(descriptor_data* d)
+{
+    if (d->descriptor <= 0)
+        return;
+
+    epoll_event event;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, d->descriptor, &event) < 0)
+        perror("epoll_ctl del");
+}
+
+//============================================================================
+bool reactor::wait()
+{
+    epoll_event events[MAX_EVENTS];
+
+    m_new_connection = false;
+
+    // Pulses that are already owed must not wait on the network.
+    int timeout = m_pulses_due > 0 ? 0 : -1;
+
+    int count = epoll_wait(m_epoll_fd, events, MAX_EVENTS, timeout);
+    if (count < 0) {
+        if (errno == EINTR)
+            return true;
+
+        perror("epoll_wait");
+        return false;
+    }
+
+    for (int index = 0; index < count; ++index) {
+        void* source = events[index].data.ptr;
+
+        if (source == &m_timer_fd) {
+            uint64_t expirations = 0;
+            if (read(m_timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                m_pulses_due += int(expirations);
+                if (m_pulses_due > MAX_PULSE_CATCHUP) {
+                    m_dropped_pulses += m_pulses_due - MAX_PULSE_CATCHUP;
+                    m_pulses_due = MAX_PULSE_CATCHUP;
+                }
+            }
+        } else if (source == &m_mother) {
+            m_new_connection = true;
+        } else {
+            descriptor_data* d = static_cast<descriptor_data*>(source);
+            if (events[index].events & (EPOLLERR | EPOLLHUP | EPOLLPRI))
+                SET_BIT(d->dflags, DFLAG_SOCKET_ERROR);
+
+            // A peer hang-up is reported as readable so that the read sees EOF.
+            if (events[index].events & (EPOLLIN | EPOLLRDHUP))
+                SET_BIT(d->dflags, DFLAG_INPUT_READY);
+
+            if (events[index].events & EPOLLOUT)
+                REMOVE_BIT(d->dflags, DFLAG_WRITE_BLOCKED);
+        }
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,62 @@
+/* reactor.h */
+// Event reactor for the game loop.  Wakes the loop when a socket becomes
+// readable or when the next pulse is due, whichever happens first.
+
+#ifndef REACTOR_H
+#define REACTOR_H
+#pragma once
+
+#include "platdef.h"
+
+struct descriptor_data;
+
+namespace game_net {
+class reactor {
+public:
+    reactor();
+    ~reactor();
+
+    // Creates the epoll instance and the pulse timer, and starts watching the
+    // mother socket.  Returns false if the kernel refused any of it.
+    bool open(SocketType mother, long pulse_usec);
+
+    // Releases the epoll instance and the pulse timer.
+    void close();
+
+    // Starts watching a connection.  Connections are edge-triggered, so the
+    // reader must drain the socket until it would block.
+    bool watch(descriptor_data* d);
+
+    // Stops watching a connection.  Must be called before the socket is closed.
+    void unwatch(descriptor_data* d);
+
+    // Blocks until a socket is ready or a pulse is due.  Readiness is recorded
+    // in the dflags of the affected descriptors.  Returns false on a fatal error.
+    bool wait();
+
+    // True if the mother socket has a connection waiting to be accepted.
+    bool has_new_connection() const { return m_new_connection; }
+
+    // True if at least one pulse is due.  Call consume_pulse() once it has run.
+    bool is_pulse_due() const { return m_pulses_due > 0; }
+    void consume_pulse() { --m_pulses_due; }
+
+    // Number of pulses that were skipped because the loop fell too far behind.
+    unsigned long get_dropped_pulses() const { return m_dropped_pulses; }
+
+private:
+    // Upper bound on pulses run back-to-back after a stall.  Anything beyond this
+    // is dropped so a long save or boot does not turn into a burst of zone resets.
+    static const int MAX_PULSE_CATCHUP = 4;
+    static const int MAX_EVENTS = 64;
+
+    int m_epoll_fd;
+    int m_timer_fd;
+    SocketType m_mother;
+    bool m_new_connection;
+    int m_pulses_due;
+    unsigned long m_dropped_pulses;
+};
+}
+
+#endif /* REACTOR_H */
@@ -0,0 +1,307 @@
+/* save_queue.cpp */
+
+#include "save_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <mutex>
+#include <pthread.h>
+#include <set>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace game_save {
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    struct save_job {
+        std::string path;
+        std::string stale_pattern;
+        char* data; // malloc'ed by open_memstream()
+        size_t length;
+        clock_type::time_point queued;
+    };
+
+    // Never destroyed either: the writer is still waiting on them at exit().
+    std::mutex& queue_lock = *new std::mutex;
+    std::condition_variable& work_ready = *new std::condition_variable;
+    std::condition_variable& work_done = *new std::condition_variable;
+    std::deque<save_job> queue; // guarded by queue_lock
+    std::unordered_map<std::string, int> pending; // path -> saves queued or being written
+    save_stats totals; // guarded by queue_lock
+    std::thread* writer = 0; // never destroyed, so exit() need not join it
+    bool stopping = false;
+    volatile sig_atomic_t faulted = 0; // set by enter_fault()
+
+    //========================================================================
+    std::string directory_of(const std::string& path)
+    {
+        std::string::size_type slash = path.rfind('/');
+        return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+    }
+
+    //========================================================================
+    bool write_all(int fd, const char* data, size_t length)
+    {
+        while (length > 0) {
+            ssize_t done = write(fd, data, length);
+            if (done < 0) {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += done;
+            length -= done;
+        }
+        return true;
+    }
+
+    //========================================================================
+    // Writes the save beside its target, under 'suffix', and renames it into
+    // place, then removes whatever older files it replaces.
+    bool write_save(const save_job& job, const char* suffix = ".tmp")
+    {
+        std::string temp = job.path + suffix;
+        int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) {
+            perror(temp.c_str());
+            return false;
+        }
+
+        bool written = write_all(fd, job.data, job.length) && fdatasync(fd) == 0;
+        if (close(fd) < 0)
+            written = false;
+        if (!written || rename(temp.c_str(), job.path.c_str()) < 0) {
+            perror(job.path.c_str());
+            unlink(temp.c_str());
+            return false;
+        }
+
+        if (!job.stale_pattern.empty()) {
+            glob_t stale;
+            if (glob(job.stale_pattern.c_str(), 0, 0, &stale) == 0) {
+                for (size_t file = 0; file < stale.gl_pathc; ++file)
+                    if (job.path != stale.gl_pathv[file])
+                        unlink(stale.gl_pathv[file]);
+            }
+            globfree(&stale);
+        }
+        return true;
+    }
+
+    //========================================================================
+    // Makes the renames in 'directories' durable.
+    void sync_directories(const std::set<std::string>& directories)
+    {
+        for (const std::string& directory : directories) {
+            int fd = open(directory.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                fsync(fd);
+                close(fd);
+            }
+        }
+    }
+
+    //========================================================================
+    void run_writer()
+    {
+        std::vector<save_job> batch;
+        std::set<std::string> directories;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> guard(queue_lock);
+                work_ready.wait(guard, [] { return !queue.empty() || stopping; });
+                if (queue.empty())
+                    return;
+
+                batch.assign(queue.begin(), queue.end());
+                queue.clear();
+            }
+
+            // Only the last save of each file in the batch needs writing.
+            std::unordered_map<std::string, size_t> last;
+            for (size_t job = 0; job < batch.size(); ++job)
+                last[batch[job].path] = job;
+
+            unsigned long written = 0, coalesced = 0, failed = 0;
+            unsigned long total_latency = 0, max_latency = 0;
+            directories.clear();
+            for (size_t job = 0; job < batch.size(); ++job) {
+                if (last[batch[job].path] != job) {
+                    ++coalesced;
+                    continue;
+                }
+                if (!write_save(batch[job])) {
+                    ++failed;
+                    continue;
+                }
+
+                ++written;
+                directories.insert(directory_of(batch[job].path));
+                clock_type::duration waited = clock_type::now() - batch[job].queued;
+                unsigned long latency = std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+                total_latency += latency;
+                if (latency > max_latency)
+                    max_latency = latency;
+            }
+            sync_directories(directories);
+
+            std::lock_guard<std::mutex> guard(queue_lock);
+            for (size_t job = 0; job < batch.size(); ++job) {
+                free(batch[job].data);
+                if (--pending[batch[job].path] == 0)
+                    pending.erase(batch[job].path);
+            }
+            totals.written += written;
+            totals.coalesced += coalesced;
+            totals.failed += failed;
+            totals.batches++;
+            totals.queue_depth -= int(batch.size());
+            totals.total_latency_us += total_latency;
+            if (max_latency > totals.max_latency_us)
+                totals.max_latency_us = max_latency;
+            batch.clear();
+            work_done.notify_all();
+        }
+    }
+
+    // The writer takes no signals.  The handlers in signals.cpp work on
+    // game state, so they must run on the game thread, and they may call
+    // into this file.
+    std::thread* start_writer()
+    {
+        sigset_t all, old;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &old);
+        std::thread* started = new std::thread(run_writer);
+        pthread_sigmask(SIG_SETMASK, &old, 0);
+        return started;
+    }
+}
+
+//============================================================================
+save_buffer::save_buffer()
+    : m_data(0)
+    , m_length(0)
+{
+    m_file = open_memstream(&m_data, &m_length);
+}
+
+//============================================================================
+save_buffer::~save_buffer()
+{
+    if (m_file)
+        fclose(m_file);
+    free(m_data);
+}
+
+//============================================================================
+void save_buffer::commit(const char* path, const char* stale_pattern)
+{
+    if (!m_file)
+        return;
+
+    save_job job;
+    job.path = path;
+    if (stale_pattern)
+        job.stale_pattern = stale_pattern;
+
+    fclose(m_file);
+    m_file = 0;
+    job.data = m_data;
+    job.length = m_length;
+    job.queued = clock_type::now();
+    m_data = 0;
+    m_length = 0;
+
+    std::unique_lock<std::mutex> guard(queue_lock, std::defer_lock);
+    if (!faulted) {
+        guard.lock();
+    } else if (!guard.try_lock()) {
+        // The writer may be at this file too, so keep off its temporary.
+        write_save(job, ".fault");
+        free(job.data);
+        return;
+    }
+
+    totals.queued++;
+    if (stopping) {
+        // Shutting down: write it now, after anything still queued.
+        work_done.wait(guard, [] { return pending.empty(); });
+        if (write_save(job))
+            totals.written++;
+        else
+            totals.failed++;
+        free(job.data);
+        return;
+    }
+
+    if (!writer)
+        writer = start_writer();
+    queue.push_back(job);
+    pending[job.path]++;
+    if (++totals.queue_depth > totals.max_queue_depth)
+        totals.max_queue_depth = totals.queue_depth;
+    work_ready.notify_one();
+}
+
+//============================================================================
+void wait_for(const char* path)
+{
+    std::unique_lock<std::mutex> guard(queue_lock);
+    std::string waiting(path);
+    work_done.wait(guard, [&waiting] { return pending.find(waiting) == pending.end(); });
+}
+
+//============================================================================
+void flush()
+{
+    std::unique_lock<std::mutex> guard(queue_lock);
+    work_done.wait(guard, [] { return pending.empty(); });
+}
+
+//============================================================================
+void stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(queue_lock);
+        stopping = true;
+        work_ready.notify_one();
+    }
+    if (writer && writer->joinable())
+        writer->join();
+}
+
+//============================================================================
+void enter_fault()
+{
+    faulted = 1;
+}
+
+//============================================================================
+void drain_after_fault()
+{
+    std::unique_lock<std::mutex> guard(queue_lock, std::try_to_lock);
+    if (!guard || !writer || writer->get_id() == std::this_thread::get_id())
+        return;
+    work_done.wait_for(guard, std::chrono::seconds(10), [] { return pending.empty(); });
+}
+
+//============================================================================
+save_stats stats()
+{
+    std::lock_guard<std::mutex> guard(queue_lock);
+    return totals;
+}
+}
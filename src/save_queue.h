@@ -0,0 +1,75 @@
+/* save_queue.h */
+// Write-behind saving of player and object files.  The game thread composes
+// each save in memory and queues it; a writer thread puts it on disk with a
+// temporary file and a rename, so a pulse never waits on the disk and a
+// crash never leaves half a file behind.
+
+#ifndef SAVE_QUEUE_H
+#define SAVE_QUEUE_H
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+namespace game_save {
+// A save being composed on the game thread.  Write to file() exactly as to
+// the real file, then commit() it.  A buffer that is never committed is
+// thrown away, so an error part way through leaves the old file in place.
+class save_buffer {
+public:
+    save_buffer();
+    ~save_buffer();
+
+    // Null if the memory stream could not be opened.
+    FILE* file() const { return m_file; }
+
+    // Queues the contents to replace 'path'.  Once they are written, every
+    // other file matching the glob 'stale_pattern' is removed.
+    void commit(const char* path, const char* stale_pattern = 0);
+
+private:
+    save_buffer(const save_buffer&);
+    save_buffer& operator=(const save_buffer&);
+
+    FILE* m_file;
+    char* m_data;
+    size_t m_length;
+};
+
+// Blocks until every queued save of 'path' is on disk.  Call it before
+// reading, moving or deleting a file that may have a save queued.
+void wait_for(const char* path);
+
+// Blocks until the queue is empty.
+void flush();
+
+// Flushes the queue and stops the writer thread.  Later commits are written
+// at once on the calling thread.
+void stop();
+
+// For the handler of a fatal signal, before it saves anything: from then
+// on commit() never waits for the queue's lock, since the thread that
+// faulted may hold it.  A save that cannot be queued is written at once.
+void enter_fault();
+
+// For the handler of a fatal signal, about to exit: gives the writer a
+// few seconds to finish the queue.  Returns at once if the queue is locked,
+// since the thread that faulted may hold the lock.
+void drain_after_fault();
+
+struct save_stats {
+    unsigned long queued;
+    unsigned long written;
+    unsigned long coalesced; // replaced by a later save of the same file before being written
+    unsigned long failed;
+    unsigned long batches; // each batch ends with one fsync() per directory
+    int queue_depth;
+    int max_queue_depth;
+    unsigned long total_latency_us; // from commit() to rename(), over 'written'
+    unsigned long max_latency_us;
+};
+
+save_stats stats();
+}
+
+#endif /* SAVE_QUEUE_H */
@@ -28,11 +28,13 @@
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "pathfind.h"
 #include "pkill.h"
 #include "protos.h"
 #include "script.h"
 #include "structs.h"
 #include "utils.h"
+#include "vnum_index.h"
 #include "zone.h"
 
 // External declarations
@@ -79,16 +81,7 @@ int trigger_object_damage(obj_data* obj, char_data* vict, char_data* ch);
 
 int find_script_by_number(const int number)
 {
-    int i;
-
-    for (i = 0; i <= top_of_script_table; i++)
-        if ((script_table + i)->number == number)
-            break;
-
-    if (i > top_of_script_table)
-        return -1;
-    else
-        return i;
+    return game_index::scripts.find(number);
 }
 
 void initialise_script_info_char(char_data* ch, int index)
@@ -586,15 +579,84 @@ script_data* char_has_script(int* return_index, const int script_no, const int s
     index = find_script_by_number(script_no);
     if (index == -1)
         return tmpscript;
-    for (tmpscript = script_table[index].script; tmpscript; tmpscript = tmpscript->next)
-        if (tmpscript->command_type == script_type)
-            break;
+    if ((script_type >= 0) && (script_type < MAX_SCRIPT_TRIGGER))
+        tmpscript = script_table[index].trigger[script_type];
+    else
+        for (tmpscript = script_table[index].script; tmpscript; tmpscript = tmpscript->next)
+            if (tmpscript->command_type == script_type)
+                break;
 
     *return_index = index;
 
     return tmpscript;
 }
 
+// A room's script_triggers is only trusted while its script_generation matches this.  Changing
+// any script moves it on, so that every room rebuilds its mask the next time it is asked.
+
+static int script_generation = 1;
+
+// Records the first command of each trigger type in a script, as char_has_script would find it
+
+static void index_script_triggers(script_head* head)
+{
+    script_data* tmpscript;
+    int type;
+
+    for (type = 0; type < MAX_SCRIPT_TRIGGER; type++)
+        head->trigger[type] = 0;
+    head->triggers = 0;
+
+    for (tmpscript = head->script; tmpscript; tmpscript = tmpscript->next) {
+        type = tmpscript->command_type;
+        if ((type >= ON_ENTER) && (type < MAX_SCRIPT_TRIGGER) && !head->trigger[type]) {
+            head->trigger[type] = tmpscript;
+            head->triggers |= 1u << type;
+        }
+    }
+
+    script_generation++;
+}
+
+static unsigned int script_triggers(int script_no)
+{
+    int index;
+
+    if (!script_no || ((index = find_script_by_number(script_no)) == -1))
+        return 0;
+    return script_table[index].triggers;
+}
+
+// Masks may hold triggers nobody in the room has any more, which only costs a scan; they must
+// never miss one.  So an arrival adds its triggers and a departure makes the room rebuild.
+
+void room_script_arrival(room_data* room, int script_number)
+{
+    if (room->script_generation == script_generation)
+        room->script_triggers |= script_triggers(script_number);
+}
+
+void room_script_departure(room_data* room)
+{
+    room->script_generation = 0;
+}
+
+static unsigned int room_triggers(room_data* room)
+{
+    char_data* tmpch;
+    obj_data* tmpobj;
+
+    if (room->script_generation != script_generation) {
+        room->script_triggers = 0;
+        for (tmpch = room->people; tmpch; tmpch = tmpch->next_in_room)
+            room->script_triggers |= script_triggers(tmpch->specials.script_number);
+        for (tmpobj = room->contents; tmpobj; tmpobj = tmpobj->next_content)
+            room->script_triggers |= script_triggers(tmpobj->obj_flags.script_number);
+        room->script_generation = script_generation;
+    }
+    return room->script_triggers;
+}
+
 // Central trigger function - all triggers call here first
 // returns 1 if program should continue as normal, 0 if not (eg on_die 0 == do not kill char)
 
@@ -669,6 +731,10 @@ int trigger_room_event(int trigger_type, room_data* room, char_data* ch)
     char_data* tmpch;
     obj_data* tmpobj;
 
+    // Most rooms have nobody and nothing with a script for this trigger
+    if ((trigger_type >= 0) && (trigger_type < MAX_SCRIPT_TRIGGER) && !(room_triggers(room) & (1u << trigger_type)))
+        return trigger_type == ON_ENTER ? trigger_room_enter(room, ch) : 1;
+
     switch (trigger_type) {
 
     case ON_BEFORE_ENTER:
@@ -697,14 +763,61 @@ int trigger_room_event(int trigger_type, room_data* room, char_data* ch)
     return return_value;
 }
 
-script_data* get_next_command(script_data* curr)
+// *******************************************************************************
+// ******************************* Compiled scripts ******************************
+// *******************************************************************************
+
+// Scripts are compiled when they are loaded or implemented into an array of ops, one per
+// command, which run_script steps through.  An op knows where execution goes next, both
+// normally and when an if fails or an else is reached, so nothing has to be searched for
+// while a script runs.  Params naming a plain variable (ch1, ob2, int3...) are decoded to
+// a slot so they are read straight out of the info_script.
+
+#define SLOT_CH 0 //  ch1-ch3 are slots 0-2
+#define SLOT_OB 3
+#define SLOT_RM 6
+#define SLOT_INT 9
+#define SLOT_STR 12
+
+static signed char param_slot(int param)
 {
+    switch (param) {
+    case SCRIPT_PARAM_CH1:
+    case SCRIPT_PARAM_CH2:
+    case SCRIPT_PARAM_CH3:
+        return SLOT_CH + param / 100 - 1;
+    case SCRIPT_PARAM_OB1:
+    case SCRIPT_PARAM_OB2:
+    case SCRIPT_PARAM_OB3:
+        return SLOT_OB + param / 100 - 4;
+    case SCRIPT_PARAM_RM1:
+    case SCRIPT_PARAM_RM2:
+    case SCRIPT_PARAM_RM3:
+        return SLOT_RM + param / 100 - 7;
+    case SCRIPT_PARAM_INT1:
+    case SCRIPT_PARAM_INT2:
+    case SCRIPT_PARAM_INT3:
+        return SLOT_INT + param - SCRIPT_PARAM_INT1;
+    case SCRIPT_PARAM_STR1:
+    case SCRIPT_PARAM_STR2:
+    case SCRIPT_PARAM_STR3:
+        return SLOT_STR + param - SCRIPT_PARAM_STR1;
+    default:
+        return -1;
+    }
+}
+
+// The command after the end of the block that curr begins, or after the end of the
+// block curr is in when curr is an else.  0 if the script ends first.
 
+static script_data* block_end(script_data* curr)
+{
     curr = curr->next;
     for (; (curr) && ((curr->command_type != SCRIPT_END) && (curr->command_type != SCRIPT_END_ELSE_BEGIN));
          curr = curr->next)
         if (curr->command_type == SCRIPT_BEGIN)
-            curr = get_next_command(curr);
+            if (!(curr = block_end(curr)))
+                return 0;
 
     if (curr)
         return curr->next;
@@ -712,6 +825,94 @@ script_data* get_next_command(script_data* curr)
         return 0;
 }
 
+// Where execution goes when an if fails or an else is reached: past the block that follows
+// the if, or past the single command that follows it.
+
+static script_data* skip_target(script_data* curr)
+{
+    switch (curr->command_type) {
+    case SCRIPT_IF_INT_EQUAL:
+    case SCRIPT_IF_INT_LESS:
+    case SCRIPT_IF_IS_NPC:
+    case SCRIPT_IF_STR_EQUAL:
+    case SCRIPT_IF_STR_CONTAINS:
+        if (!curr->next)
+            return 0;
+        if (curr->next->command_type == SCRIPT_BEGIN)
+            return block_end(curr->next);
+        return curr->next->next;
+
+    case SCRIPT_END_ELSE_BEGIN:
+        return block_end(curr);
+
+    default:
+        return 0;
+    }
+}
+
+void compile_script(script_head* head)
+{
+    script_data* tmpscript;
+    script_op* op;
+    int count, tmp;
+
+    if (head->program)
+        RELEASE(head->program);
+    head->program = 0;
+
+    count = 0;
+    for (tmpscript = head->script; tmpscript; tmpscript = tmpscript->next)
+        tmpscript->op = count++;
+    head->program_size = count;
+
+    if (count)
+        CREATE(head->program, script_op, count);
+
+    for (op = head->program, tmpscript = head->script; tmpscript; tmpscript = tmpscript->next, op++) {
+        op->opcode = tmpscript->command_type;
+        op->command = tmpscript;
+        op->next = tmpscript->next ? tmpscript->next->op : -1;
+        op->skip = skip_target(tmpscript) ? skip_target(tmpscript)->op : -1;
+        for (tmp = 0; tmp < 6; tmp++)
+            op->slot[tmp] = param_slot(tmpscript->param[tmp]);
+    }
+
+    index_script_triggers(head);
+}
+
+// Param readers for run_script - plain variables come straight from their slot, anything
+// else is worked out by the get_xxx_param functions as before.
+
+static inline char_data* op_char(script_op* op, int param, info_script* info)
+{
+    int slot = op->slot[param] - SLOT_CH;
+    return (slot >= 0 && slot < 3) ? info->ch[slot] : 0;
+}
+
+static inline obj_data* op_obj(script_op* op, int param, info_script* info)
+{
+    int slot = op->slot[param] - SLOT_OB;
+    return (slot >= 0 && slot < 3) ? info->ob[slot] : 0;
+}
+
+static inline room_data* op_room(script_op* op, int param, info_script* info)
+{
+    int slot = op->slot[param] - SLOT_RM;
+    return (slot >= 0 && slot < 3) ? info->rm[slot] : get_room_param(op->command->param[param], info);
+}
+
+static inline int* op_int(script_op* op, int param, info_script* info)
+{
+    int slot = op->slot[param] - SLOT_INT;
+    return (slot >= 0 && slot < 3) ? &info->ints[slot] : get_int_param(op->command->param[param], info);
+}
+
+static inline char* op_text(script_op* op, int param, info_script* info)
+{
+    int slot = op->slot[param] - SLOT_STR;
+    return (slot >= 0 && slot < 3) ? info->str[slot] : get_text_param(op->command->param[param], info);
+}
+
 int run_script(struct info_script* info, struct script_data* position)
 {
     char output[500];
@@ -722,6 +923,9 @@ int run_script(struct info_script* info, struct script_data* position)
     int* ptrint2;
     int* ptrint3;
     script_data* curr;
+    script_op* program;
+    script_op* op;
+    int pc;
     char** wtxt = NULL;
     char* txt1 = 0;
     char* txt2 = 0;
@@ -735,11 +939,14 @@ int run_script(struct info_script* info, struct script_data* position)
     int tmpint, tmpint2;
     struct follow_type *k, *next_fol;
 
-    curr = position;
-    if (!position)
+    program = script_table[info->index].program;
+    pc = position ? position->op : -1;
+    if (pc < 0)
         exit = TRUE;
     while (!exit) {
-        switch (curr->command_type) {
+        op = &program[pc];
+        curr = op->command;
+        switch (op->opcode) {
 
         case SCRIPT_ABORT:
             exit = TRUE;
@@ -747,10 +954,10 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_ASSIGN_EQ:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     tmpobj = tmpch->equipment[curr->param[2]];
-                ptrint = get_int_param(curr->param[3], info);
+                ptrint = op_int(op, 3, info);
 
                 // just in case somone puts something like obj1.vnum here...
                 if (!(ptrint == &info->ints[0] || ptrint == &info->ints[1] || ptrint == &info->ints[2]))
@@ -762,16 +969,16 @@ int run_script(struct info_script* info, struct script_data* position)
                 } else if (ptrint)
                     *ptrint = 0;
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_ASSIGN_INV:
             if (curr->param[0] && curr->param[1] && curr->param[2] && curr->param[3]) {
                 tmpobj = 0;
-                tmpch = get_char_param(curr->param[2], info);
+                tmpch = op_char(op, 2, info);
                 if (tmpch)
                     tmpobj = get_obj_in_list_num_containers(real_object(curr->param[0]), tmpch->carrying);
-                ptrint = get_int_param(curr->param[3], info);
+                ptrint = op_int(op, 3, info);
 
                 // just in case somone puts something like obj1.vnum here...
                 if (!(ptrint == &info->ints[0] || ptrint == &info->ints[1] || ptrint == &info->ints[2]))
@@ -783,16 +990,16 @@ int run_script(struct info_script* info, struct script_data* position)
                 } else if (ptrint)
                     *ptrint = 0;
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_ASSIGN_ROOM:
             if (curr->param[0] && curr->param[1] && curr->param[2] && curr->param[3]) {
                 tmpobj = 0;
-                tmprm = get_room_param(curr->param[2], info);
+                tmprm = op_room(op, 2, info);
                 if (tmprm)
                     tmpobj = get_obj_in_list_vnum(curr->param[0], tmprm->contents);
-                ptrint = get_int_param(curr->param[3], info);
+                ptrint = op_int(op, 3, info);
 
                 // just in case somone puts something like obj1.vnum here...
                 if (!(ptrint == &info->ints[0] || ptrint == &info->ints[1] || ptrint == &info->ints[2]))
@@ -804,7 +1011,7 @@ int run_script(struct info_script* info, struct script_data* position)
                 } else if (ptrint)
                     *ptrint = 0;
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_ASSIGN_STR:
@@ -813,57 +1020,60 @@ int run_script(struct info_script* info, struct script_data* position)
                 CREATE(*wtxt, char, strlen(curr->text) + 1);
                 sprintf(*wtxt, curr->text);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_BEGIN:
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_CHANGE_EXIT_TO:
             if (curr->param[0] && curr->param[2]) {
-                tmprm = get_room_param(curr->param[0], info);
+                tmprm = op_room(op, 0, info);
                 tmpint = real_room(curr->param[2]);
-                if (tmprm && (tmpint != NOWHERE) && (-1 < curr->param[1] < 6))
+                if (tmprm && (tmpint != NOWHERE) && (-1 < curr->param[1] < 6)
+                    && tmprm->dir_option[curr->param[1]]->to_room != tmpint) {
                     tmprm->dir_option[curr->param[1]]->to_room = tmpint;
+                    game_path::exits_changed();
+                }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_DROP:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
-                tmpobj = get_obj_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                tmpobj = op_obj(op, 1, info);
                 if (tmpch && tmpobj && (tmpobj->carried_by == tmpch))
                     perform_drop(tmpch, tmpobj, 0);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_EMOTE:
             if (curr->param[0] && curr->text) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     do_emote(tmpch, curr->text, 0, 36, 0);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_FLEE:
             if (curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     do_flee(tmpch, "", 0, 0, 0);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_FOLLOW:
             // tmpch is follower
             // tmpch2 is leader
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
-                tmpch2 = get_char_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                tmpch2 = op_char(op, 1, info);
                 if (tmpch && tmpch2) {
                     if (circle_follow(tmpch, tmpch2, FOLLOW_MOVE)) {
                         stop_follower(tmpch2, FOLLOW_MOVE);
@@ -871,26 +1081,26 @@ int run_script(struct info_script* info, struct script_data* position)
                     add_follower(tmpch, tmpch2, FOLLOW_MOVE);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_GIVE:
             if (curr->param[0] && curr->param[1] && curr->param[2]) {
-                tmpch = get_char_param(curr->param[0], info);
-                tmpch2 = get_char_param(curr->param[1], info);
-                tmpobj = get_obj_param(curr->param[2], info);
+                tmpch = op_char(op, 0, info);
+                tmpch2 = op_char(op, 1, info);
+                tmpobj = op_obj(op, 2, info);
                 if ((tmpch && tmpch2 && tmpobj) && (tmpobj->carried_by == tmpch))
                     perform_give(tmpch, tmpch2, tmpobj);
                 tmpobj = 0;
                 assign_obj_param(curr->param[2], info, tmpobj);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_HIT:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
-                tmpch2 = get_char_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                tmpch2 = op_char(op, 1, info);
                 if (tmpch && tmpch2) {
                     tmpwtl.targ1.type = TARGET_CHAR;
                     tmpwtl.targ1.ptr.ch = tmpch2;
@@ -900,35 +1110,35 @@ int run_script(struct info_script* info, struct script_data* position)
                     do_hit(tmpch, 0, &tmpwtl, CMD_HIT, SCMD_MURDER);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_REMOVE:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch && (-1 < curr->param[1] < MAX_WEAR))
                     if (tmpch->equipment[curr->param[1]])
                         perform_remove(tmpch, curr->param[1]);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_SAY:
             if (curr->text && curr->param[0]) {
-                txt1 = get_text_param(curr->param[1], info);
+                txt1 = op_text(op, 1, info);
                 sprintf(output, curr->text, txt1);
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     do_say(tmpch, output, 0, 0, 0);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_SOCIAL:
             if (curr->text && curr->param[0])
                 if ((tmpint = find_action(curr->text)) != -1) {
-                    tmpch = get_char_param(curr->param[0], info);
-                    tmpch2 = get_char_param(curr->param[1], info);
+                    tmpch = op_char(op, 0, info);
+                    tmpch2 = op_char(op, 1, info);
                     if ((tmpch2) && (tmpch2->in_room == tmpch->in_room)) {
                         tmpwtl.targ1.ptr.ch = tmpch2;
                         tmpwtl.targ1.type = TARGET_CHAR;
@@ -941,13 +1151,13 @@ int run_script(struct info_script* info, struct script_data* position)
                     tmpwtl.subcmd = tmpint;
                     do_action(tmpch, curr->text, &tmpwtl, 0, 0);
                 }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_WAIT:
             if ((curr->param[0]) && (info->ch[0]) && !(IS_SET(info->ch[0]->specials.affected_by, AFF_WAITING))) {
-                if (curr->next)
-                    info->next_command = curr->next;
+                if (op->next >= 0)
+                    info->next_command = program[op->next].command;
                 WAIT_STATE_BRIEF(info->ch[0], curr->param[0], CMD_SCRIPT, 0, 0, AFF_WAITING);
             }
             exit = TRUE;
@@ -955,37 +1165,37 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_DO_WEAR:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
-                tmpobj = get_obj_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                tmpobj = op_obj(op, 1, info);
                 tmpint = find_eq_pos(tmpch, tmpobj, 0);
                 if ((tmpint >= 0) && tmpch && tmpobj && (tmpobj->carried_by == tmpch) && (tmpch->equipment[tmpint] != tmpobj))
                     perform_wear(tmpch, tmpobj, tmpint);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_DO_YELL:
             if (curr->text && curr->param[0]) {
-                txt1 = get_text_param(curr->param[1], info);
+                txt1 = op_text(op, 1, info);
                 sprintf(output, curr->text, txt1);
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     do_gen_com(tmpch, output, 0, 0, SCMD_YELL);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_END:
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_END_ELSE_BEGIN:
-            curr = get_next_command(curr);
+            pc = op->skip;
             break;
 
         case SCRIPT_EQUIP_CHAR:
             if (curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch) {
                     for (tmpint = 1; tmpint < 6; tmpint++) {
                         if ((tmpint2 = real_object(curr->param[tmpint])) > 0) {
@@ -996,12 +1206,12 @@ int run_script(struct info_script* info, struct script_data* position)
                     do_wear(tmpch, "all", 0, 0, 0);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_EXTRACT_CHAR:
             if (curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch) {
                     if (IS_NPC(tmpch))
                         extract_char(tmpch);
@@ -1009,24 +1219,24 @@ int run_script(struct info_script* info, struct script_data* position)
                     assign_char_param(curr->param[0], info, tmpch);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_EXTRACT_OBJ:
             if (curr->param[0]) {
-                tmpobj = get_obj_param(curr->param[0], info);
+                tmpobj = op_obj(op, 0, info);
                 if (tmpobj)
                     extract_obj(tmpobj);
                 tmpobj = 0;
                 assign_obj_param(curr->param[0], info, tmpobj);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_GAIN_EXP:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
-                ptrint = get_int_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                ptrint = op_int(op, 1, info);
                 if (tmpch && ptrint)
                     if (!IS_NPC(tmpch)) {
                         int exp;
@@ -1039,27 +1249,20 @@ int run_script(struct info_script* info, struct script_data* position)
                         gain_exp(tmpch, exp);
                     }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_IF_INT_EQUAL:
             if (curr->param[0] && curr->param[1]) {
                 ptrint = 0;
                 ptrint2 = 0;
-                ptrint = get_int_param(curr->param[0], info);
-                ptrint2 = get_int_param(curr->param[1], info);
+                ptrint = op_int(op, 0, info);
+                ptrint2 = op_int(op, 1, info);
                 if (ptrint && ptrint2) {
                     if (*ptrint == *ptrint2) {
-                        curr = curr->next;
+                        pc = op->next;
                     } else {
-                        if (curr->next) {
-                            if (curr->next->command_type == SCRIPT_BEGIN) {
-                                curr = curr->next;
-                                curr = get_next_command(curr);
-                            } else
-                                curr = curr->next->next;
-                        } else
-                            exit = TRUE;
+                        pc = op->skip;
                     }
                 } else
                     exit = TRUE;
@@ -1071,20 +1274,13 @@ int run_script(struct info_script* info, struct script_data* position)
             if (curr->param[0] && curr->param[1]) {
                 ptrint = 0;
                 ptrint2 = 0;
-                ptrint = get_int_param(curr->param[0], info);
-                ptrint2 = get_int_param(curr->param[1], info);
+                ptrint = op_int(op, 0, info);
+                ptrint2 = op_int(op, 1, info);
                 if (ptrint && ptrint2) {
                     if (*ptrint < *ptrint2) {
-                        curr = curr->next;
+                        pc = op->next;
                     } else {
-                        if (curr->next) {
-                            if (curr->next->command_type == SCRIPT_BEGIN) {
-                                curr = curr->next;
-                                curr = get_next_command(curr);
-                            } else
-                                curr = curr->next->next;
-                        } else
-                            exit = TRUE;
+                        pc = op->skip;
                     }
                 } else
                     exit = TRUE;
@@ -1094,19 +1290,12 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_IF_IS_NPC:
             if (curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch) {
                     if (IS_NPC(tmpch)) {
-                        curr = curr->next;
+                        pc = op->next;
                     } else {
-                        if (curr->next) {
-                            if (curr->next->command_type == SCRIPT_BEGIN) {
-                                curr = curr->next;
-                                curr = get_next_command(curr);
-                            } else
-                                curr = curr->next->next;
-                        } else
-                            exit = TRUE;
+                        pc = op->skip;
                     }
                 } else
                     exit = TRUE;
@@ -1116,7 +1305,7 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_IF_STR_CONTAINS:
             if (curr->param[0]) {
-                txt1 = get_text_param(curr->param[0], info);
+                txt1 = op_text(op, 0, info);
                 if (txt1) {
                     // CREATE(txt2, char, strlen(txt1));
                     // strcpy(txt2, txt1);
@@ -1126,18 +1315,11 @@ int run_script(struct info_script* info, struct script_data* position)
                     if (strstr(txt2, curr->text)) {
                         RELEASE(txt2);
                         txt2 = 0;
-                        curr = curr->next;
+                        pc = op->next;
                     } else {
                         RELEASE(txt2);
                         txt2 = 0;
-                        if (curr->next) {
-                            if (curr->next->command_type == SCRIPT_BEGIN) {
-                                curr = curr->next;
-                                curr = get_next_command(curr);
-                            } else
-                                curr = curr->next->next;
-                        } else
-                            exit = TRUE;
+                        pc = op->skip;
                     }
                 } else
                     exit = TRUE;
@@ -1147,19 +1329,12 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_IF_STR_EQUAL:
             if (curr->param[0]) {
-                txt1 = get_text_param(curr->param[0], info);
+                txt1 = op_text(op, 0, info);
                 if (txt1) {
                     if (!strcasecmp(txt1, curr->text)) {
-                        curr = curr->next;
+                        pc = op->next;
                     } else {
-                        if (curr->next) {
-                            if (curr->next->command_type == SCRIPT_BEGIN) {
-                                curr = curr->next;
-                                curr = get_next_command(curr);
-                            } else
-                                curr = curr->next->next;
-                        } else
-                            exit = TRUE;
+                        pc = op->skip;
                     }
                 } else
                     exit = TRUE;
@@ -1173,7 +1348,7 @@ int run_script(struct info_script* info, struct script_data* position)
                 if (tmpch)
                     assign_char_param(curr->param[1], info, tmpch);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_LOAD_OBJ:
@@ -1182,70 +1357,70 @@ int run_script(struct info_script* info, struct script_data* position)
                 if (tmpobj)
                     assign_obj_param(curr->param[1], info, tmpobj);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_OBJ_FROM_CHAR:
             if (curr->param[0] && curr->param[1]) {
-                tmpobj = get_obj_param(curr->param[0], info);
-                tmpch = get_char_param(curr->param[1], info);
+                tmpobj = op_obj(op, 0, info);
+                tmpch = op_char(op, 1, info);
                 if (tmpobj && tmpch)
                     if (tmpobj->carried_by == tmpch)
                         obj_from_char(tmpobj);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_OBJ_FROM_ROOM:
             if (curr->param[0] && curr->param[1]) {
-                tmpobj = get_obj_param(curr->param[0], info);
-                tmprm = get_room_param(curr->param[1], info);
+                tmpobj = op_obj(op, 0, info);
+                tmprm = op_room(op, 1, info);
                 if (tmpobj && tmprm)
                     if ((tmpobj->in_room >= 0) ? world[tmpobj->in_room].number : 0 == tmprm->number)
                         obj_from_room(tmpobj);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_OBJ_TO_CHAR:
             if (curr->param[0] && curr->param[1]) {
-                tmpobj = get_obj_param(curr->param[0], info);
-                tmpch = get_char_param(curr->param[1], info);
+                tmpobj = op_obj(op, 0, info);
+                tmpch = op_char(op, 1, info);
                 if (tmpobj && tmpch)
                     obj_to_char(tmpobj, tmpch);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_OBJ_TO_ROOM:
             if (curr->param[0] && curr->param[1]) {
-                tmpobj = get_obj_param(curr->param[0], info);
-                tmprm = get_room_param(curr->param[1], info);
+                tmpobj = op_obj(op, 0, info);
+                tmprm = op_room(op, 1, info);
                 if (tmpobj && tmprm)
                     obj_to_room(tmpobj, real_room(tmprm->number));
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_PAGE_ZONE_MAP:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 for (tmpint = 0; (tmpint <= top_of_zone_table) && (zone_table[tmpint].number != curr->param[1]); tmpint++)
                     ;
                 if ((tmpch) && (tmpint <= top_of_zone_table))
                     send_to_char(zone_table[tmpint].map, tmpch);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         // Could possibly add attacktype to this to create different corpses...?
         case SCRIPT_RAW_KILL:
             if (curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
+                tmpch = op_char(op, 0, info);
                 if (tmpch)
                     raw_kill(tmpch, NULL, 0);
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_RETURN_FALSE:
@@ -1255,47 +1430,47 @@ int run_script(struct info_script* info, struct script_data* position)
 
         case SCRIPT_SEND_TO_CHAR:
             if (curr->text && curr->param[0]) {
-                tmpch = get_char_param(curr->param[0], info);
-                txt1 = get_text_param(curr->param[1], info);
+                tmpch = op_char(op, 0, info);
+                txt1 = op_text(op, 1, info);
                 sprintf(output, curr->text, txt1);
                 if (tmpch) {
                     send_to_char(output, tmpch);
                     send_to_char("\n", tmpch);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_SEND_TO_ROOM:
             if (curr->text && curr->param[0]) {
-                tmprm = get_room_param(curr->param[0], info);
-                txt1 = get_text_param(curr->param[1], info);
+                tmprm = op_room(op, 0, info);
+                txt1 = op_text(op, 1, info);
                 sprintf(output, curr->text, txt1);
                 if (tmprm) {
                     send_to_room(output, real_room(tmprm->number));
                     send_to_room("\n", real_room(tmprm->number));
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_SEND_TO_ROOM_X:
             if (curr->text && curr->param[0] && curr->param[1]) {
-                tmprm = get_room_param(curr->param[0], info);
-                tmpch = get_char_param(curr->param[1], info);
-                txt1 = get_text_param(curr->param[2], info);
+                tmprm = op_room(op, 0, info);
+                tmpch = op_char(op, 1, info);
+                txt1 = op_text(op, 2, info);
                 sprintf(output, curr->text, txt1);
                 if (tmprm && tmpch) {
                     send_to_room_except(output, real_room(tmprm->number), tmpch);
                     send_to_room_except("\n", real_room(tmprm->number), tmpch);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_SET_EXIT_STATE:
             if (curr->param[0]) {
-                tmprm = get_room_param(curr->param[2], info);
+                tmprm = op_room(op, 2, info);
                 if (set_exit_state(tmprm, curr->param[0], curr->param[1])) {
                     tmpint = tmprm->dir_option[curr->param[0]]->to_room;
                     tmprm2 = &world[tmpint];
@@ -1303,7 +1478,7 @@ int run_script(struct info_script* info, struct script_data* position)
                         set_exit_state(tmprm2, rev_dir[curr->param[0]], curr->param[1]);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         /* All binary integer operations int1 = f(int2, int3) */
@@ -1312,8 +1487,8 @@ int run_script(struct info_script* info, struct script_data* position)
         case SCRIPT_SET_INT_MULT:
         case SCRIPT_SET_INT_DIV:
         case SCRIPT_SET_INT_RANDOM:
-            ptrint2 = get_int_param(curr->param[1], info);
-            ptrint3 = get_int_param(curr->param[2], info);
+            ptrint2 = op_int(op, 1, info);
+            ptrint3 = op_int(op, 2, info);
             if (ptrint2 != NULL && ptrint3 != NULL) {
                 x = int_binary_op(info, curr->command_type, ptrint2, ptrint3);
                 set_int_value(info, curr->param[0], x);
@@ -1322,7 +1497,7 @@ int run_script(struct info_script* info, struct script_data* position)
                              "operation in script #%d, but only one given",
                     script_table[info->index].number);
 
-            curr = curr->next;
+            pc = op->next;
             break;
 
         /*
@@ -1333,7 +1508,7 @@ int run_script(struct info_script* info, struct script_data* position)
          */
         case SCRIPT_SET_INT_VALUE:
             set_int_value(info, curr->param[1], curr->param[0]);
-            curr = curr->next;
+            pc = op->next;
             break;
 
         /*
@@ -1343,12 +1518,12 @@ int run_script(struct info_script* info, struct script_data* position)
         case SCRIPT_SET_INT_WAR_STATUS:
             x = int_0ary_op(info, curr->command_type);
             set_int_value(info, curr->param[0], x);
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_TELEPORT_CHAR:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[1], info);
+                tmpch = op_char(op, 1, info);
                 tmpint = real_room(curr->param[0]);
                 if ((tmpch) && (tmpint > -1)) {
                     if (IS_RIDING(tmpch))
@@ -1366,12 +1541,12 @@ int run_script(struct info_script* info, struct script_data* position)
                     char_to_room(tmpch, tmpint);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         case SCRIPT_TELEPORT_CHAR_X:
             if (curr->param[0] && curr->param[1]) {
-                tmpch = get_char_param(curr->param[1], info);
+                tmpch = op_char(op, 1, info);
                 tmpint = real_room(curr->param[0]);
                 if ((tmpch) && (tmpint > -1)) {
                     if (IS_RIDING(tmpch))
@@ -1380,14 +1555,14 @@ int run_script(struct info_script* info, struct script_data* position)
                     char_to_room(tmpch, tmpint);
                 }
             }
-            curr = curr->next;
+            pc = op->next;
             break;
 
         default:
             exit = TRUE;
             break;
         }
-        if ((!curr) || (curr->command_type == SCRIPT_ABORT))
+        if ((pc < 0) || (program[pc].opcode == SCRIPT_ABORT))
             exit = TRUE;
     }
     return return_value;
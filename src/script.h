@@ -158,4 +158,11 @@ int find_script_by_number(int number);
 int call_trigger(int trigger_type, void* subject, void* subject2, void* subject3);
 void continue_char_script(char_data* ch);
 
+// Trigger index - each script keeps the first command of each trigger type, and each room
+//   keeps a mask of the trigger types its people and contents have scripts for.
+struct script_head;
+void compile_script(script_head* head); //  Call whenever the script's commands change
+void room_script_arrival(room_data* room, int script_number); //  Something with a script entered the room
+void room_script_departure(room_data* room); //  Something with a script left the room
+
 #endif /* SCRIPT_H */
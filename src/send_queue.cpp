@@ -0,0 +1,146 @@
+/* send_queue.cpp */
+
+#include "send_queue.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+namespace game_net {
+send_stats send_totals;
+
+namespace {
+    // Storage is never allocated smaller than this.
+    const int MIN_CAPACITY = 4096;
+
+    // An emptied queue keeps its storage for reuse unless it grew past this
+    // while a client was lagging.
+    const int KEEP_CAPACITY = 65536;
+
+    // Moves the queue into storage of at least 'needed' bytes, straightening
+    // the ring out on the way.
+    void grow(send_queue& queue, int needed)
+    {
+        int new_capacity = queue.capacity ? queue.capacity : MIN_CAPACITY;
+        while (new_capacity < needed)
+            new_capacity *= 2;
+
+        char* new_buffer = (char*)malloc(new_capacity);
+        if (queue.length) {
+            int first = std::min(queue.length, queue.capacity - queue.head);
+            memcpy(new_buffer, queue.buffer + queue.head, first);
+            memcpy(new_buffer + first, queue.buffer, queue.length - first);
+        }
+
+        free(queue.buffer);
+        queue.buffer = new_buffer;
+        queue.capacity = new_capacity;
+        queue.head = 0;
+    }
+}
+
+//============================================================================
+bool send_queue::append(const char* data, int size, int limit)
+{
+    if (size <= 0)
+        return true;
+
+    if (length + size > limit)
+        return false;
+
+    if (length + size > capacity)
+        grow(*this, length + size);
+
+    int tail = (head + length) % capacity;
+    int first = std::min(size, capacity - tail);
+    memcpy(buffer + tail, data, first);
+    memcpy(buffer, data + first, size - first);
+    commit(size);
+    return true;
+}
+
+//============================================================================
+char* send_queue::reserve(int minimum, int limit, int& size)
+{
+    int tail = capacity ? (head + length) % capacity : 0;
+
+    if (length == capacity)
+        size = 0;
+    else if (tail >= head)
+        size = capacity - tail;
+    else
+        size = head - tail;
+
+    if (size < minimum) {
+        if (length + minimum > limit)
+            return 0;
+
+        grow(*this, length + minimum);
+        tail = length;
+        size = capacity - length;
+    }
+
+    return buffer + tail;
+}
+
+//============================================================================
+void send_queue::commit(int size)
+{
+    length += size;
+
+    send_totals.bytes_queued += size;
+    send_totals.peak_queue = std::max(send_totals.peak_queue, length);
+}
+
+//============================================================================
+int send_queue::flush(SocketType socket)
+{
+    while (length > 0) {
+        iovec pieces[2];
+        int first = std::min(length, capacity - head);
+
+        pieces[0].iov_base = buffer + head;
+        pieces[0].iov_len = first;
+        pieces[1].iov_base = buffer;
+        pieces[1].iov_len = length - first;
+
+        ssize_t written = writev(socket, pieces, length > first ? 2 : 1);
+        ++send_totals.write_calls;
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                ++send_totals.stalls;
+                return length;
+            }
+
+            perror("Write to socket");
+            return -1;
+        }
+
+        send_totals.bytes_sent += written;
+        head = (head + written) % capacity;
+        length -= written;
+    }
+
+    head = 0;
+    if (capacity > KEEP_CAPACITY)
+        release();
+
+    return 0;
+}
+
+//============================================================================
+void send_queue::release()
+{
+    free(buffer);
+    buffer = 0;
+    capacity = 0;
+    head = 0;
+    length = 0;
+}
+}
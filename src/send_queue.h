@@ -0,0 +1,58 @@
+/* send_queue.h */
+// Per-connection queue of bytes waiting to be written to the socket.
+
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+#pragma once
+
+#include "platdef.h"
+
+namespace game_net {
+// A growable ring of bytes.  All members are plain data so that the queue
+// stays valid inside descriptor_data, which is allocated with CREATE()
+// and therefore starts out zero-filled rather than constructed.
+struct send_queue {
+    char* buffer; // circular storage, 'capacity' bytes long
+    int capacity;
+    int head; // offset of the first unsent byte
+    int length; // number of unsent bytes
+
+    // Copies 'size' bytes onto the end of the queue.  Returns false, and
+    // queues nothing, if the queue would grow beyond 'limit' bytes.
+    bool append(const char* data, int size, int limit);
+
+    // Returns the contiguous free space at the end of the queue so a caller
+    // can fill it in place, growing the storage first if there are fewer than
+    // 'minimum' bytes of it.  'size' is set to the space available.  Returns
+    // null if growing would take the queue beyond 'limit' bytes.
+    char* reserve(int minimum, int limit, int& size);
+
+    // Queues 'size' bytes that were written into the space from reserve().
+    void commit(int size);
+
+    // Writes as much as the socket will accept, using a single writev() for
+    // the (at most two) pieces of the ring.  Returns the number of bytes still
+    // queued, so anything above zero means the socket would block, or -1 if
+    // the socket failed.
+    int flush(SocketType socket);
+
+    // Drops anything queued and frees the storage.
+    void release();
+
+    bool is_empty() const { return length == 0; }
+};
+
+// Totals across every connection since boot.
+struct send_stats {
+    unsigned long bytes_queued;
+    unsigned long bytes_sent;
+    unsigned long write_calls;
+    unsigned long stalls; // flushes that left bytes behind
+    unsigned long overflows; // connections dropped for falling too far behind
+    int peak_queue; // most bytes ever waiting on a single connection
+};
+
+extern send_stats send_totals;
+}
+
+#endif /* SEND_QUEUE_H */
@@ -10,6 +10,7 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "pathfind.h"
 #include "protos.h"
 #include "spells.h"
 #include "structs.h"
@@ -150,6 +151,9 @@ int new_room(struct char_data* ch, int number)
     SHAPE_ROOM(ch)
         ->room->people
         = 0;
+    SHAPE_ROOM(ch)
+        ->room->people_tail
+        = 0;
     SHAPE_ROOM(ch)
         ->room->light
         = 0;
@@ -313,6 +317,7 @@ void implement_room(struct char_data* ch)
             }
         }
     }
+    game_path::exits_changed();
     send_to_char("Room implemented.\n\r", ch);
 }
 #undef SUBST
@@ -1297,6 +1302,9 @@ int load_room(struct char_data* ch, char* arg)
         SHAPE_ROOM(ch)
             ->room->people
             = 0;
+        SHAPE_ROOM(ch)
+            ->room->people_tail
+            = 0;
         SHAPE_ROOM(ch)
             ->room->light
             = 0;
@@ -561,6 +561,7 @@ void implement_script(struct char_data* ch)
         }
         last_command = newscript;
     }
+    compile_script(&script_table[SHAPE_SCRIPT(ch)->index_pos]);
 }
 
 void show_command(char_data* ch, script_data* script)
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "save_queue.h"
 #include "structs.h"
 #include "utils.h"
 
@@ -103,13 +104,18 @@ void unrestrict_game(int fake)
 
 void close_sockets(SocketType s);
 
+/*
+ * Nothing is saved here: the signal may have interrupted the game
+ * thread anywhere.  game_loop() notices at the end of its pass, saves
+ * everyone and shuts down the normal way, writing out the save queue.
+ */
 void hupsig(int fake)
 {
-    extern SocketType mother_desc;
-    log("Received SIGHUP, SIGINT, or SIGTERM.  Shutting down...");
-    Emergency_save();
-    close_sockets(mother_desc);
-    exit(0); /* something more elegant should perhaps be substituted */
+    extern int circle_shutdown;
+    extern volatile sig_atomic_t shutdown_signalled;
+
+    shutdown_signalled = 1;
+    circle_shutdown = 1;
 }
 
 void badcrash(int fake)
@@ -136,6 +142,8 @@ void logsig(int fake)
 void diesig(int fake)
 {
     // Try to save everyone.
+    game_save::enter_fault();
     Emergency_save();
+    game_save::drain_after_fault();
     exit(0);
 }
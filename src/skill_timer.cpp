@@ -3,7 +3,6 @@
 #include "comm.h"
 #include "structs.h"
 #include "utils.h"
-#include <vector>
 
 template <>
 game_timer::skill_timer* world_singleton<game_timer::skill_timer>::m_pInstance(0);
@@ -19,23 +18,18 @@ void skill_timer::add_skill_timer(const char_data& ch, const int skill_id, const
     }
 
     int player_id = utils::get_idnum(ch);
-    skill_data data;
-    data.player_id = player_id;
-    data.skill_id = skill_id;
-    data.counter = counter;
     vmudlog(CMP, "Skill cooldown set: char:[%s] skill:[%s] counter:[%d]", utils::get_name(ch), utils::get_skill_name(skill_id), counter);
-    m_skill_timer.push_back(data);
+    add_cooldown(player_id, skill_id, counter);
     add_global_cooldown(player_id);
 }
 
 int skill_timer::report_skill_status(int player_id, char* buffer)
 {
     char str[255];
-    for (int i = 0; i < m_skill_timer.size(); ++i) {
-        auto& data = m_skill_timer[i];
-
-        if (data.player_id == player_id && data.skill_id != GLOBAL_SKILL) {
-            sprintf(str, "%-30s %-3d (seconds)\n\r", utils::get_skill_name(data.skill_id), data.counter);
+    for (auto& cooldown : m_cooldowns) {
+        int skill_id = int(cooldown.first & 0xffffffff);
+        if (int(cooldown.first >> 32) == player_id && skill_id != GLOBAL_SKILL) {
+            sprintf(str, "%-30s %-3d (seconds)\n\r", utils::get_skill_name(skill_id), m_wheel.remaining(cooldown.second) - 1);
             sprintf(buffer, "%s%s", buffer, str);
         }
     }
@@ -44,25 +38,31 @@ int skill_timer::report_skill_status(int player_id, char* buffer)
 
 void skill_timer::update_skill_timer()
 {
-    for (int i = 0; i < m_skill_timer.size(); ++i) {
-        auto& data = m_skill_timer[i];
-        if (data.counter > 0) {
-            data.counter -= 1;
-        } else {
-            vmudlog(CMP, "Skill cooldown expired char:[%d] skill:[%d]", data.player_id, data.skill_id);
-            m_skill_timer.erase(m_skill_timer.begin() + i);
-        }
+    unsigned long long expired;
+    m_wheel.advance();
+    while (m_wheel.next_expired(expired)) {
+        vmudlog(CMP, "Skill cooldown expired char:[%d] skill:[%d]", int(expired >> 32), int(expired & 0xffffffff));
+        m_cooldowns.erase(expired);
     }
 }
 
+unsigned long long skill_timer::key(int player_id, int skill_id)
+{
+    return ((unsigned long long)(unsigned int)player_id << 32) | (unsigned int)skill_id;
+}
+
+void skill_timer::add_cooldown(int player_id, int skill_id, int counter)
+{
+    unsigned long long cooldown = key(player_id, skill_id);
+    timer_handle& expiry = m_cooldowns[cooldown];
+    m_wheel.cancel(expiry);
+    expiry = m_wheel.schedule(counter + 1, cooldown);
+}
+
 void skill_timer::add_global_cooldown(int ch_id)
 {
-    skill_data data;
-    data.player_id = ch_id;
-    data.skill_id = GLOBAL_SKILL;
-    data.counter = GLOBAL_COOLDOWN_COUNTER;
     vmudlog(CMP, "Skill cooldown set: char[%d] counter[%d]", ch_id, GLOBAL_COOLDOWN_COUNTER);
-    m_skill_timer.push_back(data);
+    add_cooldown(ch_id, GLOBAL_SKILL, GLOBAL_COOLDOWN_COUNTER);
 }
 
 bool skill_timer::is_skill_allowed(const char_data& ch, const int skill_id)
@@ -72,14 +72,6 @@ bool skill_timer::is_skill_allowed(const char_data& ch, const int skill_id)
     }
 
     int player_id = utils::get_idnum(ch);
-
-    for (int i = 0; i < m_skill_timer.size(); ++i) {
-        auto data = m_skill_timer[i];
-        if (data.player_id == player_id && (data.skill_id == skill_id || data.skill_id == GLOBAL_SKILL)) {
-            return false;
-        }
-    }
-
-    return true;
+    return !m_cooldowns.count(key(player_id, skill_id)) && !m_cooldowns.count(key(player_id, GLOBAL_SKILL));
 }
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "singleton.h"
-#include <vector>
+#include "timer_wheel.h"
+#include <unordered_map>
 
 struct char_data;
 
@@ -12,27 +13,26 @@ public:
     void add_skill_timer(const char_data& ch, const int skill_id, const int counter);
     // Returns true if the player and skill aren't on cooldown.
     bool is_skill_allowed(const char_data& ch, const int skill_id);
-    // Updates the skill timer list and removes any that have expired.
+    // Moves the cooldowns on a second and removes any that have expired.
     void update_skill_timer();
     // Reports all skills for a specific player and the time left on it.
     int report_skill_status(int player_id, char* buffer);
+    // Starts the cooldown of a skill for a player, restarting it if it is
+    // already running.
+    void add_cooldown(int player_id, int skill_id, int counter);
 
 private:
     friend class world_singleton<skill_timer>;
     const int GLOBAL_SKILL = -1;
     const int GLOBAL_COOLDOWN_COUNTER = 2;
-    struct skill_data {
-        int player_id;
-        int skill_id;
-        int counter;
-
-        skill_data()
-            : player_id(0)
-            , skill_id(0)
-            , counter(0) {};
-    };
-    std::vector<skill_data> m_skill_timer;
+    static unsigned long long key(int player_id, int skill_id);
     void add_global_cooldown(int ch_id);
+
+    // Cooldowns expire on a wheel that ticks once a second.  A cooldown set
+    // with a counter of n lasts n + 1 ticks, as it did when every entry was
+    // counted down each second and dropped once its counter reached 0.
+    timer_wheel m_wheel;
+    std::unordered_map<unsigned long long, timer_handle> m_cooldowns; // key() -> expiry
     skill_timer(const weather_data* weather, const room_data* world)
         : world_singleton<skill_timer>(weather, world) {};
 };
@@ -0,0 +1,116 @@
+/* slab_pool.cpp */
+
+#include "slab_pool.h"
+
+#include "platdef.h"
+#include "structs.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace game_memory {
+slab_pool<char_data> character_pool("characters");
+slab_pool<obj_data> object_pool("objects");
+slab_pool<affected_type> affect_pool("affects");
+slab_pool<follow_type> follower_pool("followers");
+slab_pool<memory_rec> memory_pool("mobile memories");
+
+namespace {
+    const int SLAB_BYTES = 64 * 1024;
+    const int MIN_PER_SLAB = 8;
+    const int ALIGNMENT = 16;
+
+    std::vector<const slab_pool_base*>& registry()
+    {
+        static std::vector<const slab_pool_base*> all_pools;
+        return all_pools;
+    }
+}
+
+//============================================================================
+slab_pool_base::slab_pool_base(const char* name, int object_size)
+    : m_name(name)
+    , m_free_list(0)
+{
+    // Every object must be able to hold the free list link, and stay
+    // aligned for anything the type may contain.
+    if (object_size < int(sizeof(free_object)))
+        object_size = sizeof(free_object);
+    m_object_size = (object_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    m_per_slab = SLAB_BYTES / m_object_size;
+    if (m_per_slab < MIN_PER_SLAB)
+        m_per_slab = MIN_PER_SLAB;
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_stats.name = m_name;
+    m_stats.object_size = object_size;
+
+    registry().push_back(this);
+}
+
+//============================================================================
+const std::vector<const slab_pool_base*>& slab_pool_base::pools()
+{
+    return registry();
+}
+
+//============================================================================
+pool_stats slab_pool_base::stats() const
+{
+    return m_stats;
+}
+
+//============================================================================
+void* slab_pool_base::allocate_raw()
+{
+    if (!m_free_list)
+        grow();
+
+    free_object* object = m_free_list;
+    m_free_list = object->next;
+    memset(object, 0, m_object_size);
+
+    --m_stats.free;
+    ++m_stats.allocations;
+    if (++m_stats.live > m_stats.peak)
+        m_stats.peak = m_stats.live;
+    return object;
+}
+
+//============================================================================
+void slab_pool_base::release_raw(void* object)
+{
+#ifndef NDEBUG
+    memset(object, POISON_BYTE, m_object_size);
+#endif
+
+    free_object* released = static_cast<free_object*>(object);
+    released->next = m_free_list;
+    m_free_list = released;
+
+    --m_stats.live;
+    ++m_stats.free;
+}
+
+//============================================================================
+// Adds a slab and puts its objects on the free list, first object first.
+void slab_pool_base::grow()
+{
+    char* slab = static_cast<char*>(malloc(size_t(m_object_size) * m_per_slab));
+    if (!slab) {
+        printf("slab_pool: could not allocate a slab of %d %s.\n", m_per_slab, m_name);
+        exit(0);
+    }
+
+    for (int index = m_per_slab - 1; index >= 0; --index) {
+        free_object* object = reinterpret_cast<free_object*>(slab + size_t(index) * m_object_size);
+        object->next = m_free_list;
+        m_free_list = object;
+    }
+
+    ++m_stats.slabs;
+    m_stats.free += m_per_slab;
+}
+}
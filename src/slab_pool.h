@@ -0,0 +1,93 @@
+/* slab_pool.h */
+// Typed allocators for the structures the game makes and throws away all
+// the time: characters, objects, affects, followers, mobile memories and
+// zone reset queue entries.
+//
+// Each pool carves objects of one type out of large slabs and keeps the
+// ones it is given back on a free list, so a zone reset does not go to the
+// heap once per mobile and object, and the heap is not left fragmented by
+// thousands of char_data and obj_data sized holes.  Memory handed out is
+// zeroed, as CREATE() would give it.  Slabs are never returned to the heap.
+//
+// Unless NDEBUG is defined, released objects are overwritten with
+// POISON_BYTE, so that anything still using one reads obvious garbage.
+
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+#pragma once
+
+#include <vector>
+
+struct affected_type;
+struct char_data;
+struct follow_type;
+struct memory_rec;
+struct obj_data;
+
+namespace game_memory {
+const unsigned char POISON_BYTE = 0x6b;
+
+// One pool's counters, for 'show memory'.
+struct pool_stats {
+    const char* name;
+    int object_size;
+    int live; // handed out now
+    int peak; // most handed out at once
+    int free; // released and kept for reuse
+    int slabs;
+    unsigned long allocations; // handed out since boot
+};
+
+class slab_pool_base {
+public:
+    pool_stats stats() const;
+
+    // Every pool, in the order they were constructed.
+    static const std::vector<const slab_pool_base*>& pools();
+
+protected:
+    slab_pool_base(const char* name, int object_size);
+
+    void* allocate_raw();
+    void release_raw(void* object);
+
+private:
+    struct free_object {
+        free_object* next;
+    };
+
+    void grow();
+
+    const char* m_name;
+    int m_object_size;
+    int m_per_slab;
+    free_object* m_free_list;
+    pool_stats m_stats;
+};
+
+template <class T>
+class slab_pool : public slab_pool_base {
+public:
+    explicit slab_pool(const char* name)
+        : slab_pool_base(name, sizeof(T))
+    {
+    }
+
+    T* allocate() { return static_cast<T*>(allocate_raw()); }
+
+    // Takes back an object this pool handed out.  Null is ignored.
+    void release(T* object)
+    {
+        if (object)
+            release_raw(object);
+    }
+};
+
+extern slab_pool<char_data> character_pool;
+extern slab_pool<obj_data> object_pool;
+extern slab_pool<affected_type> affect_pool;
+extern slab_pool<follow_type> follower_pool;
+extern slab_pool<memory_rec> memory_pool;
+}
+
+#endif /* SLAB_POOL_H */
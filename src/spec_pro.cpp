@@ -15,12 +15,16 @@
 #include <string.h>
 #include <vector>
 
+#include "combat_roster.h"
 #include "comm.h"
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
 #include "limits.h"
+#include "mob_activity.h"
+#include "pathfind.h"
 #include "profs.h"
+#include "script.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -39,7 +43,6 @@ extern int shoot_calculate_wait(const char_data* archer);
 extern byte language_number;
 extern byte language_skills[];
 extern struct char_data* character_list;
-extern struct char_data* combat_list;
 extern struct char_data* waiting_list; /* in db.cpp */
 extern struct command_info cmd_info[];
 extern struct descriptor_data* descriptor_list;
@@ -1311,30 +1314,41 @@ SPECIAL(ferry_captain)
 
     if (new_room != old_room) {
         /* nobody should be in that room, but just in case they are...*/
-        for (tmpch = world[old_room].people; tmpch; tmpch = tmpch->next_in_room) {
-            if (!tmpch->next_in_room)
-                break;
-        }
-        if (tmpch)
+        tmpch = world[old_room].people_tail;
+        if (tmpch) {
             tmpch->next_in_room = world[new_room].people;
-        else
+            if (world[new_room].people) {
+                world[new_room].people->prev_in_room = tmpch;
+                world[old_room].people_tail = world[new_room].people_tail;
+            }
+        } else {
             world[old_room].people = world[new_room].people;
+            world[old_room].people_tail = world[new_room].people_tail;
+        }
         for (tmpobj = world[old_room].contents; tmpobj;
              tmpobj = tmpobj->next_content)
             if (!tmpobj->next_content)
                 break;
-        if (tmpobj)
+        if (tmpobj) {
             tmpobj->next_content = world[new_room].contents;
-        else
+            if (world[new_room].contents)
+                world[new_room].contents->prev_content = tmpobj;
+        } else
             world[old_room].contents = world[new_room].contents;
 
         world[new_room].people = world[old_room].people;
+        world[new_room].people_tail = world[old_room].people_tail;
         world[old_room].people = 0;
+        world[old_room].people_tail = 0;
         world[new_room].contents = world[old_room].contents;
         world[old_room].contents = 0;
+        room_script_departure(&world[old_room]);
+        room_script_departure(&world[new_room]);
 
         for (tmpch = world[new_room].people; tmpch; tmpch = tmpch->next_in_room) {
+            game_activity::leave_room(tmpch);
             tmpch->in_room = new_room;
+            game_activity::enter_room(tmpch);
         }
         for (tmpobj = world[new_room].contents; tmpobj;
              tmpobj = tmpobj->next_content)
@@ -2570,10 +2584,12 @@ SPECIAL(vampire_huntress)
                     room = &world[victim->in_room];
                     SET_BIT(room->dir_option[0]->exit_info, EX_CLOSED);
                     SET_BIT(room->dir_option[0]->exit_info, EX_LOCKED);
+                    game_path::doors_changed(*room);
                     send_to_room("The iron door slams shut.\n\r\n", real_room(room->number));
                     room = &world[room->dir_option[0]->to_room];
                     SET_BIT(room->dir_option[2]->exit_info, EX_CLOSED);
                     SET_BIT(room->dir_option[2]->exit_info, EX_LOCKED);
+                    game_path::doors_changed(*room);
                     send_to_room("The iron door slams shut.\n\r\n", real_room(room->number));
                     do_look(victim, "", wtl, 0, 0);
                     WAIT_STATE_FULL(host, 200, 0, 0, 59, 0, 0, 0, AFF_WAITING, TARGET_NONE);
@@ -2626,7 +2642,7 @@ SPECIAL(vampire_huntress)
  */
 SPECIAL(thuringwethil)
 {
-    struct char_data *victim, *tmpch;
+    struct char_data* victim;
     obj_data* obj;
     int tmpno;
     waiting_type tmpwtl;
@@ -2639,9 +2655,9 @@ SPECIAL(thuringwethil)
         do_say(host, "Curse you all, I will remember this outrage!\n\r", 0, 0, 0);
         if (obj)
             act("$n hides her face from the glowing plate!", FALSE, host, 0, 0, TO_ROOM);
-        for (tmpch = combat_list; tmpch; tmpch = tmpch->next_fighting)
-            if ((tmpch->specials.fighting == host) && (!(IS_NPC(tmpch))))
-                add_exploit_record(EXPLOIT_ACHIEVEMENT, tmpch, 0, "Defeated the Pale Vampire");
+        for (char_data* fighter : combat_list)
+            if ((fighter->specials.fighting == host) && (!(IS_NPC(fighter))))
+                add_exploit_record(EXPLOIT_ACHIEVEMENT, fighter, 0, "Defeated the Pale Vampire");
         stop_fighting(host);
         act("$n seems to disappear, her clothing falls to the ground.", FALSE, host, 0, 0, TO_ROOM);
         extract_char(host);
@@ -2714,6 +2730,8 @@ SPECIAL(vampire_doorkeep)
             sprintf(buf, "The %s blurs for a second... then closes.\n\r", room->dir_option[2]->keyword);
             send_to_room(buf, real_room(15345));
             SET_BIT(room2->dir_option[0]->exit_info, EX_CLOSED);
+            game_path::doors_changed(*room);
+            game_path::doors_changed(*room2);
             sprintf(buf, "The %s blurs for a second... then closes.\n\r", room2->dir_option[0]->keyword);
             send_to_room(buf, real_room(15355));
         }
@@ -2723,6 +2741,8 @@ SPECIAL(vampire_doorkeep)
             sprintf(buf, "The %s blurs for a second... then opens..\n\r", room->dir_option[2]->keyword);
             send_to_room(buf, real_room(15345));
             REMOVE_BIT(room2->dir_option[0]->exit_info, EX_CLOSED);
+            game_path::doors_changed(*room);
+            game_path::doors_changed(*room2);
             sprintf(buf, "The %s blurs for a second... then opens.\n\r", room2->dir_option[0]->keyword);
             send_to_room(buf, real_room(15355));
         }
@@ -2913,7 +2933,7 @@ SPECIAL(wolf_summoner)
         char_to_room(wolf, host->in_room);
         add_follower(wolf, host, FOLLOW_MOVE);
         // make wolf a follower
-        if (host->specials.fighting) // always check you have a valid pointer.  Also host->next_fighting points to the next character on the fighting_list - not someone fighting them
+        if (host->specials.fighting) // always check you have a valid pointer.
             hit(wolf, host->specials.fighting, TYPE_UNDEFINED);
         // make wolf assist
     }
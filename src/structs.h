@@ -17,6 +17,8 @@
 
 #include "color.h" /* For MAX_COLOR_FIELDS */
 #include "platdef.h" /* For sh_int, ush_int, byte, etc. */
+#include "output_chain.h" /* For descriptor_data output */
+#include "send_queue.h" /* For descriptor_data output */
 
 #include <algorithm>
 #include <assert.h>
@@ -59,8 +61,6 @@ const int constexpr PULSE_MENTAL_FIGHT = 8;
 
 const int constexpr MAX_CHARACTERS = 64000;
 const int constexpr MAX_PCCHARACTERS = 32000;
-const int constexpr SMALL_BUFSIZE = 512;
-const int constexpr LARGE_BUFSIZE = 16384;
 const int constexpr MAX_STRING_LENGTH = 8192;
 const int constexpr MAX_INPUT_LENGTH = 255;
 const int constexpr MAX_MESSAGES = 255;
@@ -279,6 +279,7 @@ extern int global_release_flag;
 #endif
 
 struct char_data;
+struct keyword_record;
 struct obj_data;
 struct room_data;
 
@@ -491,7 +492,9 @@ public:
     struct obj_data* contains; /* Contains objects                 */
 
     struct obj_data* next_content; /* For 'contains' lists             */
+    struct obj_data* prev_content; /* Back link in the same list       */
     struct obj_data* next; /* For the object list              */
+    struct keyword_record* name_keys; /* filing in the object name index */
     int touched; /* Has a PC touched this object?    */
     int loaded_by; /* idnum of immortal who loaded the object (else 0) */
 };
@@ -614,20 +617,17 @@ struct room_bleed_data {
     }
 };
 
-struct room_data_extension {
-    room_data* extension_world;
-    //  int extension_length;  use EXTENSION_SIZE instead
-    room_data_extension* extension_next;
-
-    room_data_extension();
-    ~room_data_extension();
-};
+/*
+ * Rooms live in fixed-size pages, so world[] is two array lookups and a
+ * room never moves once it exists, even when OLC adds rooms.
+ */
+#define ROOM_PAGE_SHIFT 10
+#define ROOM_PAGE_SIZE (1 << ROOM_PAGE_SHIFT)
 
 struct room_data {
-    static room_data* BASE_WORLD;
-    static int BASE_LENGTH;
-    static int TOTAL_LENGTH;
-    static room_data_extension* BASE_EXTENSION;
+    static room_data** PAGES; /* page directory                       */
+    static int PAGE_COUNT;
+    static int TOTAL_LENGTH; /* slots in use, free ones included       */
 
     int number; /* Rooms number                       */
     int zone; /* Room zone (for resetting)          */
@@ -642,14 +642,14 @@ struct room_data {
     int alignment; /*changed*/
     byte light; /* Number of lightsources in room     */
 
-    byte bfs_dir;
-    room_data* bfs_next; /*instead ot bfs_queue structure, for hunting*/
-
     int (*funct)(struct char_data*, struct char_data*, int, char*,
         int, waiting_type*);
     /* special procedure, check SPECIAL in interpre.h      */
     struct obj_data* contents; /* List of items in room              */
     struct char_data* people; /* List of NPC / PC in room           */
+    struct char_data* people_tail; /* Last of people, for appending     */
+    unsigned int script_triggers; /* Trigger types people/contents have */
+    int script_generation; /* script_triggers is stale unless current */
 
     struct affected_type* affected; /* room affects */
 
@@ -657,11 +657,18 @@ struct room_data {
 
     room_data();
 
-    room_data& operator[](int i);
+    room_data& operator[](int i)
+    {
+        if (unsigned(i) >= unsigned(TOTAL_LENGTH))
+            return out_of_range(i);
+        return PAGES[i >> ROOM_PAGE_SHIFT][i & (ROOM_PAGE_SIZE - 1)];
+    }
+    room_data& out_of_range(int i); /* logs, and returns a safe room */
 
     int create_room(int zone); /* active constructor, returns real number  -
                                                            use this one to add rooms */
     void create_bulk(int amount); /* initial world constructor, the first alloc*/
+    void grow(int amount); /* adds free slots at the end of the world */
     void delete_room(); /* active destructor - use it when removing rooms */
     void create_exit(int dir, int room, char connect = 1);
 };
@@ -786,6 +793,8 @@ struct room_data {
 #define APPLY_SPELL_PEN 38
 #define APPLY_SPELL_POW 39
 
+#define MAX_APPLY 40 /* one past the highest APPLY_ location */
+
 #define ROOMAFF_SPELL 1
 #define ROOMAFF_EXIT 2
 
@@ -1668,6 +1677,27 @@ private:
     int pc_count;
 };
 
+/* The affects a character's equipment applies, collected by equip_char()
+   and unequip_char() so that affect_total() need not walk every slot.
+   Modifiers whose result does not depend on the order they are applied in
+   are summed per location; the rest are replayed slot by slot. */
+struct gear_affect_ledger {
+    struct obj_affected_type applied[MAX_WEAR][MAX_OBJ_AFFECT]; /* as worn */
+    long slot_bits[MAX_WEAR]; /* bitvector each worn item applies  */
+    int totals[MAX_APPLY]; /* summed order-free modifiers        */
+    long bits; /* union of slot_bits                 */
+    long worn_slots; /* slots that apply anything          */
+    long ordered_slots; /* slots with order-sensitive applies */
+};
+
+/* Where the mobile activity scheduler has filed a character in a room, see
+   mob_activity.h.  'list' is 0 while the character is not filed. */
+struct activity_entry {
+    int zone; /* zone whose lists hold the character */
+    int list; /* idle or busy                        */
+    int slot; /* position in that list              */
+};
+
 /* ================== Structure for player/non-player ===================== */
 struct char_data {
 public:
@@ -1726,13 +1756,18 @@ public:
                                                                                         pracs spent at logon */
     struct affected_type* affected; /* affected by what spells       */
     struct obj_data* equipment[MAX_WEAR]; /* Equipment array               */
+    byte light; /* Lit lights among the equipment */
+    struct gear_affect_ledger gear_affects; /* what the equipment applies */
+    struct activity_entry activity; /* filing in the mobile activity scheduler */
 
     struct obj_data* carrying; /* Head of list                  */
     struct descriptor_data* desc; /* NULL for mobiles              */
 
     struct char_data* next_in_room; /* For room->people - list         */
+    struct char_data* prev_in_room; /* Back link in room->people       */
     struct char_data* next; /* For either monster or ppl-list  */
-    struct char_data* next_fighting; /* For fighting list               */
+    struct keyword_record* name_keys; /* filing in the character name index */
+    int combat_slot; /* Place in combat_list, plus one  */
     struct char_data* next_fast_update; /* For fast-update list            */
 
     struct follow_type* followers; /* List of chars followers       */
@@ -1947,6 +1982,10 @@ struct txt_q {
 
 /* modes for flags */
 #define DFLAG_IS_SPAMMING 1
+#define DFLAG_INPUT_READY 2 /* socket may have unread input          */
+#define DFLAG_SOCKET_ERROR 4 /* socket reported an error or hang-up   */
+#define DFLAG_COMMAND_DONE 8 /* a command has run during this pulse   */
+#define DFLAG_WRITE_BLOCKED 16 /* socket buffer full, wait for EPOLLOUT */
 
 struct snoop_data {
     struct char_data* snooping; /* Who is this char snooping		*/
@@ -1976,13 +2015,10 @@ struct descriptor_data {
     int prompt_mode; /* control of prompt-printing		*/
     char buf[MAX_STRING_LENGTH]; /* buffer for raw input			*/
     char last_input[MAX_INPUT_LENGTH]; /* the last input			*/
-    char small_outbuf[SMALL_BUFSIZE]; /* standard output bufer		*/
-    char* output; /* ptr to the current output buffer	*/
-    int bufptr; /* ptr to end of current output		*/
-    int bufspace; /* space left in the output buffer	*/
+    game_net::output_chain output; /* text composed this pass          */
     unsigned char dflags; /* flags for this descriptor            */
     time_t last_input_time; /* time(0) of last_input               */
-    struct txt_block* large_outbuf; /* ptr to large buffer, if we need it */
+    game_net::send_queue output_queue; /* bytes waiting for the socket    */
     struct txt_q input; /* q of unprocessed input		*/
     struct char_data* character; /* linked to char			*/
     struct char_data* original; /* original char if switched		*/
@@ -0,0 +1,109 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../color.h"
+#include "../zone.h"
+#include "../act_template.h"
+#include "bench.h"
+
+#include <cstring>
+#include <vector>
+
+extern struct room_data world;
+extern struct zone_data* zone_table;
+
+void clear_char(struct char_data* ch, int mode);
+void convert_string(const char* str, int hide_invisible, struct char_data* ch,
+    struct obj_data* obj, void* vict_obj,
+    struct char_data* to, const char* buf);
+
+namespace {
+const int ONLOOKERS = 40;
+
+// Lines a busy fight or a crowded inn sends the whole room.
+const char* messages[] = {
+    "$n blocks $N's attack.",
+    "$n absorbs most of the impact of $N's attack with $s shield.",
+    "$CH$n hits $N very hard.",
+    "$n gets $p.",
+    "$n wields $o, and glances at $N.",
+    "$CS$n says, '$T'",
+};
+
+char_data* make_char(const char* name, int race, int color_fields)
+{
+    char_data* ch = new char_data;
+    clear_char(ch, 0);
+    ch->player.name = strdup(name);
+    ch->player.race = race;
+    ch->player.sex = 1 + race % 2;
+    ch->specials.position = POSITION_STANDING;
+    ch->in_room = 0;
+    ch->profs = new char_prof_data();
+    if (color_fields) {
+        SET_BIT(PRF_FLAGS(ch), PRF_COLOR);
+        for (int field = 0; field < MAX_COLOR_FIELDS; ++field)
+            ch->profs->colors[field] = (field + color_fields) % 8;
+    }
+    return ch;
+}
+
+obj_data* make_obj(const char* name, const char* short_description)
+{
+    obj_data* obj = new obj_data();
+    obj->name = strdup(name);
+    obj->short_description = strdup(short_description);
+    return obj;
+}
+}
+
+// Every pass renders one message for a room of 40 onlookers: men and
+// orcs, a few with colors of their own and one blinded.
+BENCHMARK(act_rendering)
+{
+    if (room_data::PAGES == 0)
+        world.create_bulk(1);
+    if (!zone_table)
+        CREATE(zone_table, zone_data, 1);
+    world[0].zone = 0;
+    world[0].light = 1;
+
+    static char_data* ch = make_char("Aldamir", RACE_HUMAN, 0);
+    static char_data* vict = make_char("Grishnakh", RACE_URUK, 0);
+    static obj_data* obj = make_obj("sword long", "a long sword");
+    static const char* said = "Hold the ford!";
+    static std::vector<char_data*> onlookers;
+    if (onlookers.empty()) {
+        for (int number = 0; number < ONLOOKERS; ++number) {
+            char_data* onlooker = make_char("Onlooker", number % 3 ? RACE_HUMAN : RACE_ORC, number % 5 ? 0 : 1 + number % 2);
+            if (number == 7)
+                SET_BIT(onlooker->specials.affected_by, AFF_BLIND);
+            onlookers.push_back(onlooker);
+        }
+    }
+
+    const int count = sizeof(messages) / sizeof(messages[0]);
+    auto vict_obj_of = [&](int message) -> void* {
+        return message == 3 ? (void*)obj : message == 5 ? (void*)said : (void*)vict;
+    };
+
+    static char legacy_line[MAX_STRING_LENGTH];
+    const long passes = 200000;
+
+    bench::report("act to a room, convert_string each", passes, [&](long pass) {
+        int message = pass % count;
+        long length = 0;
+        for (char_data* to : onlookers) {
+            convert_string(messages[message], FALSE, ch, obj, vict_obj_of(message), to, legacy_line);
+            length += legacy_line[0];
+        }
+        return length;
+    });
+    bench::report("act to a room, compiled template", passes, [&](long pass) {
+        int message = pass % count;
+        game_text::act_renderer renderer(game_text::compile(messages[message]), ch, obj, vict_obj_of(message));
+        long length = 0;
+        for (char_data* to : onlookers)
+            length += renderer.text_for(to)[0];
+        return length;
+    });
+}
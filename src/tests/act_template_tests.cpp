@@ -0,0 +1,175 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../color.h"
+#include "../zone.h"
+#include "../act_template.h"
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern struct room_data world;
+extern struct zone_data* zone_table;
+
+void clear_char(struct char_data* ch, int mode);
+void convert_string(const char* str, int hide_invisible, struct char_data* ch,
+    struct obj_data* obj, void* vict_obj,
+    struct char_data* to, const char* buf);
+
+namespace {
+char_data* make_char(const char* name, int race, int color_fields, bool npc)
+{
+    char_data* ch = new char_data;
+    clear_char(ch, 0);
+    ch->player.name = strdup(name);
+    ch->player.short_descr = strdup(name);
+    ch->player.race = race;
+    ch->player.sex = 1 + race % 2;
+    ch->specials.position = POSITION_STANDING;
+    ch->in_room = 0;
+    ch->profs = new char_prof_data();
+    if (npc)
+        SET_BIT(MOB_FLAGS(ch), MOB_ISNPC);
+    if (color_fields) {
+        SET_BIT(PRF_FLAGS(ch), PRF_COLOR);
+        for (int field = 0; field < MAX_COLOR_FIELDS; ++field)
+            ch->profs->colors[field] = (field + color_fields) % 8;
+    }
+    return ch;
+}
+
+void free_char(char_data* ch)
+{
+    free(ch->player.name);
+    free(ch->player.short_descr);
+    delete ch->profs;
+    delete ch;
+}
+
+// A lit room of onlookers, men and orcs, some with colors of their own and
+// one of them blinded, watching a man, an uruk and a long sword.
+class ActTemplate : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if (room_data::PAGES == 0)
+            world.create_bulk(1);
+        if (!zone_table)
+            CREATE(zone_table, zone_data, 1);
+        saved_room = world[0];
+        world[0].zone = 0;
+        world[0].light = 1;
+        world[0].room_flags = 0;
+        world[0].sector_type = SECT_INSIDE;
+
+        ch = make_char("Aldamir", RACE_HUMAN, 0, false);
+        vict = make_char("Grishnakh", RACE_URUK, 2, false);
+        obj = new obj_data();
+        obj->name = strdup("sword long");
+        obj->short_description = strdup("a long sword");
+
+        for (int number = 0; number < 30; ++number) {
+            char_data* onlooker = make_char("Onlooker", number % 3 ? RACE_HUMAN : RACE_ORC, number % 4 ? 0 : 1 + number % 3, false);
+            if (number == 7)
+                SET_BIT(onlooker->specials.affected_by, AFF_BLIND);
+            onlookers.push_back(onlooker);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (char_data* onlooker : onlookers)
+            free_char(onlooker);
+        free_char(ch);
+        free_char(vict);
+        free(obj->name);
+        free(obj->short_description);
+        delete obj;
+        world[0] = saved_room;
+    }
+
+    // How many onlookers an act_renderer sends a different line from the
+    // one convert_string() writes for them.  Both are given the same dice.
+    int differences(const char* format, void* vict_obj)
+    {
+        static char legacy_line[MAX_STRING_LENGTH];
+        game_text::act_renderer renderer(game_text::compile(format), ch, obj, vict_obj);
+
+        int different = 0;
+        for (size_t at = 0; at < onlookers.size(); ++at) {
+            char_data* to = onlookers[at];
+            std::srand(at);
+            convert_string(format, FALSE, ch, obj, vict_obj, to, legacy_line);
+            std::srand(at);
+            const char* line = renderer.text_for(to);
+            if (strcmp(legacy_line, line) != 0 && ++different <= 3)
+                ADD_FAILURE() << "'" << format << "' to onlooker " << at << ": '" << line << "', not '" << legacy_line << "'";
+        }
+        return different;
+    }
+
+    room_data saved_room;
+    char_data* ch;
+    char_data* vict;
+    obj_data* obj;
+    std::vector<char_data*> onlookers;
+};
+}
+
+TEST_F(ActTemplate, blind_onlookers_see_someone_and_something)
+{
+    EXPECT_EQ(differences("$n gets $p.", 0), 0);
+    EXPECT_EQ(differences("$n wields $o, and glances at $N.", vict), 0);
+    EXPECT_EQ(differences("$n absorbs most of the impact of $N's attack with $s shield.", vict), 0);
+}
+
+TEST_F(ActTemplate, onlookers_see_their_own_colors)
+{
+    EXPECT_EQ(differences("$CS$n says, '$T'", (void*)"Hold the ford!"), 0);
+    EXPECT_EQ(differences("$CH$n hits $N very hard.", vict), 0);
+    EXPECT_EQ(differences("$n $CDstumbles.", 0), 0);
+}
+
+// A color after a name is written once more after the code that follows
+// it, as convert_string() wrote it.
+TEST_F(ActTemplate, colors_after_names_are_clobbered_alike)
+{
+    EXPECT_EQ(differences("$n $CHhits $N.", vict), 0);
+    EXPECT_EQ(differences("$CH$n hits $N, and $CD$N bleeds on $p.", vict), 0);
+    EXPECT_EQ(differences("$K $CRnods to $N$CN.", vict), 0);
+}
+
+TEST_F(ActTemplate, enemies_are_shown_by_race)
+{
+    // Men and orcs, both with and without colors, watch an uruk.
+    std::swap(ch, vict);
+    EXPECT_EQ(differences("$n blocks $N's attack.", vict), 0);
+    EXPECT_EQ(differences("$CH$n hits $N very hard.", vict), 0);
+    std::swap(ch, vict);
+}
+
+// A mob may notice a player sneaking in only to send them a line of its
+// own, from inside CAN_SEE(), while the room's line is being rendered.
+TEST_F(ActTemplate, an_act_from_inside_can_see_leaves_the_line_alone)
+{
+    descriptor_data* desc = new descriptor_data();
+    ch->desc = desc;
+    ch->specials.hide_value = 1;
+    ch->specials2.hide_flags = HIDING_SNUCK_IN;
+    for (char_data* onlooker : onlookers)
+        SET_BIT(MOB_FLAGS(onlooker), MOB_ISNPC);
+
+    EXPECT_EQ(differences("$CH$n hits $N very hard.", vict), 0);
+    EXPECT_EQ(differences("$n wields $o, and glances at $N.", vict), 0);
+
+    std::string sent;
+    for (const game_net::output_segment* segment = desc->output.head; segment; segment = segment->next)
+        sent.append(segment->text, segment->used);
+    EXPECT_NE(sent.find("doesn't seem to notice"), std::string::npos);
+
+    desc->output.clear();
+    ch->desc = 0;
+    delete desc;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// A minimal timing harness for 'make benchmarks'.  Each BENCHMARK body runs
+// its loops through bench::report(), which prints the average cost of one
+// pass through the loop body.
+namespace bench {
+typedef void (*bench_function)();
+
+struct registrar {
+    registrar(const char* name, bench_function function);
+};
+
+// Results are folded into this so the optimizer cannot drop the loops.
+extern volatile long sink;
+
+template <class Body>
+void report(const char* label, long iterations, Body body)
+{
+    auto start = std::chrono::steady_clock::now();
+    long total = 0;
+    for (long pass = 0; pass < iterations; ++pass)
+        total += body(pass);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    sink += total;
+    double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("  %-44s %10.2f ns/op\n", label, nanoseconds / iterations);
+}
+}
+
+#define BENCHMARK(name)                                            \
+    static void name();                                            \
+    static bench::registrar name##_registrar(#name, name);         \
+    static void name()
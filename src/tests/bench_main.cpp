@@ -0,0 +1,40 @@
+#include "bench.h"
+
+#include <cstring>
+#include <vector>
+
+namespace bench {
+volatile long sink = 0;
+
+namespace {
+    struct entry {
+        const char* name;
+        bench_function function;
+    };
+
+    std::vector<entry>& registry()
+    {
+        static std::vector<entry> entries;
+        return entries;
+    }
+}
+
+registrar::registrar(const char* name, bench_function function)
+{
+    entry added = { name, function };
+    registry().push_back(added);
+}
+}
+
+// Runs every benchmark, or only those whose name contains the argument.
+int main(int argc, char* argv[])
+{
+    for (const bench::entry& entry : bench::registry()) {
+        if (argc > 1 && !std::strstr(entry.name, argv[1]))
+            continue;
+
+        std::printf("%s\n", entry.name);
+        entry.function();
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "../structs.h"
+#include "../combat_roster.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+const int CHARACTERS = 40;
+
+bool has(const std::vector<char_data*>& list, char_data* ch)
+{
+    return std::find(list.begin(), list.end(), ch) != list.end();
+}
+
+void drop(std::vector<char_data*>& list, char_data* ch)
+{
+    list.erase(std::find(list.begin(), list.end(), ch));
+}
+}
+
+// Fighters leave and join while the roster is walked, as they do when a
+// round kills or extracts someone and others start fights in reply.  The
+// walk must reach everyone who was fighting when it started and is still
+// fighting in their old place, and compact() must leave every place
+// numbered, in the order the fighters joined.
+TEST(CombatRoster, fighters_leave_and_join_during_a_walk)
+{
+    game_rules::combat_roster roster;
+    std::vector<char_data*> characters;
+    for (int number = 0; number < CHARACTERS; ++number)
+        characters.push_back(new char_data());
+
+    // Those fighting, in the order they joined.
+    std::vector<char_data*> joined;
+
+    std::srand(17);
+    for (int round = 0; round < 200; ++round) {
+        for (char_data* ch : characters) {
+            if (std::rand() % 4 == 0 && !has(joined, ch)) {
+                roster.add(ch);
+                joined.push_back(ch);
+            }
+        }
+
+        std::vector<char_data*> due(joined.rbegin(), joined.rend());
+        std::vector<char_data*> walked;
+        for (char_data* fighter : roster) {
+            walked.push_back(fighter);
+            for (int change = std::rand() % 3; change > 0; --change) {
+                char_data* ch = characters[std::rand() % CHARACTERS];
+                if (has(joined, ch)) {
+                    roster.remove(ch);
+                    drop(joined, ch);
+                    if (has(due, ch) && !has(walked, ch))
+                        drop(due, ch);
+                } else {
+                    roster.add(ch);
+                    joined.push_back(ch);
+                }
+            }
+        }
+        ASSERT_EQ(walked, due) << "round " << round;
+
+        roster.compact();
+        ASSERT_EQ(roster.size(), int(joined.size())) << "round " << round;
+        ASSERT_EQ(roster.places(), int(joined.size())) << "round " << round;
+        for (int place = 0; place < roster.places(); ++place) {
+            ASSERT_EQ(roster.at(place), joined[place]) << "round " << round;
+            ASSERT_EQ(roster.at(place)->combat_slot, place + 1) << "round " << round;
+        }
+        for (char_data* ch : characters)
+            ASSERT_EQ(roster.contains(ch), has(joined, ch)) << "round " << round;
+    }
+
+    for (char_data* ch : characters)
+        delete ch;
+}
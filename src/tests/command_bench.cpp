@@ -0,0 +1,158 @@
+#include "../structs.h"
+#include "../db.h"
+#include "../interpre.h"
+#include "../command_trie.h"
+#include "bench.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern const char* command[];
+extern struct social_messg* soc_mess_list;
+extern int social_list_top;
+
+int find_action_sorted(char* arg);
+
+namespace {
+// Socials as a booted misc/socials would have them, sorted.
+const char* socials[] = {
+    "accuse", "applaud", "bearhug", "beg", "blush", "bounce", "bow", "burp", "cackle", "chuckle",
+    "clap", "comfort", "cough", "cringe", "cry", "cuddle", "curse", "curtsey", "dance", "daydream",
+    "drool", "fart", "flip", "fondle", "french", "frown", "fume", "gasp", "giggle", "glare",
+    "greet", "grin", "groan", "grope", "grovel", "growl", "hiccup", "hug", "kiss", "laugh",
+    "lick", "love", "massage", "moan", "nibble", "nod", "nudge", "nuzzle", "pat", "peer",
+    "point", "poke", "ponder", "pout", "puke", "punch", "purr", "roll", "ruffle", "scream",
+    "shake", "shiver", "shrug", "sigh", "sing", "slap", "smile", "smirk", "snap", "snarl",
+    "sneeze", "snicker", "sniff", "snore", "snowball", "snuggle", "spank", "spit", "squeeze", "stare",
+    "steam", "strut", "sulk", "tackle", "thank", "think", "tickle", "twiddle", "wave", "whine",
+    "whistle", "wiggle", "wink", "yawn"
+};
+
+// An excerpt of last_cmds from a busy evening, used when BENCH_COMMAND_LOG
+// does not name a log of your own.
+const char* sample_log[] = {
+    "  5 Aldamir         : n", "  5 Aldamir         : n", "  5 Aldamir         : e",
+    "  5 Aldamir         : l", "  5 Aldamir         : k orc", "  5 Aldamir         : k orc",
+    "  7 Beleg           : score", "  7 Beleg           : i", "  7 Beleg           : eq",
+    "  7 Beleg           : get all corpse", "  7 Beleg           : rest", "  7 Beleg           : stand",
+    "  9 Curunir         : cast 'cure light' aldamir", "  9 Curunir         : cast 'blink'",
+    "  9 Curunir         : nod", "  9 Curunir         : smile beleg", "  9 Curunir         : say well met",
+    " 12 Dior            : tell beleg hi", " 12 Dior            : who", " 12 Dior            : where",
+    " 12 Dior            : s", " 12 Dior            : s", " 12 Dior            : w",
+    " 12 Dior            : sc", " 12 Dior            : exa gate", " 12 Dior            : open gate",
+    " 14 Elured          : grin", " 14 Elured          : bow", " 14 Elured          : wave",
+    " 14 Elured          : follow dior", " 14 Elured          : gr", " 14 Elured          : flee",
+    " 14 Elured          : wimpy 40", " 14 Elured          : rescue dior", " 14 Elured          : bash troll",
+    " 16 Finrod          : prac", " 16 Finrod          : time", " 16 Finrod          : weather",
+    " 16 Finrod          : wear all", " 16 Finrod          : rem shield", " 16 Finrod          : drink skin",
+    " 16 Finrod          : eat bread", " 16 Finrod          : hide", " 16 Finrod          : sneak",
+    " 16 Finrod          : u", " 16 Finrod          : d", " 16 Finrod          : chuck",
+    " 16 Finrod          : giggle", " 16 Finrod          : pat finrod", " 16 Finrod          : hmm",
+    " 16 Finrod          : emote looks around", " 16 Finrod          : narrate anyone at the ford?",
+    " 16 Finrod          : ride horse", " 16 Finrod          : group", " 16 Finrod          : consider orc",
+};
+
+void boot_socials()
+{
+    int count = sizeof(socials) / sizeof(socials[0]);
+    soc_mess_list = (social_messg*)calloc(count, sizeof(social_messg));
+    for (int social = 0; social < count; ++social)
+        soc_mess_list[social].command = strdup(socials[social]);
+    social_list_top = count - 1;
+}
+
+// The command part of a journal line ("... name (id): command"), an old
+// last_cmds line ("desc name: command"), or a bare command.
+std::string command_of(const char* line)
+{
+    const char* text = strstr(line, "): ");
+    if (text)
+        return text + 3;
+    text = strstr(line, ": ");
+    return text ? text + 2 : line;
+}
+
+// The lower case verb of each command in the log, as command_interpreter()
+// would look it up.
+std::vector<std::string> replay_verbs()
+{
+    std::vector<std::string> lines;
+    const char* path = getenv("BENCH_COMMAND_LOG");
+    FILE* log = path ? fopen(path, "r") : 0;
+    if (log) {
+        char line[MAX_INPUT_LENGTH + 128];
+        while (fgets(line, sizeof(line), log)) {
+            line[strcspn(line, "\r\n")] = 0;
+            lines.push_back(command_of(line));
+        }
+        fclose(log);
+    } else {
+        for (const char* line : sample_log)
+            lines.push_back(command_of(line));
+    }
+
+    std::vector<std::string> verbs;
+    for (const std::string& line : lines) {
+        std::string verb;
+        size_t letter = line.find_first_not_of(' ');
+        if (letter == std::string::npos || strchr("';,", line[letter]))
+            continue;
+        for (; letter < line.size() && line[letter] > ' '; ++letter)
+            verb += char(tolower(line[letter]));
+        verbs.push_back(verb);
+    }
+    std::printf("  replaying %d commands from %s\n", int(verbs.size()), log ? path : "the built-in sample");
+    return verbs;
+}
+
+int legacy_resolve(std::string& verb)
+{
+    int cmd = old_search_block(&verb[0], 0, verb.size(), command, 0);
+    if (cmd > 0)
+        return cmd;
+    int social = find_action_sorted(&verb[0]);
+    return social >= 0 ? 1000 + social : -1;
+}
+
+int trie_resolve(const std::string& verb)
+{
+    game_commands::verb_match match = game_commands::lookup(verb.data(), verb.size());
+    if (match.command > 0)
+        return match.command;
+    return match.social >= 0 ? 1000 + match.social : -1;
+}
+}
+
+// Every pass resolves the verb of one command from the log to a command or
+// a social.
+BENCHMARK(command_dispatch)
+{
+    if (!soc_mess_list)
+        boot_socials();
+    if (!game_commands::is_built())
+        game_commands::build();
+
+    static std::vector<std::string> verbs = replay_verbs();
+    if (verbs.empty())
+        return;
+
+    int differences = 0;
+    for (std::string& verb : verbs)
+        differences += legacy_resolve(verb) != trie_resolve(verb);
+    if (differences)
+        std::printf("  %d commands resolved differently!\n", differences);
+
+    const long passes = 5000000;
+    long count = long(verbs.size());
+
+    bench::report("dispatch, table and socials scan", passes, [&](long pass) {
+        return legacy_resolve(verbs[pass % count]);
+    });
+    bench::report("dispatch, trie", passes, [&](long pass) {
+        return trie_resolve(verbs[pass % count]);
+    });
+}
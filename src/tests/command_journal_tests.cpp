@@ -0,0 +1,133 @@
+#include "../structs.h"
+#include "../command_journal.h"
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+void sigsegv_handler(int sig);
+
+namespace {
+descriptor_data* test_descriptor()
+{
+    static descriptor_data* descriptor = 0;
+    if (!descriptor) {
+        descriptor = new descriptor_data();
+        descriptor->descriptor = 7;
+    }
+    return descriptor;
+}
+
+std::string read_file(const char* path)
+{
+    std::string text;
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return text;
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        text.append(chunk, length);
+    fclose(file);
+    return text;
+}
+
+int count_lines(const std::string& text)
+{
+    int lines = 0;
+    for (char letter : text)
+        lines += letter == '\n';
+    return lines;
+}
+
+// The SigBlk mask of each thread of this process but the calling one.
+std::vector<std::string> other_thread_masks()
+{
+    std::vector<std::string> masks;
+    DIR* tasks = opendir("/proc/self/task");
+    if (!tasks)
+        return masks;
+    std::string self = std::to_string(gettid());
+    while (dirent* task = readdir(tasks)) {
+        if (task->d_name[0] == '.' || self == task->d_name)
+            continue;
+        std::string status = read_file(("/proc/self/task/" + std::string(task->d_name) + "/status").c_str());
+        size_t field = status.find("SigBlk:");
+        if (field != std::string::npos)
+            masks.push_back(status.substr(field, status.find('\n', field) - field));
+    }
+    closedir(tasks);
+    return masks;
+}
+}
+
+TEST(CommandJournal, dump_writes_commands_oldest_first)
+{
+    game_journal::record(test_descriptor(), "look");
+    game_journal::record(test_descriptor(), "kill orc");
+    game_journal::dump("journal_test_dump");
+
+    std::string dumped = read_file("journal_test_dump");
+    unlink("journal_test_dump");
+    size_t look = dumped.find("  7  (-1): look\n");
+    size_t kill = dumped.find("  7  (-1): kill orc\n");
+    ASSERT_NE(look, std::string::npos);
+    ASSERT_NE(kill, std::string::npos);
+    EXPECT_LT(look, kill);
+}
+
+TEST(CommandJournal, dump_keeps_only_the_ring)
+{
+    char command[32];
+    for (int number = 0; number < game_journal::JOURNAL_RECORDS + 10; ++number) {
+        sprintf(command, "wrap %d", number);
+        game_journal::record(test_descriptor(), command);
+    }
+    game_journal::dump("journal_test_dump");
+
+    std::string dumped = read_file("journal_test_dump");
+    unlink("journal_test_dump");
+    EXPECT_EQ(count_lines(dumped), game_journal::JOURNAL_RECORDS);
+    EXPECT_EQ(dumped.find("wrap 9\n"), std::string::npos);
+    EXPECT_NE(dumped.find("wrap 10\n"), std::string::npos);
+}
+
+TEST(CommandJournalDeathTest, sigsegv_handler_dumps_the_ring)
+{
+    testing::FLAGS_gtest_death_test_style = "threadsafe";
+    game_journal::record(test_descriptor(), "say last words");
+    unlink("crash_journal");
+
+    EXPECT_EXIT({
+        signal(SIGSEGV, sigsegv_handler);
+        raise(SIGSEGV);
+    },
+        testing::ExitedWithCode(1), "signal 11");
+
+    std::string dumped = read_file("crash_journal");
+    unlink("crash_journal");
+    EXPECT_NE(dumped.find("(-1): say last words\n"), std::string::npos);
+}
+
+TEST(CommandJournal, flusher_blocks_signals)
+{
+    game_journal::start("journal_test_log", 1000000);
+    std::vector<std::string> masks = other_thread_masks();
+    game_journal::stop();
+    unlink("journal_test_log");
+
+    // Only this thread may take SIGTERM, SIGHUP or SIGVTALRM.
+    ASSERT_FALSE(masks.empty());
+    for (const std::string& mask : masks) {
+        unsigned long long blocked = strtoull(mask.c_str() + strlen("SigBlk:"), 0, 16);
+        EXPECT_TRUE(blocked & (1ULL << (SIGTERM - 1))) << mask;
+        EXPECT_TRUE(blocked & (1ULL << (SIGHUP - 1))) << mask;
+        EXPECT_TRUE(blocked & (1ULL << (SIGVTALRM - 1))) << mask;
+    }
+}
@@ -0,0 +1,106 @@
+#include "../structs.h"
+#include "../db.h"
+#include "../interpre.h"
+#include "../command_trie.h"
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern const char* command[];
+extern struct social_messg* soc_mess_list;
+extern int social_list_top;
+
+int find_action_sorted(char* arg);
+
+namespace {
+const char* sorted_socials[] = {
+    "accuse", "applaud", "bearhug", "beg", "blush", "bounce", "bow", "burp", "cackle", "chuckle",
+    "clap", "comfort", "cough", "cringe", "cry", "cuddle", "curse", "curtsey", "dance", "daydream",
+    "drool", "flip", "frown", "fume", "gasp", "giggle", "glare", "greet", "grin", "groan",
+    "grovel", "growl", "hiccup", "hug", "kiss", "laugh", "nod", "nudge", "nuzzle", "pat",
+    "peer", "point", "poke", "ponder", "pout", "purr", "roll", "ruffle", "scream", "shake",
+    "shiver", "shrug", "sigh", "sing", "smile", "smirk", "snap", "snarl", "sneeze", "snicker",
+    "sniff", "snore", "snowball", "snuggle", "spit", "stare", "steam", "strut", "sulk", "thank",
+    "think", "tickle", "twiddle", "wave", "whine", "whistle", "wiggle", "wink", "yawn"
+};
+
+// Out of order, so that find_action()'s binary search takes its odd turns.
+const char* unsorted_socials[] = {
+    "bow", "bounce", "grin", "greet", "smile", "smirk", "sm", "nod", "wave", "zz", "ab", "abc", "a"
+};
+
+void boot_socials(const char** socials, int count)
+{
+    soc_mess_list = (social_messg*)calloc(count, sizeof(social_messg));
+    for (int social = 0; social < count; ++social)
+        soc_mess_list[social].command = strdup(socials[social]);
+    social_list_top = count - 1;
+}
+
+void unboot_socials()
+{
+    for (int social = 0; social <= social_list_top; ++social)
+        free(soc_mess_list[social].command);
+    free(soc_mess_list);
+    soc_mess_list = 0;
+    social_list_top = -1;
+}
+
+// Every prefix of every command and social, a letter past each, and
+// 200000 random verbs must resolve as the old searches resolved them.
+void expect_old_searches(const char** socials, int count)
+{
+    std::vector<std::string> verbs;
+    for (int number = 0; *command[number] != '\n'; ++number) {
+        std::string name = command[number];
+        for (size_t length = 0; length <= name.size(); ++length) {
+            verbs.push_back(name.substr(0, length));
+            verbs.push_back(name.substr(0, length) + "x");
+        }
+        verbs.push_back(name + "e");
+    }
+    for (int social = 0; social < count; ++social) {
+        std::string name = socials[social];
+        for (size_t length = 0; length <= name.size(); ++length) {
+            verbs.push_back(name.substr(0, length));
+            verbs.push_back(name.substr(0, length) + "q");
+        }
+    }
+    srand(3);
+    for (int verb = 0; verb < 200000; ++verb) {
+        std::string word;
+        for (int length = 1 + rand() % 5; length > 0; --length)
+            word += char('a' + rand() % 26);
+        verbs.push_back(word);
+    }
+
+    std::vector<char> typed;
+    for (const std::string& verb : verbs) {
+        typed.assign(verb.begin(), verb.end());
+        typed.push_back(0);
+        game_commands::verb_match match = game_commands::lookup(verb.data(), verb.size());
+        ASSERT_EQ(match.command, old_search_block(&typed[0], 0, verb.size(), command, 0)) << "'" << verb << "'";
+        ASSERT_EQ(match.social, find_action_sorted(&typed[0])) << "'" << verb << "'";
+    }
+}
+}
+
+TEST(CommandTrie, matches_the_old_searches)
+{
+    boot_socials(sorted_socials, sizeof(sorted_socials) / sizeof(sorted_socials[0]));
+    game_commands::build();
+    EXPECT_TRUE(game_commands::is_built());
+    expect_old_searches(sorted_socials, sizeof(sorted_socials) / sizeof(sorted_socials[0]));
+    unboot_socials();
+}
+
+TEST(CommandTrie, matches_the_old_searches_on_unsorted_socials)
+{
+    boot_socials(unsorted_socials, sizeof(unsorted_socials) / sizeof(unsorted_socials[0]));
+    game_commands::build();
+    expect_old_searches(unsorted_socials, sizeof(unsorted_socials) / sizeof(unsorted_socials[0]));
+    unboot_socials();
+}
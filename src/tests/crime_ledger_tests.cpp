@@ -0,0 +1,112 @@
+#include "../structs.h"
+#include "../crime_ledger.h"
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+const char* TEST_FILE = "crime_ledger_test";
+
+crime_record_type make_crime(int criminal, int victim, int witness)
+{
+    crime_record_type record = { 0, (sh_int)criminal, (sh_int)victim, 1, (sh_int)witness, 0 };
+    return record;
+}
+
+// The crimes as the old crime_record array kept them: a plain scan for each
+// question.
+struct crime_list {
+    std::vector<crime_record_type> records;
+
+    bool known(int criminal, int victim, int witness) const
+    {
+        for (const crime_record_type& record : records)
+            if (record.criminal == (sh_int)criminal && record.victim == (sh_int)victim && record.witness == (sh_int)witness)
+                return true;
+        return false;
+    }
+
+    int forget(int witness, int criminal)
+    {
+        int count = 0;
+        for (size_t at = 0; at < records.size();)
+            if (records[at].witness == (sh_int)witness && (criminal == -1 || records[at].criminal == (sh_int)criminal)) {
+                records.erase(records.begin() + at);
+                ++count;
+            } else
+                ++at;
+        return count;
+    }
+};
+
+long file_records()
+{
+    FILE* file = fopen(TEST_FILE, "rb");
+    if (!file)
+        return 0;
+    fseek(file, 0, SEEK_END);
+    long records = ftell(file) / long(sizeof(crime_record_type));
+    fclose(file);
+    return records;
+}
+}
+
+// Adds and forgets crimes at random, and checks every answer against the
+// list scan, before and after the file is replayed.
+TEST(CrimeLedger, answers_match_the_list_scan)
+{
+    unlink(TEST_FILE);
+    game_crimes::ledger ledger;
+    ledger.load(TEST_FILE);
+    crime_list list;
+    srand(11);
+
+    for (int step = 0; step < 20000; ++step) {
+        int criminal = rand() % 30, victim = rand() % 30, witness = rand() % 30;
+        int action = rand() % 10;
+        if (action < 6) {
+            crime_record_type record = make_crime(criminal, victim, witness);
+            bool fresh = !list.known(criminal, victim, witness);
+            ASSERT_EQ(ledger.add(record), fresh);
+            if (fresh)
+                list.records.push_back(record);
+        } else if (action < 7) {
+            if (rand() % 4 == 0)
+                criminal = -1;
+            ASSERT_EQ(ledger.forget(witness, criminal), list.forget(witness, criminal));
+        } else
+            ASSERT_EQ(ledger.known(criminal, victim, witness), list.known(criminal, victim, witness));
+        ASSERT_EQ(ledger.size(), int(list.records.size()));
+    }
+
+    game_crimes::ledger replayed;
+    replayed.load(TEST_FILE);
+    EXPECT_EQ(replayed.size(), int(list.records.size()));
+    EXPECT_EQ(file_records(), long(list.records.size()));
+    for (int criminal = 0; criminal < 30; ++criminal)
+        for (int victim = 0; victim < 30; ++victim)
+            for (int witness = 0; witness < 30; ++witness)
+                ASSERT_EQ(replayed.known(criminal, victim, witness), list.known(criminal, victim, witness));
+    unlink(TEST_FILE);
+}
+
+TEST(CrimeLedger, forgetting_appends_until_compaction)
+{
+    unlink(TEST_FILE);
+    game_crimes::ledger ledger;
+    ledger.load(TEST_FILE);
+
+    for (int victim = 0; victim < 10; ++victim)
+        ledger.add(make_crime(1, victim, 2));
+    EXPECT_EQ(ledger.forget(2, 1), 10);
+    EXPECT_EQ(file_records(), 20);
+
+    // Loading drops the forgotten crimes and their cancellations.
+    ledger.load(TEST_FILE);
+    EXPECT_EQ(ledger.size(), 0);
+    EXPECT_EQ(file_records(), 0);
+    unlink(TEST_FILE);
+}
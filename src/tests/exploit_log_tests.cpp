@@ -0,0 +1,126 @@
+#include "../structs.h"
+#include "../exploit_log.h"
+#include <gtest/gtest.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// Runs each test in a scratch directory with its own exploits tree.
+class ExploitLog : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(getcwd(m_home, sizeof(m_home)));
+        strcpy(m_scratch, "/tmp/exploit_log_testXXXXXX");
+        ASSERT_TRUE(mkdtemp(m_scratch));
+        ASSERT_EQ(chdir(m_scratch), 0);
+        mkdir("exploits", 0700);
+        mkdir("exploits/A-E", 0700);
+    }
+
+    void TearDown() override
+    {
+        unlink("exploits/A-E/bilbo.exploits");
+        rmdir("exploits/A-E");
+        rmdir("exploits");
+        if (chdir(m_home) == 0)
+            rmdir(m_scratch);
+    }
+
+    char m_home[PATH_MAX];
+    char m_scratch[64];
+};
+
+exploit_record make_record(int number)
+{
+    exploit_record record;
+    memset(&record, 0, sizeof(record));
+    record.type = 1 + number % 7;
+    record.iVictimLevel = number;
+    sprintf(record.chVictimName, "victim %d", number);
+    return record;
+}
+
+std::vector<int> read_numbers(const char* name)
+{
+    std::vector<int> numbers;
+    game_exploits::reader exploits(name);
+    exploit_record record;
+    while (exploits.next(record))
+        numbers.push_back(record.iVictimLevel);
+    return numbers;
+}
+}
+
+TEST_F(ExploitLog, files_are_sorted_by_first_letter)
+{
+    char filename[100];
+    game_exploits::log_filename("Bilbo", filename);
+    EXPECT_STREQ(filename, "exploits/A-E/bilbo.exploits");
+    game_exploits::log_filename("zog", filename);
+    EXPECT_STREQ(filename, "exploits/U-Z/zog.exploits");
+    game_exploits::log_filename("", filename);
+    EXPECT_STREQ(filename, "exploits/ZZZ/.exploits");
+}
+
+TEST_F(ExploitLog, reads_newest_first_across_chunks)
+{
+    EXPECT_FALSE(game_exploits::reader("Bilbo").is_open());
+
+    const int RECORDS = 200;
+    for (int number = 0; number < RECORDS; ++number)
+        ASSERT_TRUE(game_exploits::append("Bilbo", make_record(number)));
+
+    std::vector<int> numbers = read_numbers("Bilbo");
+    ASSERT_EQ(numbers.size(), size_t(RECORDS));
+    for (int at = 0; at < RECORDS; ++at)
+        EXPECT_EQ(numbers[at], RECORDS - 1 - at);
+}
+
+TEST_F(ExploitLog, converts_files_from_before_the_log)
+{
+    // The old format: newest first, no header.
+    FILE* file = fopen("exploits/A-E/bilbo.exploits", "wb");
+    ASSERT_TRUE(file);
+    for (int number = 99; number >= 0; --number) {
+        exploit_record record = make_record(number);
+        fwrite(&record, sizeof(record), 1, file);
+    }
+    fclose(file);
+
+    std::vector<int> numbers = read_numbers("Bilbo");
+    ASSERT_EQ(numbers.size(), 100u);
+    EXPECT_EQ(numbers.front(), 99);
+    EXPECT_EQ(numbers.back(), 0);
+
+    ASSERT_TRUE(game_exploits::append("Bilbo", make_record(100)));
+    numbers = read_numbers("Bilbo");
+    ASSERT_EQ(numbers.size(), 101u);
+    for (int at = 0; at < 101; ++at)
+        EXPECT_EQ(numbers[at], 100 - at);
+}
+
+TEST_F(ExploitLog, drops_a_record_cut_short)
+{
+    ASSERT_TRUE(game_exploits::append("Bilbo", make_record(0)));
+    ASSERT_TRUE(game_exploits::append("Bilbo", make_record(1)));
+
+    FILE* file = fopen("exploits/A-E/bilbo.exploits", "ab");
+    ASSERT_TRUE(file);
+    exploit_record torn = make_record(2);
+    fwrite(&torn, sizeof(torn) / 2, 1, file);
+    fclose(file);
+
+    ASSERT_TRUE(game_exploits::append("Bilbo", make_record(3)));
+    std::vector<int> numbers = read_numbers("Bilbo");
+    ASSERT_EQ(numbers.size(), 3u);
+    EXPECT_EQ(numbers[0], 3);
+    EXPECT_EQ(numbers[1], 1);
+    EXPECT_EQ(numbers[2], 0);
+}
@@ -0,0 +1,183 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../handler.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+void clear_char(struct char_data* ch, int mode);
+void affect_naked(char_data* ch);
+void modify_affects(char_data* character, int modify_flag);
+
+namespace {
+// affect_total()'s handling of equipment before the ledger: every affect of
+// every worn item, slot by slot.
+void walk_gear(char_data* ch, int modify_flag)
+{
+    for (int slot = 0; slot < MAX_WEAR; ++slot) {
+        const obj_data* item = ch->equipment[slot];
+        if (!item || (slot == HOLD && !CAN_WEAR(item, ITEM_HOLD)))
+            continue;
+        for (int count = 0; count < MAX_OBJ_AFFECT; ++count)
+            if (item->affected[count].location != APPLY_SPELL)
+                affect_modify(ch, item->affected[count].location, item->affected[count].modifier,
+                    item->obj_flags.bitvector, modify_flag, 0);
+    }
+}
+
+template <class T>
+T clamp_ability(T value, int low)
+{
+    return std::max(T(low), std::min(value, T(100)));
+}
+
+// affect_total() as it was before the ledger.
+void walk_total(char_data* ch)
+{
+    walk_gear(ch, AFFECT_MODIFY_REMOVE);
+    modify_affects(ch, AFFECT_MODIFY_REMOVE);
+    recalc_abilities(ch);
+    affect_naked(ch);
+    walk_gear(ch, AFFECT_MODIFY_SET);
+    modify_affects(ch, AFFECT_MODIFY_SET);
+
+    ch->abilities.dex = clamp_ability(ch->abilities.dex, 1);
+    ch->abilities.intel = clamp_ability(ch->abilities.intel, 0);
+    ch->abilities.wil = clamp_ability(ch->abilities.wil, 0);
+    ch->abilities.con = clamp_ability(ch->abilities.con, 0);
+    ch->abilities.str = clamp_ability(ch->abilities.str, 1);
+    ch->abilities.lea = clamp_ability(ch->abilities.lea, 0);
+}
+
+// Summed, replayed and inert locations alike, and APPLY_SPELL.
+const int locations[] = {
+    APPLY_NONE, APPLY_STR, APPLY_DEX, APPLY_INT, APPLY_WILL, APPLY_CON, APPLY_LEA,
+    APPLY_AGE, APPLY_CHAR_WEIGHT, APPLY_CHAR_HEIGHT, APPLY_MANA, APPLY_HIT, APPLY_MOVE,
+    APPLY_DODGE, APPLY_OB, APPLY_DAMROLL, APPLY_SAVING_SPELL, APPLY_SPELL, APPLY_BEND,
+    APPLY_SPEED, APPLY_WILLPOWER, APPLY_PERCEPTION, APPLY_MANA_REGEN, APPLY_SPELL_PEN,
+    APPLY_SPELL_POW, APPLY_ARMOR, APPLY_REGEN
+};
+const int LOCATION_COUNT = sizeof(locations) / sizeof(locations[0]);
+
+obj_data* random_item()
+{
+    obj_data* item = (obj_data*)calloc(1, sizeof(obj_data));
+    item->obj_flags.type_flag = ITEM_TRASH;
+    item->in_room = NOWHERE;
+    item->obj_flags.wear_flags = rand() % 2 ? ITEM_HOLD : 0;
+    item->obj_flags.bitvector = rand() % 3 == 0 ? 1L << (rand() % 20) : 0;
+    for (int count = 0; count < MAX_OBJ_AFFECT; ++count) {
+        item->affected[count].location = locations[rand() % LOCATION_COUNT];
+        item->affected[count].modifier = rand() % 11 - 5;
+        if (item->affected[count].location == APPLY_BEND)
+            item->affected[count].modifier = rand() % 20;
+    }
+    return item;
+}
+
+// The same 'seed' gives the same character, items and all.
+char_data* random_character(unsigned int seed)
+{
+    srand(seed);
+    char_data* ch = (char_data*)calloc(1, sizeof(char_data));
+    clear_char(ch, 0);
+    SET_BIT(MOB_FLAGS(ch), MOB_ISNPC);
+    ch->abilities.str = ch->tmpabilities.str = 10 + rand() % 10;
+    ch->abilities.dex = ch->tmpabilities.dex = 10 + rand() % 10;
+    ch->abilities.con = ch->tmpabilities.con = 10 + rand() % 10;
+    ch->abilities.hit = ch->tmpabilities.hit = 100;
+    ch->abilities.mana = ch->tmpabilities.mana = 50;
+    ch->abilities.move = ch->tmpabilities.move = 80;
+
+    for (int item = rand() % 12; item > 0; --item) {
+        int slot = rand() % MAX_WEAR;
+        if (!ch->equipment[slot])
+            equip_char(ch, random_item(), slot);
+    }
+    for (int item = 0; item < 4; ++item) {
+        int slot = rand() % MAX_WEAR;
+        if (ch->equipment[slot])
+            free(unequip_char(ch, slot));
+    }
+    return ch;
+}
+
+void free_character(char_data* ch)
+{
+    for (int slot = 0; slot < MAX_WEAR; ++slot)
+        if (ch->equipment[slot])
+            free(unequip_char(ch, slot));
+    free(ch->profs);
+    free(ch);
+}
+}
+
+#define EXPECT_SAME(field) EXPECT_EQ(ledger->field, walked->field) << #field << ", character " << number
+
+// Equips characters at random, and checks that affect_total() with the
+// ledger leaves every field as walking the equipment did.
+TEST(GearLedger, matches_walking_the_equipment)
+{
+    for (int number = 0; number < 2000; ++number) {
+        char_data* ledger = random_character(7 + number);
+        char_data* walked = random_character(7 + number);
+        affect_total(ledger);
+        affect_total(walked);
+
+        affect_total(ledger);
+        walk_total(walked);
+
+        EXPECT_SAME(abilities.str);
+        EXPECT_SAME(abilities.dex);
+        EXPECT_SAME(abilities.con);
+        EXPECT_SAME(abilities.intel);
+        EXPECT_SAME(abilities.wil);
+        EXPECT_SAME(abilities.lea);
+        EXPECT_SAME(abilities.hit);
+        EXPECT_SAME(abilities.mana);
+        EXPECT_SAME(abilities.move);
+        EXPECT_SAME(tmpabilities.str);
+        EXPECT_SAME(tmpabilities.dex);
+        EXPECT_SAME(tmpabilities.hit);
+        EXPECT_SAME(tmpabilities.mana);
+        EXPECT_SAME(tmpabilities.move);
+        EXPECT_SAME(points.dodge);
+        EXPECT_SAME(points.OB);
+        EXPECT_SAME(points.damage);
+        EXPECT_SAME(points.ENE_regen);
+        EXPECT_SAME(points.spell_pen);
+        EXPECT_SAME(points.spell_power);
+        EXPECT_SAME(points.mana_regen);
+        EXPECT_SAME(specials.affected_by);
+        EXPECT_SAME(specials2.perception);
+        EXPECT_SAME(specials2.rawPerception);
+        EXPECT_SAME(specials2.saving_throw);
+        EXPECT_SAME(player.weight);
+        EXPECT_SAME(player.height);
+        EXPECT_SAME(player.time.birth);
+        free_character(ledger);
+        free_character(walked);
+        if (HasFailure())
+            break;
+    }
+}
+
+TEST(GearLedger, removing_an_item_takes_back_what_it_added)
+{
+    char_data* ch = random_character(9);
+    gear_affect_ledger before = ch->gear_affects;
+
+    int slot = 0;
+    while (ch->equipment[slot])
+        ++slot;
+    equip_char(ch, random_item(), slot);
+    free(unequip_char(ch, slot));
+
+    EXPECT_EQ(memcmp(before.totals, ch->gear_affects.totals, sizeof(before.totals)), 0);
+    EXPECT_EQ(before.bits, ch->gear_affects.bits);
+    EXPECT_EQ(before.worn_slots, ch->gear_affects.worn_slots);
+    EXPECT_EQ(before.ordered_slots, ch->gear_affects.ordered_slots);
+    free_character(ch);
+}
@@ -0,0 +1,224 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../mob_activity.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+extern struct room_data world;
+extern int mobile_activity_budget;
+
+namespace {
+std::vector<char_data*> visited;
+void (*on_visit)(char_data*) = 0;
+
+void record_visit(char_data* ch)
+{
+    visited.push_back(ch);
+    if (on_visit)
+        on_visit(ch);
+}
+
+int visits_of(char_data* ch)
+{
+    return int(std::count(visited.begin(), visited.end(), ch));
+}
+
+// Borrows rooms from the end of the world, giving each a zone of its own,
+// and gives them back as they were.
+class MobActivity : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if (room_data::PAGES == 0)
+            world.create_bulk(1);
+        saved_budget = mobile_activity_budget;
+        visited.clear();
+        on_visit = 0;
+    }
+
+    void TearDown() override
+    {
+        for (char_data* ch : characters) {
+            game_activity::leave_room(ch);
+            delete ch;
+        }
+        for (auto& saved : saved_zones)
+            world[saved.first].zone = saved.second;
+        mobile_activity_budget = saved_budget;
+        on_visit = 0;
+    }
+
+    int room_in_zone(int zone)
+    {
+        int room = room_data::TOTAL_LENGTH - 1 - int(saved_zones.size());
+        saved_zones.push_back(std::make_pair(room, world[room].zone));
+        world[room].zone = zone;
+        return room;
+    }
+
+    char_data* make_char(int room, bool npc)
+    {
+        char_data* ch = new char_data();
+        ch->in_room = room;
+        if (npc)
+            SET_BIT(MOB_FLAGS(ch), MOB_ISNPC);
+        characters.push_back(ch);
+        game_activity::enter_room(ch);
+        return ch;
+    }
+
+    void move_char(char_data* ch, int room)
+    {
+        game_activity::leave_room(ch);
+        ch->in_room = room;
+        game_activity::enter_room(ch);
+    }
+
+    // Every filed character sits at its own slot of its list, and the slots
+    // of a list run from 0 up without a gap.
+    void expect_consistent_slots()
+    {
+        std::map<std::pair<int, int>, std::vector<int>> slots;
+        for (char_data* ch : characters)
+            if (ch->activity.list)
+                slots[std::make_pair(int(ch->activity.zone), int(ch->activity.list))].push_back(ch->activity.slot);
+
+        for (auto& list : slots) {
+            std::sort(list.second.begin(), list.second.end());
+            for (size_t at = 0; at < list.second.size(); ++at) {
+                ASSERT_EQ(list.second[at], int(at)) << "zone " << list.first.first << ", list " << list.first.second;
+            }
+        }
+    }
+
+    int saved_budget;
+    std::vector<std::pair<int, int>> saved_zones;
+    std::vector<char_data*> characters;
+};
+
+std::vector<char_data*> extracted;
+char_data* mover;
+int moved_to;
+
+// The first character visited extracts every other character not yet
+// visited, and moves one of them instead.
+void extract_the_rest(char_data* ch)
+{
+    if (visited.size() != 1)
+        return;
+    for (char_data* victim : extracted)
+        if (victim != ch)
+            game_activity::leave_room(victim);
+    if (mover != ch) {
+        game_activity::leave_room(mover);
+        mover->in_room = moved_to;
+        game_activity::enter_room(mover);
+    }
+}
+}
+
+TEST_F(MobActivity, slots_follow_characters_in_and_out_of_rooms)
+{
+    int rooms[] = { room_in_zone(901), room_in_zone(901), room_in_zone(902) };
+    std::vector<char_data*> mobs;
+    for (int number = 0; number < 60; ++number)
+        mobs.push_back(make_char(rooms[number % 3], number % 7 != 0));
+    expect_consistent_slots();
+
+    std::srand(5);
+    for (int step = 0; step < 2000; ++step) {
+        char_data* ch = mobs[std::rand() % mobs.size()];
+        switch (std::rand() % 4) {
+        case 0:
+            game_activity::leave_room(ch);
+            break;
+        case 1:
+            game_activity::enter_room(ch);
+            break;
+        case 2:
+            ch->specials.fighting = ch->specials.fighting ? 0 : ch;
+            game_activity::enter_room(ch);
+            break;
+        default:
+            move_char(ch, rooms[std::rand() % 3]);
+            break;
+        }
+        expect_consistent_slots();
+        if (HasFatalFailure())
+            return;
+    }
+
+    // With players in both zones, every filed character is visited once.
+    make_char(rooms[0], false);
+    make_char(rooms[2], false);
+    game_activity::run_pulse(record_visit);
+    for (char_data* ch : characters)
+        EXPECT_EQ(visits_of(ch), ch->activity.list ? 1 : 0);
+    expect_consistent_slots();
+}
+
+TEST_F(MobActivity, characters_extracted_during_a_pulse_are_not_visited)
+{
+    int room = room_in_zone(903);
+    moved_to = room_in_zone(904);
+    make_char(room, false);
+    extracted.clear();
+    for (int number = 0; number < 20; ++number)
+        extracted.push_back(make_char(room, true));
+    mover = make_char(room, true);
+
+    on_visit = extract_the_rest;
+    game_activity::run_pulse(record_visit);
+
+    ASSERT_FALSE(visited.empty());
+    for (char_data* ch : extracted)
+        EXPECT_EQ(visits_of(ch), ch == visited[0] ? 1 : 0);
+    EXPECT_EQ(visits_of(mover), 1);
+}
+
+TEST_F(MobActivity, zones_put_off_by_the_budget_go_first_on_the_next_pulse)
+{
+    const int ZONES = 3 * game_activity::SLEEP_PULSES / 2;
+    const int MOBS = 6;
+    std::map<char_data*, int> zone_of;
+    std::vector<char_data*> players;
+    for (int zone = 0; zone < ZONES; ++zone) {
+        int room = room_in_zone(910 + zone);
+        players.push_back(make_char(room, false));
+        for (int number = 0; number < MOBS; ++number)
+            zone_of[make_char(room, true)] = zone;
+    }
+
+    // Every zone falls asleep on the same pulse, and is due a sleep period
+    // after, with room in the budget for one zone a pulse.
+    game_activity::run_pulse(record_visit);
+    for (char_data* player : players)
+        game_activity::leave_room(player);
+    for (int pulse = 1; pulse < game_activity::WAKE_PULSES + game_activity::SLEEP_PULSES - 1; ++pulse)
+        game_activity::run_pulse(record_visit);
+    mobile_activity_budget = MOBS;
+
+    // One zone is visited each pulse, each the one put off first on the
+    // pulse before, so none waits longer than there are zones.
+    int last_zone = -1;
+    for (int pulse = 0; pulse < 2 * ZONES; ++pulse) {
+        visited.clear();
+        game_activity::run_pulse(record_visit);
+
+        std::vector<int> zones;
+        for (char_data* ch : visited) {
+            if (zone_of.count(ch) && std::find(zones.begin(), zones.end(), zone_of[ch]) == zones.end())
+                zones.push_back(zone_of[ch]);
+        }
+        ASSERT_EQ(zones.size(), 1u) << "pulse " << pulse;
+        if (last_zone >= 0) {
+            EXPECT_EQ(zones[0], (last_zone + 1) % ZONES) << "pulse " << pulse;
+        }
+        last_zone = zones[0];
+    }
+}
@@ -0,0 +1,190 @@
+#include "../structs.h"
+#include "../handler.h"
+#include "../name_index.h"
+#include <gtest/gtest.h>
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+int get_number(char** name);
+
+extern struct char_data* character_list;
+extern struct obj_data* object_list;
+
+namespace {
+// Keywords chosen to share first letters and to abbreviate each other.
+const char* words[] = {
+    "orc", "orcish", "guard", "guardian", "cityguard", "go", "gob", "goblin", "sword", "swordsman",
+    "a", "an", "troll", "tr", "Mr.Smith", "smith", "bob's", "elf", "elves", "eagle"
+};
+const int WORD_COUNT = sizeof(words) / sizeof(words[0]);
+
+std::string random_name()
+{
+    std::string name;
+    for (int word = 1 + rand() % 3; word > 0; --word) {
+        if (!name.empty())
+            name += rand() % 5 ? " " : "-";
+        std::string keyword = words[rand() % WORD_COUNT];
+        if (rand() % 4 == 0)
+            keyword[0] = toupper(keyword[0]);
+        name += keyword;
+    }
+    return name;
+}
+
+std::string random_word()
+{
+    std::string word = words[rand() % WORD_COUNT];
+    if (rand() % 3 == 0)
+        word = word.substr(0, 1 + rand() % word.size());
+    if (rand() % 4 == 0)
+        word = std::to_string(1 + rand() % 4) + "." + word;
+    if (rand() % 6 == 0)
+        word[word.size() - 1] = toupper(word[word.size() - 1]);
+    return word;
+}
+
+// get_char() and get_obj() as they were before the index: isname() on
+// every entity on the list.
+char_data* scan_chars(const std::string& word)
+{
+    std::vector<char> name(word.begin(), word.end());
+    name.push_back(0);
+    char* keyword = &name[0];
+    int number = get_number(&keyword);
+    if (!number)
+        return 0;
+    int found = 1;
+    for (char_data* ch = character_list; ch && found <= number; ch = ch->next)
+        if (isname(keyword, ch->player.name)) {
+            if (found == number)
+                return ch;
+            ++found;
+        }
+    return 0;
+}
+
+obj_data* scan_objs(const std::string& word)
+{
+    std::vector<char> name(word.begin(), word.end());
+    name.push_back(0);
+    char* keyword = &name[0];
+    int number = get_number(&keyword);
+    if (!number)
+        return 0;
+    int found = 1;
+    for (obj_data* obj = object_list; obj && found <= number; obj = obj->next)
+        if (isname(keyword, obj->name)) {
+            if (found == number)
+                return obj;
+            ++found;
+        }
+    return 0;
+}
+
+template <class T>
+void unlink_entity(T*& list, T* entity)
+{
+    if (list == entity) {
+        list = entity->next;
+        return;
+    }
+    T* before = list;
+    while (before->next != entity)
+        before = before->next;
+    before->next = entity->next;
+}
+}
+
+// Adds, extracts, renames and loosens entities at random, and checks that
+// every lookup answers exactly as the old list scan did.
+TEST(NameIndex, lookups_match_the_list_scan)
+{
+    srand(7);
+    std::vector<char_data*> chars;
+    std::vector<obj_data*> objs;
+    int lookups = 0, found = 0;
+
+    for (int step = 0; step < 8000; ++step) {
+        int action = rand() % 10;
+        if (action < 4 || chars.size() < 5) {
+            char_data* ch = (char_data*)calloc(1, sizeof(char_data));
+            ch->player.name = strdup(random_name().c_str());
+            ch->next = character_list;
+            character_list = ch;
+            game_index::add_char(ch);
+            chars.push_back(ch);
+
+            obj_data* obj = (obj_data*)calloc(1, sizeof(obj_data));
+            obj->name = strdup(random_name().c_str());
+            obj->next = object_list;
+            object_list = obj;
+            game_index::add_obj(obj);
+            objs.push_back(obj);
+        } else if (action < 6) {
+            size_t which = rand() % chars.size();
+            game_index::remove_char(chars[which]);
+            unlink_entity(character_list, chars[which]);
+            chars.erase(chars.begin() + which);
+
+            which = rand() % objs.size();
+            game_index::remove_obj(objs[which]);
+            unlink_entity(object_list, objs[which]);
+            objs.erase(objs.begin() + which);
+        } else if (action < 7) {
+            char_data* ch = chars[rand() % chars.size()];
+            if (rand() % 3 == 0) {
+                game_index::loosen_char(ch);
+                ch->player.name = strdup(random_name().c_str());
+            } else {
+                ch->player.name = strdup(random_name().c_str());
+                game_index::rename_char(ch);
+            }
+            obj_data* obj = objs[rand() % objs.size()];
+            if (rand() % 3 == 0) {
+                game_index::loosen_obj(obj);
+                obj->name = strdup(random_name().c_str());
+            } else {
+                obj->name = strdup(random_name().c_str());
+                game_index::rename_obj(obj);
+            }
+        } else {
+            for (int lookup = 0; lookup < 5; ++lookup) {
+                std::string word = random_word();
+                std::vector<char> name(word.begin(), word.end());
+                name.push_back(0);
+
+                char_data* ch = get_char(&name[0]);
+                ASSERT_EQ(ch, scan_chars(word)) << "character '" << word << "'";
+                found += ch != 0;
+
+                name.assign(word.begin(), word.end());
+                name.push_back(0);
+                ASSERT_EQ(get_obj(&name[0]), scan_objs(word)) << "object '" << word << "'";
+                lookups += 2;
+            }
+        }
+    }
+    EXPECT_GT(lookups, 4000);
+    EXPECT_GT(found, 0);
+
+    for (char_data* ch : chars)
+        game_index::remove_char(ch);
+    for (obj_data* obj : objs)
+        game_index::remove_obj(obj);
+    character_list = 0;
+    object_list = 0;
+}
+
+TEST(NameIndex, words_that_are_not_letters_are_not_looked_up)
+{
+    std::vector<char_data*> found;
+    EXPECT_FALSE(game_index::find_chars("2.orc", found));
+    EXPECT_FALSE(game_index::find_chars("bob's", found));
+    EXPECT_FALSE(game_index::find_chars("", found));
+    EXPECT_TRUE(game_index::find_chars("orc", found));
+}
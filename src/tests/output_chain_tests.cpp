@@ -0,0 +1,69 @@
+#include "../output_chain.h"
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <string>
+
+namespace {
+std::string chain_text(const game_net::output_chain& chain)
+{
+    std::string text;
+    for (const game_net::output_segment* segment = chain.head; segment; segment = segment->next)
+        text.append(segment->text, segment->used);
+    return text;
+}
+
+int segment_count(const game_net::output_chain& chain)
+{
+    int count = 0;
+    for (const game_net::output_segment* segment = chain.head; segment; segment = segment->next)
+        ++count;
+    return count;
+}
+}
+
+TEST(OutputChain, appends_across_segments_in_order)
+{
+    game_net::output_chain chain;
+    memset(&chain, 0, sizeof(chain));
+    EXPECT_TRUE(chain.is_empty());
+
+    // Pieces of every size, some larger than a segment.
+    std::string expected;
+    for (int size = 1; size < 3 * game_net::OUTPUT_SEGMENT_SIZE; size += 97) {
+        std::string piece(size, char('a' + size % 26));
+        chain.append(piece.c_str(), size);
+        expected += piece;
+    }
+    chain.append("", 0);
+
+    EXPECT_EQ(chain.length, int(expected.size()));
+    EXPECT_EQ(chain_text(chain), expected);
+    EXPECT_EQ(segment_count(chain),
+        int((expected.size() + game_net::OUTPUT_SEGMENT_SIZE - 1) / game_net::OUTPUT_SEGMENT_SIZE));
+    chain.clear();
+}
+
+TEST(OutputChain, clear_returns_segments_for_reuse)
+{
+    game_net::output_chain chain;
+    memset(&chain, 0, sizeof(chain));
+    std::string text(5 * game_net::OUTPUT_SEGMENT_SIZE, 'x');
+
+    chain.append(text.c_str(), text.size());
+    chain.clear();
+    EXPECT_TRUE(chain.is_empty());
+    EXPECT_EQ(chain.head, (game_net::output_segment*)0);
+    EXPECT_EQ(chain.tail, (game_net::output_segment*)0);
+
+    int allocated = game_net::output_segments.allocated;
+    int pooled = game_net::output_segments.pooled;
+    EXPECT_GE(pooled, 5);
+
+    chain.append(text.c_str(), text.size());
+    EXPECT_EQ(game_net::output_segments.allocated, allocated);
+    EXPECT_EQ(game_net::output_segments.pooled, pooled - 5);
+    EXPECT_EQ(chain_text(chain), text);
+    chain.clear();
+    EXPECT_EQ(game_net::output_segments.pooled, pooled);
+}
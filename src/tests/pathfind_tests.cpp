@@ -0,0 +1,199 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../pathfind.h"
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <vector>
+
+extern struct room_data world;
+extern int top_of_world;
+
+void dummy_room_data(room_data* room);
+
+namespace {
+const int ROOMS = 3000;
+const int ZONE_ROOMS = 100;
+
+bool is_blocked(int room)
+{
+    return IS_SET(world[room].room_flags, NO_MOB | DEATH);
+}
+
+// passable_exit() in pathfind.cpp, with TRACK_THROUGH_DOORS.
+int passable_exit(int room, int dir)
+{
+    room_direction_data* exit = world[room].dir_option[dir];
+    if (!exit || exit->to_room == NOWHERE)
+        return NOWHERE;
+    if (IS_SET(exit->exit_info, EX_LOCKED | EX_ISHIDDEN) && (IS_SET(exit->exit_info, EX_CLOSED) || !IS_SET(exit->exit_info, EX_ISDOOR)))
+        return NOWHERE;
+    return exit->to_room;
+}
+
+int random_door()
+{
+    switch (rand() % 8) {
+    case 0:
+        return EX_ISDOOR | EX_CLOSED | EX_LOCKED;
+    case 1:
+        return EX_ISDOOR | EX_CLOSED;
+    case 2:
+        return EX_ISHIDDEN;
+    default:
+        return 0;
+    }
+}
+
+// Mostly exits within the zone, some to anywhere in the world, a few
+// rooms mobiles may not enter.  Every exit is one-way unless the way back
+// happens to be drawn too.
+void build_world()
+{
+    if (room_data::PAGES == 0)
+        world.create_bulk(ROOMS + 1);
+    top_of_world = ROOMS - 1;
+
+    srand(11);
+    for (int room = 0; room < ROOMS; ++room) {
+        dummy_room_data(&world[room]);
+        world[room].number = room;
+        world[room].zone = room / ZONE_ROOMS;
+        if (rand() % 40 == 0)
+            world[room].room_flags = rand() % 2 ? NO_MOB : DEATH;
+
+        for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+            if (rand() % 3)
+                continue;
+            room_direction_data* exit;
+            CREATE(exit, room_direction_data, 1);
+            exit->key = -1;
+            exit->to_room = rand() % 10 ? world[room].zone * ZONE_ROOMS + rand() % ZONE_ROOMS : rand() % ROOMS;
+            exit->exit_info = random_door();
+            world[room].dir_option[dir] = exit;
+        }
+    }
+    game_path::exits_changed();
+}
+
+void free_world()
+{
+    for (int room = 0; room < ROOMS; ++room)
+        for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+            free(world[room].dir_option[dir]);
+            world[room].dir_option[dir] = 0;
+        }
+    game_path::exits_changed();
+}
+
+// Steps from each room to 'target' by a plain breadth-first search over
+// every room in the world, or -1.  A blocked room may start a path but is
+// never entered.
+std::vector<int> distances_to(int target)
+{
+    std::vector<int> distance(ROOMS, -1);
+    if (is_blocked(target))
+        return distance;
+
+    std::vector<std::vector<int> > into(ROOMS);
+    for (int room = 0; room < ROOMS; ++room)
+        for (int dir = 0; dir < NUM_OF_DIRS; ++dir) {
+            int next = passable_exit(room, dir);
+            if (next != NOWHERE)
+                into[next].push_back(room);
+        }
+
+    std::vector<int> queue(1, target);
+    distance[target] = 0;
+    for (size_t index = 0; index < queue.size(); ++index) {
+        int room = queue[index];
+        if (room != target && is_blocked(room))
+            continue;
+        for (int previous : into[room])
+            if (distance[previous] < 0) {
+                distance[previous] = distance[room] + 1;
+                queue.push_back(previous);
+            }
+    }
+    return distance;
+}
+
+// A shortest path may start in more than one direction, and first_step()
+// need not pick the one a plain search would.  So the answer is checked for
+// what it promises: no path exactly when the plain search finds none, and
+// otherwise a step into an enterable room one step nearer the target.
+void expect_shortest_first_steps(int pairs)
+{
+    for (int pair = 0; pair < pairs; ++pair) {
+        int target = rand() % ROOMS;
+        std::vector<int> distance = distances_to(target);
+        for (int source_count = 0; source_count < 20; ++source_count) {
+            int src = source_count % 2 ? rand() % ROOMS : target / ZONE_ROOMS * ZONE_ROOMS + rand() % ZONE_ROOMS;
+            int step = game_path::first_step(src, target);
+            if (src == target) {
+                ASSERT_EQ(step, BFS_ALREADY_THERE);
+                continue;
+            }
+            if (distance[src] < 0) {
+                ASSERT_EQ(step, BFS_NO_PATH) << src << " to " << target;
+                continue;
+            }
+
+            ASSERT_GE(step, 0) << src << " to " << target;
+            ASSERT_LT(step, NUM_OF_DIRS);
+            int next = passable_exit(src, step);
+            ASSERT_NE(next, NOWHERE) << src << " to " << target;
+            ASSERT_EQ(distance[next], distance[src] - 1) << src << " to " << target;
+            ASSERT_FALSE(is_blocked(next)) << src << " to " << target;
+        }
+    }
+}
+}
+
+TEST(Pathfind, first_steps_lie_on_a_shortest_path)
+{
+    build_world();
+    expect_shortest_first_steps(300);
+
+    // The same pairs again, answered largely from the cache.
+    srand(12);
+    unsigned long hits = game_path::path_totals.cache_hits;
+    expect_shortest_first_steps(300);
+    srand(12);
+    expect_shortest_first_steps(300);
+    EXPECT_GT(game_path::path_totals.cache_hits, hits);
+    free_world();
+}
+
+TEST(Pathfind, doors_and_exits_that_change_are_noticed)
+{
+    build_world();
+    for (int round = 0; round < 20; ++round) {
+        // The same pairs every round, so that stale cached steps are asked for.
+        srand(13);
+        expect_shortest_first_steps(20);
+        if (HasFailure())
+            break;
+
+        // Open, close and lock the doors of a few rooms.
+        srand(100 + round);
+        for (int change = 0; change < 100; ++change) {
+            int room = rand() % ROOMS;
+            for (int dir = 0; dir < NUM_OF_DIRS; ++dir)
+                if (world[room].dir_option[dir])
+                    world[room].dir_option[dir]->exit_info = random_door();
+            game_path::doors_changed(world[room]);
+        }
+
+        // And point a few exits somewhere else.
+        if (round % 4 == 3) {
+            for (int change = 0; change < 50; ++change) {
+                room_direction_data* exit = world[rand() % ROOMS].dir_option[rand() % NUM_OF_DIRS];
+                if (exit)
+                    exit->to_room = rand() % ROOMS;
+            }
+            game_path::exits_changed();
+        }
+    }
+    free_world();
+}
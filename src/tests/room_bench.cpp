@@ -0,0 +1,108 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../zone.h"
+#include "bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern struct room_data world;
+extern struct zone_data* zone_table;
+
+void clear_char(struct char_data* ch, int mode);
+void dummy_room_data(room_data* room);
+void char_from_room(struct char_data* ch);
+void char_to_room(struct char_data* ch, int room);
+
+namespace {
+const int OCCUPANTS = 500;
+
+// room->people as it was before the back links: char_to_room() walked to
+// the tail and char_from_room() walked to the predecessor.
+struct legacy_char {
+    legacy_char* next_in_room;
+};
+
+struct legacy_room {
+    legacy_char* people;
+
+    __attribute__((noinline)) void add(legacy_char* ch)
+    {
+        ch->next_in_room = 0;
+        if (!people) {
+            people = ch;
+            return;
+        }
+        legacy_char* tail = people;
+        while (tail->next_in_room)
+            tail = tail->next_in_room;
+        tail->next_in_room = ch;
+    }
+
+    __attribute__((noinline)) void remove(legacy_char* ch)
+    {
+        if (people == ch) {
+            people = ch->next_in_room;
+            return;
+        }
+        legacy_char* prev = people;
+        while (prev && prev->next_in_room != ch)
+            prev = prev->next_in_room;
+        if (prev)
+            prev->next_in_room = ch->next_in_room;
+    }
+};
+
+std::vector<int> random_occupants()
+{
+    std::vector<int> picks(1 << 16);
+    std::srand(1);
+    for (size_t index = 0; index < picks.size(); ++index)
+        picks[index] = std::rand() % OCCUPANTS;
+    return picks;
+}
+}
+
+// Every pass moves one of the room's 500 occupants out and straight back
+// in, the way a crowd drifts through a busy room.
+BENCHMARK(room_occupancy)
+{
+    if (room_data::PAGES == 0)
+        world.create_bulk(1);
+    if (!zone_table)
+        CREATE(zone_table, zone_data, 1);
+
+    // The benchmarks before this one may have left room 0 in any state.
+    dummy_room_data(&world[0]);
+    std::memset(&zone_table[0], 0, sizeof(zone_data));
+
+    static legacy_room legacy_place;
+    static std::vector<legacy_char> legacy(OCCUPANTS);
+    for (int index = 0; index < OCCUPANTS; ++index)
+        legacy_place.add(&legacy[index]);
+
+    static std::vector<char_data> mobs(OCCUPANTS);
+    for (int index = 0; index < OCCUPANTS; ++index) {
+        clear_char(&mobs[index], 0);
+        SET_BIT(MOB_FLAGS(&mobs[index]), MOB_ISNPC);
+        char_to_room(&mobs[index], 0);
+    }
+
+    std::vector<int> picks = random_occupants();
+    const long mask = long(picks.size()) - 1;
+    const long passes = 2000000;
+
+    bench::report("500 in a room, singly linked", passes, [&](long pass) {
+        legacy_char* ch = &legacy[picks[pass & mask]];
+        legacy_place.remove(ch);
+        legacy_place.add(ch);
+        return long(legacy_place.people != 0);
+    });
+    bench::report("500 in a room, doubly linked", passes, [&](long pass) {
+        char_data* ch = &mobs[picks[pass & mask]];
+        char_from_room(ch);
+        char_to_room(ch, 0);
+        return long(world[0].people != 0);
+    });
+}
@@ -0,0 +1,139 @@
+#include "../save_queue.h"
+#include <gtest/gtest.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Runs each test in a scratch directory.
+class SaveQueue : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(getcwd(m_home, sizeof(m_home)));
+        strcpy(m_scratch, "/tmp/save_queue_testXXXXXX");
+        ASSERT_TRUE(mkdtemp(m_scratch));
+        ASSERT_EQ(chdir(m_scratch), 0);
+    }
+
+    void TearDown() override
+    {
+        game_save::flush();
+        std::string clear = std::string("rm -f ") + m_scratch + "/*";
+        EXPECT_EQ(system(clear.c_str()), 0);
+        if (chdir(m_home) == 0)
+            rmdir(m_scratch);
+    }
+
+    char m_home[PATH_MAX];
+    char m_scratch[64];
+};
+
+void save(const char* path, const std::string& text, const char* stale_pattern = 0)
+{
+    game_save::save_buffer buffer;
+    ASSERT_TRUE(buffer.file());
+    fputs(text.c_str(), buffer.file());
+    buffer.commit(path, stale_pattern);
+}
+
+std::string read_file(const char* path)
+{
+    std::string text;
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return "(missing)";
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        text.append(chunk, length);
+    fclose(file);
+    return text;
+}
+
+bool exists(const char* path)
+{
+    struct stat status;
+    return stat(path, &status) == 0;
+}
+}
+
+TEST_F(SaveQueue, wait_for_returns_once_the_file_is_in_place)
+{
+    save("bilbo", "first");
+    game_save::wait_for("bilbo");
+    EXPECT_EQ(read_file("bilbo"), "first");
+    EXPECT_FALSE(exists("bilbo.tmp"));
+
+    save("bilbo", "second");
+    game_save::wait_for("bilbo");
+    EXPECT_EQ(read_file("bilbo"), "second");
+}
+
+TEST_F(SaveQueue, flush_writes_every_file)
+{
+    char path[32];
+    for (int number = 0; number < 50; ++number) {
+        sprintf(path, "player%d", number);
+        save(path, path);
+    }
+    game_save::flush();
+
+    for (int number = 0; number < 50; ++number) {
+        sprintf(path, "player%d", number);
+        ASSERT_EQ(read_file(path), path);
+    }
+    EXPECT_EQ(game_save::stats().queue_depth, 0);
+}
+
+// Saves of one file queued faster than they can be written leave only the
+// last on disk, and every save is either written or coalesced.
+TEST_F(SaveQueue, later_saves_of_a_file_replace_earlier_ones)
+{
+    game_save::flush();
+    game_save::save_stats before = game_save::stats();
+
+    const int SAVES = 1000;
+    for (int number = 0; number < SAVES; ++number)
+        save("frodo", "save " + std::to_string(number));
+    game_save::flush();
+
+    game_save::save_stats after = game_save::stats();
+    EXPECT_EQ(read_file("frodo"), "save " + std::to_string(SAVES - 1));
+    EXPECT_EQ(after.queued - before.queued, (unsigned long)SAVES);
+    EXPECT_EQ(after.written - before.written + after.coalesced - before.coalesced, (unsigned long)SAVES);
+    EXPECT_GT(after.coalesced, before.coalesced);
+    EXPECT_EQ(after.failed, before.failed);
+}
+
+TEST_F(SaveQueue, stale_files_are_removed_once_the_save_is_written)
+{
+    save("sam.1", "old");
+    save("sam.2", "older");
+    save("samwise", "unrelated");
+    game_save::flush();
+
+    save("sam.3", "new", "sam.*");
+    game_save::wait_for("sam.3");
+    EXPECT_EQ(read_file("sam.3"), "new");
+    EXPECT_FALSE(exists("sam.1"));
+    EXPECT_FALSE(exists("sam.2"));
+    EXPECT_TRUE(exists("samwise"));
+}
+
+TEST_F(SaveQueue, uncommitted_saves_are_thrown_away)
+{
+    save("merry", "kept");
+    game_save::wait_for("merry");
+    {
+        game_save::save_buffer buffer;
+        fputs("half written", buffer.file());
+    }
+    game_save::flush();
+    EXPECT_EQ(read_file("merry"), "kept");
+}
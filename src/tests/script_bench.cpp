@@ -0,0 +1,35 @@
+#include "../structs.h"
+#include "../protos.h"
+#include "../script.h"
+#include "../utils.h"
+#include "bench.h"
+#include "synthetic_scripts.h"
+
+namespace {
+const int SCRIPTS = 200;
+const int STATEMENTS = 12;
+
+long fire(info_script& info, int index, long pass, bool legacy)
+{
+    synthetic_scripts::fire(info, index, int(pass & 15), int((pass >> 4) & 15), legacy);
+    return info.ints[0] + info.ints[1] + info.ints[2];
+}
+}
+
+// Every pass fires the ON_ENTER trigger of one script in the world.
+BENCHMARK(script_triggers)
+{
+    extern struct script_head* script_table;
+    if (!script_table)
+        synthetic_scripts::make_scripts(SCRIPTS, STATEMENTS, false);
+
+    static info_script info;
+    const long passes = 2000000;
+
+    bench::report("script, command list", passes, [&](long pass) {
+        return fire(info, int(pass % SCRIPTS), pass, true);
+    });
+    bench::report("script, compiled", passes, [&](long pass) {
+        return fire(info, int(pass % SCRIPTS), pass, false);
+    });
+}
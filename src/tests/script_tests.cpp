@@ -0,0 +1,42 @@
+#include "../structs.h"
+#include "../protos.h"
+#include "../script.h"
+#include "synthetic_scripts.h"
+#include <gtest/gtest.h>
+
+namespace {
+const int SCRIPTS = 300;
+const int STATEMENTS = 12;
+}
+
+// Every script fired with every pair of small ints must leave the same ints
+// and return the same value through the compiled interpreter as through
+// the command list it was compiled from.
+TEST(Script, compiled_scripts_run_as_the_command_list_did)
+{
+    extern struct script_head* script_table;
+    synthetic_scripts::make_scripts(SCRIPTS, STATEMENTS, true);
+
+    info_script compiled, legacy;
+    int differences = 0;
+    for (int index = 0; index < SCRIPTS; ++index) {
+        for (int int1 = 0; int1 < 16; ++int1) {
+            for (int int2 = 0; int2 < 16; ++int2) {
+                int compiled_result = synthetic_scripts::fire(compiled, index, int1, int2, false);
+                int legacy_result = synthetic_scripts::fire(legacy, index, int1, int2, true);
+                bool same = compiled_result == legacy_result
+                    && compiled.ints[0] == legacy.ints[0]
+                    && compiled.ints[1] == legacy.ints[1]
+                    && compiled.ints[2] == legacy.ints[2];
+                if (!same && ++differences <= 5) {
+                    ADD_FAILURE() << "script " << script_table[index].number << " with " << int1 << ", " << int2
+                                  << ": compiled returned " << compiled_result << " and left "
+                                  << compiled.ints[0] << " " << compiled.ints[1] << " " << compiled.ints[2]
+                                  << ", the command list returned " << legacy_result << " and left "
+                                  << legacy.ints[0] << " " << legacy.ints[1] << " " << legacy.ints[2];
+                }
+            }
+        }
+    }
+    EXPECT_EQ(differences, 0);
+}
@@ -0,0 +1,144 @@
+#include "../send_queue.h"
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+const int LIMIT = 1 << 20;
+
+// A connected pair of sockets; the queue writes to 'sender' without blocking.
+struct socket_pair {
+    int sender, receiver;
+
+    socket_pair()
+    {
+        int ends[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) < 0)
+            ends[0] = ends[1] = -1;
+        sender = ends[0];
+        receiver = ends[1];
+        fcntl(sender, F_SETFL, O_NONBLOCK);
+        fcntl(receiver, F_SETFL, O_NONBLOCK);
+    }
+
+    ~socket_pair()
+    {
+        close(sender);
+        close(receiver);
+    }
+
+    std::string received()
+    {
+        std::string text;
+        char chunk[4096];
+        ssize_t length;
+        while ((length = read(receiver, chunk, sizeof(chunk))) > 0)
+            text.append(chunk, length);
+        return text;
+    }
+};
+
+std::string numbered_text(int number, int size)
+{
+    std::string text;
+    while (int(text.size()) < size)
+        text += std::to_string(number++) + " ";
+    text.resize(size);
+    return text;
+}
+}
+
+TEST(SendQueue, starts_empty_and_zero_filled)
+{
+    game_net::send_queue queue;
+    memset(&queue, 0, sizeof(queue));
+    EXPECT_TRUE(queue.is_empty());
+    EXPECT_TRUE(queue.append("", 0, LIMIT));
+    EXPECT_TRUE(queue.is_empty());
+    queue.release();
+}
+
+TEST(SendQueue, wraps_around_the_ring_in_order)
+{
+    socket_pair sockets;
+    ASSERT_GE(sockets.sender, 0);
+    game_net::send_queue queue;
+    memset(&queue, 0, sizeof(queue));
+
+    // Keep the queue partly full so each append wraps at a new place.
+    std::string sent, expected;
+    for (int round = 0; round < 50; ++round) {
+        std::string text = numbered_text(round * 1000, 700 + round * 37);
+        ASSERT_TRUE(queue.append(text.c_str(), text.size(), LIMIT));
+        expected += text;
+        ASSERT_EQ(queue.flush(sockets.sender), 0);
+        sent += sockets.received();
+    }
+    EXPECT_EQ(sent, expected);
+    EXPECT_TRUE(queue.is_empty());
+    queue.release();
+}
+
+TEST(SendQueue, refuses_to_grow_past_the_limit)
+{
+    game_net::send_queue queue;
+    memset(&queue, 0, sizeof(queue));
+    std::string text(3000, 'x');
+
+    EXPECT_TRUE(queue.append(text.c_str(), text.size(), 5000));
+    EXPECT_FALSE(queue.append(text.c_str(), text.size(), 5000));
+    EXPECT_EQ(queue.length, 3000);
+
+    int size;
+    EXPECT_EQ(queue.reserve(3000, 5000, size), (char*)0);
+    EXPECT_EQ(queue.length, 3000);
+    queue.release();
+}
+
+TEST(SendQueue, reserve_and_commit_queue_in_place)
+{
+    socket_pair sockets;
+    ASSERT_GE(sockets.sender, 0);
+    game_net::send_queue queue;
+    memset(&queue, 0, sizeof(queue));
+
+    queue.append("Hello, ", 7, LIMIT);
+    int size;
+    char* space = queue.reserve(100, LIMIT, size);
+    ASSERT_NE(space, (char*)0);
+    ASSERT_GE(size, 100);
+    memcpy(space, "world.", 6);
+    queue.commit(6);
+
+    EXPECT_EQ(queue.flush(sockets.sender), 0);
+    EXPECT_EQ(sockets.received(), "Hello, world.");
+    queue.release();
+}
+
+TEST(SendQueue, flush_keeps_what_the_socket_will_not_take)
+{
+    socket_pair sockets;
+    ASSERT_GE(sockets.sender, 0);
+    game_net::send_queue queue;
+    memset(&queue, 0, sizeof(queue));
+
+    std::string text = numbered_text(0, 1 << 19);
+    unsigned long stalls = game_net::send_totals.stalls;
+    ASSERT_TRUE(queue.append(text.c_str(), text.size(), LIMIT));
+    int left = queue.flush(sockets.sender);
+    ASSERT_GT(left, 0);
+    EXPECT_EQ(queue.length, left);
+    EXPECT_EQ(game_net::send_totals.stalls, stalls + 1);
+
+    // Drain the other end until the rest goes through.
+    std::string received;
+    while (queue.flush(sockets.sender) > 0)
+        received += sockets.received();
+    received += sockets.received();
+    EXPECT_EQ(received, text);
+    queue.release();
+}
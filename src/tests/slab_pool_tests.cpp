@@ -0,0 +1,100 @@
+#include "../slab_pool.h"
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+struct test_record {
+    int number;
+    char text[100];
+};
+
+const int RECORDS = 2000;
+
+// Pools stay registered for good, so these live as long as the game's.
+game_memory::slab_pool<test_record> fresh_pool("fresh test records");
+game_memory::slab_pool<test_record> reused_pool("reused test records");
+game_memory::slab_pool<test_record> poisoned_pool("poisoned test records");
+
+bool is_zeroed(const test_record* record)
+{
+    const unsigned char* byte = reinterpret_cast<const unsigned char*>(record);
+    for (size_t at = 0; at < sizeof(test_record); ++at)
+        if (byte[at])
+            return false;
+    return true;
+}
+}
+
+TEST(SlabPool, hands_out_distinct_zeroed_objects)
+{
+    game_memory::slab_pool<test_record>& pool = fresh_pool;
+    std::set<test_record*> handed_out;
+    for (int number = 0; number < RECORDS; ++number) {
+        test_record* record = pool.allocate();
+        ASSERT_TRUE(is_zeroed(record));
+        ASSERT_TRUE(handed_out.insert(record).second);
+        record->number = number + 1;
+    }
+
+    game_memory::pool_stats stats = pool.stats();
+    EXPECT_EQ(stats.live, RECORDS);
+    EXPECT_EQ(stats.peak, RECORDS);
+    EXPECT_EQ(stats.allocations, (unsigned long)RECORDS);
+    EXPECT_GT(stats.slabs, 1);
+    EXPECT_EQ(stats.object_size, int(sizeof(test_record)));
+}
+
+TEST(SlabPool, reuses_released_objects_zeroed)
+{
+    game_memory::slab_pool<test_record>& pool = reused_pool;
+    std::vector<test_record*> records;
+    for (int number = 0; number < RECORDS; ++number) {
+        records.push_back(pool.allocate());
+        records.back()->number = number + 1;
+    }
+    int slabs = pool.stats().slabs;
+
+    for (test_record* record : records)
+        pool.release(record);
+    pool.release(0);
+    EXPECT_EQ(pool.stats().live, 0);
+
+    std::set<test_record*> released(records.begin(), records.end());
+    for (int number = 0; number < RECORDS; ++number) {
+        test_record* record = pool.allocate();
+        ASSERT_TRUE(released.count(record));
+        ASSERT_TRUE(is_zeroed(record));
+    }
+    EXPECT_EQ(pool.stats().slabs, slabs);
+    EXPECT_EQ(pool.stats().peak, RECORDS);
+    EXPECT_EQ(pool.stats().allocations, 2UL * RECORDS);
+}
+
+#ifndef NDEBUG
+TEST(SlabPool, poisons_released_objects)
+{
+    game_memory::slab_pool<test_record>& pool = poisoned_pool;
+    test_record* record = pool.allocate();
+    record->number = 42;
+    pool.release(record);
+
+    // Past the free list link the object is all poison.
+    const unsigned char* byte = reinterpret_cast<const unsigned char*>(record);
+    for (size_t at = sizeof(void*); at < sizeof(test_record); ++at)
+        ASSERT_EQ(byte[at], game_memory::POISON_BYTE) << "byte " << at;
+}
+#endif
+
+TEST(SlabPool, game_pools_are_listed)
+{
+    std::set<std::string> names;
+    for (const game_memory::slab_pool_base* pool : game_memory::slab_pool_base::pools())
+        names.insert(pool->stats().name);
+    EXPECT_TRUE(names.count("characters"));
+    EXPECT_TRUE(names.count("objects"));
+    EXPECT_TRUE(names.count("affects"));
+    EXPECT_TRUE(names.count("fresh test records"));
+}
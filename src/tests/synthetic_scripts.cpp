@@ -0,0 +1,191 @@
+#include "synthetic_scripts.h"
+
+#include "../structs.h"
+#include "../protos.h"
+#include "../script.h"
+#include "../utils.h"
+
+#include <cstdlib>
+#include <cstring>
+
+extern struct script_head* script_table;
+extern int top_of_script_table;
+
+int run_script(struct info_script* info, struct script_data* position);
+int* get_int_param(int param, struct info_script* info);
+
+namespace synthetic_scripts {
+namespace {
+    const int ints[] = { SCRIPT_PARAM_INT1, SCRIPT_PARAM_INT2, SCRIPT_PARAM_INT3 };
+
+    // It followed the command list and searched it for the end of each
+    // block an if skipped.
+    script_data* legacy_next_command(script_data* curr)
+    {
+        curr = curr->next;
+        for (; (curr) && ((curr->command_type != SCRIPT_END) && (curr->command_type != SCRIPT_END_ELSE_BEGIN));
+             curr = curr->next)
+            if (curr->command_type == SCRIPT_BEGIN)
+                if (!(curr = legacy_next_command(curr)))
+                    return 0;
+
+        return curr ? curr->next : 0;
+    }
+
+    struct script_writer {
+        script_data* first;
+        script_data* last;
+        bool endings;
+
+        void emit(int command, int param0 = 0, int param1 = 0, int param2 = 0)
+        {
+            script_data* command_data = (script_data*)calloc(1, sizeof(script_data));
+            command_data->command_type = command;
+            command_data->param[0] = param0;
+            command_data->param[1] = param1;
+            command_data->param[2] = param2;
+            command_data->prev = last;
+            if (last)
+                last->next = command_data;
+            else
+                first = command_data;
+            last = command_data;
+        }
+
+        void block(int depth)
+        {
+            emit(SCRIPT_BEGIN);
+            for (int count = 1 + std::rand() % 3; count > 0; --count)
+                statement(depth + 1);
+            if (std::rand() % 2) {
+                emit(SCRIPT_END_ELSE_BEGIN);
+                for (int count = 1 + std::rand() % 3; count > 0; --count)
+                    statement(depth + 1);
+            }
+            emit(SCRIPT_END);
+        }
+
+        void statement(int depth)
+        {
+            if (endings && std::rand() % 40 == 0) {
+                switch (std::rand() % 3) {
+                case 0:
+                    emit(SCRIPT_ABORT);
+                    break;
+                case 1:
+                    emit(SCRIPT_RETURN_FALSE);
+                    break;
+                default:
+                    emit(SCRIPT_IF_INT_LESS, ints[std::rand() % 3], 0);
+                    break;
+                }
+                return;
+            }
+
+            int pick = std::rand() % 6;
+            if (pick >= 4 && depth >= 3)
+                pick = 0;
+
+            switch (pick) {
+            case 0:
+            case 1:
+                emit(SCRIPT_SET_INT_VALUE, std::rand() % 20, ints[std::rand() % 3]);
+                break;
+            case 2:
+            case 3:
+                emit(pick == 2 ? SCRIPT_SET_INT_SUM : SCRIPT_SET_INT_SUB,
+                    ints[std::rand() % 3], ints[std::rand() % 3], ints[std::rand() % 3]);
+                break;
+            default:
+                emit(pick == 4 ? SCRIPT_IF_INT_LESS : SCRIPT_IF_INT_EQUAL, ints[std::rand() % 3], ints[std::rand() % 3]);
+                if (std::rand() % 3)
+                    block(depth);
+                else
+                    statement(depth + 1);
+            }
+        }
+    };
+}
+
+//============================================================================
+void make_scripts(int count, int statements, bool endings)
+{
+    std::srand(1);
+    script_table = (script_head*)calloc(count, sizeof(script_head));
+    for (int index = 0; index < count; ++index) {
+        script_writer writer = { 0, 0, endings };
+        writer.emit(ON_ENTER);
+        for (int statement = 0; statement < statements; ++statement)
+            writer.statement(0);
+        if (endings && index % 4 == 0)
+            writer.emit(SCRIPT_IF_INT_EQUAL, ints[std::rand() % 3], ints[std::rand() % 3]);
+
+        script_table[index].number = index + 1;
+        script_table[index].script = writer.first;
+        compile_script(&script_table[index]);
+    }
+    top_of_script_table = count - 1;
+}
+
+//============================================================================
+int legacy_run_script(info_script* info, script_data* curr)
+{
+    int *a, *b;
+    bool test;
+
+    while (curr) {
+        switch (curr->command_type) {
+        case SCRIPT_ABORT:
+            return 1;
+        case SCRIPT_RETURN_FALSE:
+            return 0;
+        case SCRIPT_SET_INT_VALUE:
+            *get_int_param(curr->param[1], info) = curr->param[0];
+            curr = curr->next;
+            break;
+        case SCRIPT_SET_INT_SUM:
+        case SCRIPT_SET_INT_SUB:
+            a = get_int_param(curr->param[1], info);
+            b = get_int_param(curr->param[2], info);
+            *get_int_param(curr->param[0], info) = curr->command_type == SCRIPT_SET_INT_SUM ? *a + *b : *a - *b;
+            curr = curr->next;
+            break;
+        case SCRIPT_IF_INT_LESS:
+        case SCRIPT_IF_INT_EQUAL:
+            if (!curr->param[0] || !curr->param[1])
+                return 1;
+            a = get_int_param(curr->param[0], info);
+            b = get_int_param(curr->param[1], info);
+            test = curr->command_type == SCRIPT_IF_INT_LESS ? *a < *b : *a == *b;
+            if (test)
+                curr = curr->next;
+            else if (!curr->next)
+                return 1;
+            else if (curr->next->command_type == SCRIPT_BEGIN)
+                curr = legacy_next_command(curr->next);
+            else
+                curr = curr->next->next;
+            break;
+        case SCRIPT_END_ELSE_BEGIN:
+            curr = legacy_next_command(curr);
+            break;
+        default:
+            curr = curr->next;
+            break;
+        }
+    }
+    return 1;
+}
+
+//============================================================================
+int fire(info_script& info, int index, int int1, int int2, bool legacy)
+{
+    memset(&info, 0, sizeof(info));
+    info.index = index;
+    info.ints[0] = int1;
+    info.ints[1] = int2;
+
+    script_data* entry = script_table[index].trigger[ON_ENTER]->next;
+    return legacy ? legacy_run_script(&info, entry) : run_script(&info, entry);
+}
+}
@@ -0,0 +1,30 @@
+// Scripts made up at random from the commands whose control flow the
+// compiled interpreter resolves ahead of time: integer arithmetic, ifs with
+// and without blocks, elses, and the commands that end a script early.  Used
+// by the script benchmark and by the tests that hold the compiled
+// interpreter to the command-list one it replaced.
+
+#ifndef SYNTHETIC_SCRIPTS_H
+#define SYNTHETIC_SCRIPTS_H
+
+struct info_script;
+struct script_data;
+
+namespace synthetic_scripts {
+// Fills script_table with 'count' compiled scripts of 'statements'
+// statements each, in their ON_ENTER triggers.  With 'endings', scripts may
+// also abort, return false, or stop at an if that is missing a parameter
+// or has nothing after it.
+void make_scripts(int count, int statements, bool endings);
+
+// run_script() as it was before scripts were compiled, for the commands
+// make_scripts() uses.  Returns what it returned.
+int legacy_run_script(info_script* info, script_data* curr);
+
+// Fires the ON_ENTER trigger of script 'index' with the first two ints set
+// to 'int1' and 'int2', through the compiled interpreter or the legacy one.
+// Leaves the ints the script computed in 'info'.
+int fire(info_script& info, int index, int int1, int int2, bool legacy);
+}
+
+#endif /* SYNTHETIC_SCRIPTS_H */
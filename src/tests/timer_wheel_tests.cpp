@@ -0,0 +1,139 @@
+#include "../structs.h"
+#include "../skill_timer.h"
+#include "../spells.h"
+#include "../timer_wheel.h"
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+
+extern struct weather_data weather_info;
+extern struct room_data world;
+
+using game_timer::timer_handle;
+using game_timer::timer_wheel;
+
+TEST(TimerWheel, expires_after_the_delay)
+{
+    timer_wheel wheel;
+    timer_handle handle = wheel.schedule(3, 42);
+    EXPECT_TRUE(wheel.pending(handle));
+    EXPECT_EQ(wheel.remaining(handle), 3);
+    EXPECT_EQ(wheel.size(), 1);
+
+    unsigned long long key;
+    for (int tick = 0; tick < 2; ++tick) {
+        wheel.advance();
+        EXPECT_FALSE(wheel.next_expired(key));
+    }
+    wheel.advance();
+    EXPECT_EQ(wheel.remaining(handle), 0);
+    ASSERT_TRUE(wheel.next_expired(key));
+    EXPECT_EQ(key, 42u);
+    EXPECT_FALSE(wheel.next_expired(key));
+    EXPECT_FALSE(wheel.pending(handle));
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TimerWheel, short_and_long_delays_are_cut_to_fit)
+{
+    timer_wheel wheel;
+    timer_handle soon = wheel.schedule(-5, 1);
+    const int span = timer_wheel::SPAN;
+    timer_handle late = wheel.schedule(span + 1000, 2);
+    EXPECT_EQ(wheel.remaining(soon), 1);
+    EXPECT_EQ(wheel.remaining(late), span);
+}
+
+TEST(TimerWheel, cancelled_handles_stay_cancelled)
+{
+    timer_wheel wheel;
+    timer_handle handle = wheel.schedule(1, 7);
+    EXPECT_TRUE(wheel.cancel(handle));
+    EXPECT_FALSE(wheel.cancel(handle));
+    EXPECT_EQ(wheel.remaining(handle), -1);
+
+    // The node is reused, but the old handle must not name it.
+    timer_handle copy = wheel.schedule(1, 8);
+    timer_handle stale;
+    stale.index = copy.index;
+    stale.serial = copy.serial - 1;
+    EXPECT_FALSE(wheel.pending(stale));
+    EXPECT_FALSE(wheel.cancel(stale));
+    EXPECT_TRUE(wheel.pending(copy));
+
+    unsigned long long key;
+    wheel.advance();
+    ASSERT_TRUE(wheel.next_expired(key));
+    EXPECT_EQ(key, 8u);
+}
+
+// Schedules and cancels at random across every ring, and checks that each
+// key expires on exactly the tick it was due and no other.
+TEST(TimerWheel, matches_a_sorted_map)
+{
+    timer_wheel wheel;
+    std::map<unsigned long long, std::pair<unsigned int, timer_handle>> waiting;
+    unsigned long long next_key = 0;
+    srand(3);
+
+    for (int tick = 0; tick < 100000; ++tick) {
+        for (int count = rand() % 3; count > 0; --count) {
+            int delay = rand() % 4 == 0 ? rand() % 300000 : rand() % 100;
+            timer_handle handle = wheel.schedule(delay, next_key);
+            waiting[next_key++] = std::make_pair(wheel.now() + (delay < 1 ? 1 : delay), handle);
+        }
+        if (rand() % 5 == 0 && !waiting.empty()) {
+            auto found = waiting.lower_bound(rand() % next_key);
+            if (found != waiting.end()) {
+                ASSERT_TRUE(wheel.cancel(found->second.second));
+                waiting.erase(found);
+            }
+        }
+
+        wheel.advance();
+        unsigned long long key;
+        while (wheel.next_expired(key)) {
+            auto found = waiting.find(key);
+            ASSERT_NE(found, waiting.end()) << "key " << key;
+            ASSERT_EQ(found->second.first, wheel.now()) << "key " << key;
+            waiting.erase(found);
+        }
+        ASSERT_EQ(wheel.size(), int(waiting.size()));
+
+        if (tick % 1000 == 0) {
+            for (auto& entry : waiting)
+                ASSERT_EQ(wheel.remaining(entry.second.second), int(entry.second.first - wheel.now()));
+        }
+    }
+}
+
+// A cooldown set again before it runs out lasts as long as the new counter
+// says, and is not ended early by the expiry it replaced.
+TEST(TimerWheel, restarted_cooldowns_run_their_new_course)
+{
+    game_timer::skill_timer::create(weather_info, &world);
+    game_timer::skill_timer& timer = game_timer::skill_timer::instance();
+    char_data* ch = new char_data();
+    ch->specials2.idnum = 77;
+
+    timer.add_cooldown(77, SKILL_SLASH, 2);
+    timer.update_skill_timer();
+    timer.add_cooldown(77, SKILL_SLASH, 10);
+
+    for (int second = 0; second < 10; ++second) {
+        timer.update_skill_timer();
+        ASSERT_FALSE(timer.is_skill_allowed(*ch, SKILL_SLASH)) << "second " << second;
+
+        char report[MAX_STRING_LENGTH];
+        *report = 0;
+        timer.report_skill_status(77, report);
+        ASSERT_NE(strstr(report, "(seconds)"), (char*)0);
+        ASSERT_EQ(strchr(report, '-'), (char*)0) << report;
+    }
+    timer.update_skill_timer();
+    EXPECT_TRUE(timer.is_skill_allowed(*ch, SKILL_SLASH));
+    delete ch;
+}
@@ -0,0 +1,125 @@
+#include "../vnum_index.h"
+#include "bench.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+const int ZONES = 200;
+const int COMMANDS_PER_ZONE = 60;
+
+// A world shaped like ours: each zone owns a block of 100 virtual numbers
+// and uses some of them.
+struct vnum_table {
+    std::vector<int> vnums; // ascending, like world, mob_index and obj_index
+    game_index::vnum_index index;
+};
+
+void fill_table(vnum_table& table, int per_zone)
+{
+    for (int zone = 0; zone < ZONES; ++zone)
+        for (int number = 0; number < per_zone; ++number)
+            table.vnums.push_back(zone * 100 + number * (100 / per_zone));
+
+    table.index.reset(int(table.vnums.size()));
+    for (size_t position = 0; position < table.vnums.size(); ++position)
+        table.index.insert(table.vnums[position], int(position));
+}
+
+// real_room(), real_mobile() and real_object() before the indexes.
+int binary_search(const std::vector<int>& vnums, int virt)
+{
+    int bot = 0;
+    int top = int(vnums.size()) - 1;
+    for (;;) {
+        int mid = (bot + top) / 2;
+        if (vnums[mid] == virt)
+            return mid;
+        if (bot >= top)
+            return -1;
+        if (vnums[mid] > virt)
+            top = mid - 1;
+        else
+            bot = mid + 1;
+    }
+}
+
+// find_script_by_number() before the indexes.
+int linear_search(const std::vector<int>& vnums, int number)
+{
+    for (size_t position = 0; position < vnums.size(); ++position)
+        if (vnums[position] == number)
+            return int(position);
+    return -1;
+}
+
+// One line of a zone file, reduced to the numbers a reset resolves: 'M'
+// loads a mobile into a room and runs its script, 'O' loads an object into
+// a room, 'G' and 'E' give or equip the last mobile with an object.
+struct reset_command {
+    char command;
+    int mobile;
+    int object;
+    int room;
+    int script;
+};
+
+std::vector<reset_command> build_storm(const vnum_table& rooms, const vnum_table& mobiles,
+    const vnum_table& objects, const vnum_table& scripts)
+{
+    const char commands[] = "MOGE";
+    std::vector<reset_command> storm;
+    std::srand(1);
+    for (int zone = 0; zone < ZONES; ++zone) {
+        for (int line = 0; line < COMMANDS_PER_ZONE; ++line) {
+            reset_command reset;
+            reset.command = commands[std::rand() % 4];
+            reset.room = rooms.vnums[std::rand() % rooms.vnums.size()];
+            reset.mobile = mobiles.vnums[std::rand() % mobiles.vnums.size()];
+            reset.object = objects.vnums[std::rand() % objects.vnums.size()];
+            reset.script = scripts.vnums[std::rand() % scripts.vnums.size()];
+            storm.push_back(reset);
+        }
+    }
+    return storm;
+}
+}
+
+BENCHMARK(zone_reset_storm)
+{
+    vnum_table rooms, mobiles, objects, scripts;
+    fill_table(rooms, 100);
+    fill_table(mobiles, 20);
+    fill_table(objects, 25);
+    fill_table(scripts, 4);
+
+    std::vector<reset_command> storm = build_storm(rooms, mobiles, objects, scripts);
+    const long storms = 200;
+    const long lines = long(storm.size());
+
+    bench::report("one reset command, sorted search", storms * lines, [&](long pass) {
+        const reset_command& reset = storm[pass % lines];
+        switch (reset.command) {
+        case 'M':
+            return binary_search(mobiles.vnums, reset.mobile) + binary_search(rooms.vnums, reset.room)
+                + linear_search(scripts.vnums, reset.script);
+        case 'O':
+            return binary_search(objects.vnums, reset.object) + binary_search(rooms.vnums, reset.room);
+        default:
+            return binary_search(objects.vnums, reset.object);
+        }
+    });
+
+    bench::report("one reset command, vnum index", storms * lines, [&](long pass) {
+        const reset_command& reset = storm[pass % lines];
+        switch (reset.command) {
+        case 'M':
+            return mobiles.index.find(reset.mobile) + rooms.index.find(reset.room)
+                + scripts.index.find(reset.script);
+        case 'O':
+            return objects.index.find(reset.object) + rooms.index.find(reset.room);
+        default:
+            return objects.index.find(reset.object);
+        }
+    });
+}
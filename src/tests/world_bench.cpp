@@ -0,0 +1,107 @@
+#include "../structs.h"
+#include "bench.h"
+
+#include <cstdlib>
+#include <vector>
+
+extern struct room_data world;
+
+namespace {
+const int BASE_ROOMS = 20000;
+const int OLC_ROOMS = 1000;
+const int TOTAL_ROOMS = BASE_ROOMS + OLC_ROOMS;
+
+// world[] as it was before rooms were paged: one array for the rooms loaded
+// at boot, then a chain of EXTENSION_SIZE blocks for rooms added by OLC.
+// The lookup lived out of line in db.cpp, so it is kept out of line here.
+struct legacy_block {
+    room_data* rooms;
+    legacy_block* next;
+};
+
+struct legacy_world {
+    room_data* base;
+    int base_length;
+    legacy_block* extension;
+
+    __attribute__((noinline)) room_data& operator[](int i)
+    {
+        if (i < 0)
+            return *base;
+
+        if (i >= base_length) {
+            int offset = i - base_length;
+            legacy_block* ext = extension;
+            while (ext && offset >= EXTENSION_SIZE) {
+                ext = ext->next;
+                offset -= EXTENSION_SIZE;
+            }
+            return ext ? ext->rooms[offset] : *base;
+        }
+
+        return base[i];
+    }
+};
+
+legacy_world build_legacy()
+{
+    legacy_world legacy;
+    legacy.base = new room_data[BASE_ROOMS];
+    legacy.base_length = BASE_ROOMS;
+    legacy.extension = 0;
+
+    legacy_block** tail = &legacy.extension;
+    for (int added = 0; added < OLC_ROOMS; added += EXTENSION_SIZE) {
+        *tail = new legacy_block;
+        (*tail)->rooms = new room_data[EXTENSION_SIZE];
+        (*tail)->next = 0;
+        tail = &(*tail)->next;
+    }
+    return legacy;
+}
+
+std::vector<int> random_rooms(int low, int high)
+{
+    std::vector<int> rooms(1 << 16);
+    std::srand(1);
+    for (size_t index = 0; index < rooms.size(); ++index)
+        rooms[index] = low + std::rand() % (high - low);
+    return rooms;
+}
+}
+
+BENCHMARK(world_access)
+{
+    static legacy_world legacy = build_legacy();
+    if (room_data::PAGES == 0) {
+        world.create_bulk(BASE_ROOMS);
+        world.grow(OLC_ROOMS);
+    }
+
+    std::vector<int> any_room = random_rooms(0, TOTAL_ROOMS);
+    std::vector<int> olc_room = random_rooms(BASE_ROOMS, TOTAL_ROOMS);
+    const long mask = long(any_room.size()) - 1;
+    const long passes = 20000000;
+
+    int room = 0;
+    bench::report("sequential, extension chain", passes, [&](long) {
+        room = room + 1 < TOTAL_ROOMS ? room + 1 : 0;
+        return legacy[room].number;
+    });
+    bench::report("sequential, paged", passes, [&](long) {
+        room = room + 1 < TOTAL_ROOMS ? room + 1 : 0;
+        return world[room].number;
+    });
+    bench::report("random, extension chain", passes, [&](long pass) {
+        return legacy[any_room[pass & mask]].number;
+    });
+    bench::report("random, paged", passes, [&](long pass) {
+        return world[any_room[pass & mask]].number;
+    });
+    bench::report("OLC rooms only, extension chain", passes, [&](long pass) {
+        return legacy[olc_room[pass & mask]].number;
+    });
+    bench::report("OLC rooms only, paged", passes, [&](long pass) {
+        return world[olc_room[pass & mask]].number;
+    });
+}
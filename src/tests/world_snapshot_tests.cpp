@@ -0,0 +1,233 @@
+#include "../structs.h"
+#include "../utils.h"
+#include "../db.h"
+#include "../area_files.h"
+#include "../world_snapshot.h"
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+void clear_char(struct char_data* ch, int mode);
+void clear_object(struct obj_data* obj);
+
+namespace {
+const char* TEST_FILE = "world_snapshot_test";
+const int PROTOTYPES = 50;
+const unsigned long long KEY = 12345;
+
+char* copy_of(const std::string& text)
+{
+    char* copy;
+    CREATE(copy, char, text.size() + 1);
+    strcpy(copy, text.c_str());
+    return copy;
+}
+
+// Objects as load_objects() leaves them: a few with no action description,
+// some with extra descriptions.
+void make_objects(std::vector<obj_data>& protos, std::vector<index_data>& index)
+{
+    protos.resize(PROTOTYPES);
+    index.resize(PROTOTYPES);
+    for (int nr = 0; nr < PROTOTYPES; ++nr) {
+        obj_data& proto = protos[nr];
+        clear_object(&proto);
+        index[nr].virt = 1000 + nr;
+        proto.name = copy_of("sword " + std::to_string(nr));
+        proto.short_description = copy_of("a sword");
+        proto.description = copy_of("A sword lies here.");
+        proto.action_description = nr % 3 ? copy_of("") : 0;
+        proto.obj_flags.type_flag = ITEM_WEAPON;
+        proto.obj_flags.value[0] = nr;
+        proto.obj_flags.weight = 10 + nr;
+        proto.affected[0].location = APPLY_OB;
+        proto.affected[0].modifier = nr % 5;
+        proto.item_number = nr;
+
+        for (int descr = nr % 4; descr > 0; --descr) {
+            extra_descr_data* extra;
+            CREATE(extra, struct extra_descr_data, 1);
+            extra->keyword = copy_of("rune " + std::to_string(descr));
+            extra->description = copy_of("It glows.");
+            extra->next = proto.ex_description;
+            proto.ex_description = extra;
+        }
+    }
+}
+
+void expect_same_object(const obj_data& read, const obj_data& parsed)
+{
+    EXPECT_STREQ(read.name, parsed.name);
+    EXPECT_STREQ(read.short_description, parsed.short_description);
+    EXPECT_STREQ(read.description, parsed.description);
+    if (parsed.action_description)
+        EXPECT_STREQ(read.action_description, parsed.action_description);
+    else
+        EXPECT_EQ(read.action_description, (char*)0);
+    EXPECT_NE(read.name, parsed.name);
+    EXPECT_EQ(memcmp(&read.obj_flags, &parsed.obj_flags, sizeof(parsed.obj_flags)), 0);
+    EXPECT_EQ(memcmp(read.affected, parsed.affected, sizeof(parsed.affected)), 0);
+    EXPECT_EQ(read.item_number, parsed.item_number);
+    EXPECT_EQ(read.in_room, NOWHERE);
+
+    const extra_descr_data* read_extra = read.ex_description;
+    for (const extra_descr_data* extra = parsed.ex_description; extra; extra = extra->next) {
+        ASSERT_NE(read_extra, (extra_descr_data*)0);
+        EXPECT_STREQ(read_extra->keyword, extra->keyword);
+        EXPECT_STREQ(read_extra->description, extra->description);
+        read_extra = read_extra->next;
+    }
+    EXPECT_EQ(read_extra, (extra_descr_data*)0);
+}
+
+std::string read_file(const char* path)
+{
+    std::string text;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return text;
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        text.append(chunk, length);
+    fclose(file);
+    return text;
+}
+
+void write_file(const char* path, const std::string& text)
+{
+    FILE* file = fopen(path, "wb");
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+}
+}
+
+TEST(WorldSnapshot, objects_read_back_as_written)
+{
+    std::vector<obj_data> parsed;
+    std::vector<index_data> parsed_index;
+    make_objects(parsed, parsed_index);
+    ASSERT_TRUE(game_boot::write_objects(TEST_FILE, KEY, &parsed[0], &parsed_index[0], PROTOTYPES));
+
+    std::vector<obj_data> read(PROTOTYPES + 1);
+    std::vector<index_data> read_index(PROTOTYPES + 1);
+    ASSERT_EQ(game_boot::read_objects(TEST_FILE, KEY, &read[0], &read_index[0], PROTOTYPES + 1), PROTOTYPES);
+    unlink(TEST_FILE);
+
+    for (int nr = 0; nr < PROTOTYPES; ++nr) {
+        EXPECT_EQ(read_index[nr].virt, parsed_index[nr].virt);
+        EXPECT_EQ(read_index[nr].number, 0);
+        expect_same_object(read[nr], parsed[nr]);
+    }
+}
+
+TEST(WorldSnapshot, mobiles_read_back_as_written)
+{
+    std::vector<char_data> parsed(PROTOTYPES);
+    std::vector<index_data> parsed_index(PROTOTYPES);
+    for (int nr = 0; nr < PROTOTYPES; ++nr) {
+        char_data& proto = parsed[nr];
+        clear_char(&proto, MOB_ISNPC);
+        parsed_index[nr].virt = 2000 + nr;
+        proto.player.name = copy_of("orc " + std::to_string(nr));
+        proto.player.short_descr = copy_of("an orc");
+        proto.player.long_descr = copy_of("An orc snarls here.");
+        proto.player.description = copy_of("");
+        CREATE(proto.player.title, char, 1);
+        proto.player.death_cry = nr % 2 ? copy_of("$n shrieks.") : 0;
+        proto.player.level = nr;
+        proto.abilities.hit = 100 + nr;
+        proto.profs->prof_level[1] = nr;
+        proto.nr = nr;
+        SET_BIT(MOB_FLAGS(&proto), MOB_ISNPC);
+    }
+    ASSERT_TRUE(game_boot::write_mobiles(TEST_FILE, KEY, &parsed[0], &parsed_index[0], PROTOTYPES));
+
+    std::vector<char_data> read(PROTOTYPES);
+    std::vector<index_data> read_index(PROTOTYPES);
+    ASSERT_EQ(game_boot::read_mobiles(TEST_FILE, KEY, &read[0], &read_index[0], PROTOTYPES), PROTOTYPES);
+    unlink(TEST_FILE);
+
+    for (int nr = 0; nr < PROTOTYPES; ++nr) {
+        EXPECT_EQ(read_index[nr].virt, 2000 + nr);
+        EXPECT_STREQ(read[nr].player.name, parsed[nr].player.name);
+        EXPECT_STREQ(read[nr].player.short_descr, parsed[nr].player.short_descr);
+        EXPECT_STREQ(read[nr].player.long_descr, parsed[nr].player.long_descr);
+        EXPECT_STREQ(read[nr].player.description, parsed[nr].player.description);
+        EXPECT_STREQ(read[nr].player.title, "");
+        if (nr % 2)
+            EXPECT_STREQ(read[nr].player.death_cry, parsed[nr].player.death_cry);
+        else
+            EXPECT_EQ(read[nr].player.death_cry, (char*)0);
+        EXPECT_EQ(read[nr].player.death_cry2, (char*)0);
+        EXPECT_EQ(read[nr].player.level, nr);
+        EXPECT_EQ(read[nr].abilities.hit, 100 + nr);
+        EXPECT_EQ(read[nr].nr, nr);
+        ASSERT_NE(read[nr].profs, parsed[nr].profs);
+        EXPECT_EQ(read[nr].profs->prof_level[1], nr);
+        EXPECT_TRUE(IS_NPC(&read[nr]));
+    }
+}
+
+// A snapshot from other area files, too big for the table, cut short or
+// altered must be turned down without touching the table.
+TEST(WorldSnapshot, unusable_snapshots_leave_the_table_alone)
+{
+    std::vector<obj_data> parsed;
+    std::vector<index_data> parsed_index;
+    make_objects(parsed, parsed_index);
+    ASSERT_TRUE(game_boot::write_objects(TEST_FILE, KEY, &parsed[0], &parsed_index[0], PROTOTYPES));
+    std::string snapshot = read_file(TEST_FILE);
+
+    std::vector<obj_data> table(PROTOTYPES);
+    std::vector<index_data> table_index(PROTOTYPES);
+    memset((void*)&table[0], 0, sizeof(obj_data) * PROTOTYPES);
+    memset(&table_index[0], 0, sizeof(index_data) * PROTOTYPES);
+
+    EXPECT_EQ(game_boot::read_objects(TEST_FILE, KEY + 1, &table[0], &table_index[0], PROTOTYPES), -1);
+    EXPECT_EQ(game_boot::read_objects(TEST_FILE, KEY, &table[0], &table_index[0], PROTOTYPES - 1), -1);
+    EXPECT_EQ(game_boot::read_mobiles(TEST_FILE, KEY, 0, 0, PROTOTYPES), -1);
+
+    write_file(TEST_FILE, snapshot.substr(0, snapshot.size() - 10));
+    EXPECT_EQ(game_boot::read_objects(TEST_FILE, KEY, &table[0], &table_index[0], PROTOTYPES), -1);
+
+    std::string altered = snapshot;
+    altered[altered.size() / 2] ^= 1;
+    write_file(TEST_FILE, altered);
+    EXPECT_EQ(game_boot::read_objects(TEST_FILE, KEY, &table[0], &table_index[0], PROTOTYPES), -1);
+
+    unlink(TEST_FILE);
+    EXPECT_EQ(game_boot::read_objects(TEST_FILE, KEY, &table[0], &table_index[0], PROTOTYPES), -1);
+
+    for (int nr = 0; nr < PROTOTYPES; ++nr) {
+        EXPECT_EQ(table[nr].name, (char*)0);
+        EXPECT_EQ(table_index[nr].virt, 0);
+    }
+}
+
+TEST(WorldSnapshot, key_follows_the_area_files_and_build)
+{
+    game_boot::area_directory areas;
+    game_boot::area_file file;
+    file.path = "world/obj/1.obj";
+    file.data = 0;
+    file.length = 0;
+    file.records = 0;
+    file.digest = 1;
+    areas.files.push_back(file);
+
+    unsigned long long key = game_boot::snapshot_key(areas, "build", 0);
+    EXPECT_EQ(game_boot::snapshot_key(areas, "build", 0), key);
+    EXPECT_NE(game_boot::snapshot_key(areas, "other build", 0), key);
+    EXPECT_NE(game_boot::snapshot_key(areas, "build", 1), key);
+
+    areas.files[0].digest = 2;
+    EXPECT_NE(game_boot::snapshot_key(areas, "build", 0), key);
+    areas.files[0].digest = 1;
+    areas.files[0].path = "world/obj/2.obj";
+    EXPECT_NE(game_boot::snapshot_key(areas, "build", 0), key);
+}
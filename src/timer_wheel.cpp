@@ -0,0 +1,185 @@
+/* timer_wheel.cpp */
+
+#include "timer_wheel.h"
+
+namespace game_timer {
+//============================================================================
+timer_wheel::timer_wheel()
+    : m_free(-1)
+    , m_now(0)
+    , m_size(0)
+{
+    for (int list = 0; list <= EXPIRED; ++list)
+        m_heads[list] = -1;
+}
+
+//============================================================================
+timer_handle timer_wheel::schedule(int delay, unsigned long long key)
+{
+    if (delay < 1)
+        delay = 1;
+    else if (delay > SPAN)
+        delay = SPAN;
+
+    int index;
+    if (m_free >= 0) {
+        index = m_free;
+        m_free = m_nodes[index].next;
+    } else {
+        index = int(m_nodes.size());
+        m_nodes.push_back(node());
+        m_nodes[index].serial = 0;
+    }
+
+    node& entry = m_nodes[index];
+    entry.key = key;
+    entry.expires = m_now + delay;
+    ++entry.serial;
+    file(index);
+    ++m_size;
+
+    timer_handle handle;
+    handle.index = index;
+    handle.serial = entry.serial;
+    return handle;
+}
+
+//============================================================================
+bool timer_wheel::cancel(timer_handle& handle)
+{
+    bool cancelled = false;
+    if (find(handle)) {
+        unlink(handle.index);
+        release(handle.index);
+        cancelled = true;
+    }
+    handle = timer_handle();
+    return cancelled;
+}
+
+//============================================================================
+bool timer_wheel::pending(const timer_handle& handle) const
+{
+    return find(handle) != 0;
+}
+
+//============================================================================
+int timer_wheel::remaining(const timer_handle& handle) const
+{
+    const node* entry = find(handle);
+    if (!entry)
+        return -1;
+    if (entry->list == EXPIRED)
+        return 0;
+    return int(entry->expires - m_now);
+}
+
+//============================================================================
+void timer_wheel::advance()
+{
+    ++m_now;
+
+    // Spill each ring whose slot the clock has just reached, top down, so
+    // that what is due now ends up in ring 0.
+    int level = 1;
+    while (level < LEVELS && !(m_now & ((1u << (LEVEL_BITS * level)) - 1)))
+        ++level;
+    while (--level > 0)
+        cascade(level);
+
+    int slot = m_now & (SLOTS - 1);
+    while (m_heads[slot] >= 0) {
+        int index = m_heads[slot];
+        unlink(index);
+        link(index, EXPIRED);
+    }
+}
+
+//============================================================================
+bool timer_wheel::next_expired(unsigned long long& key)
+{
+    int index = m_heads[EXPIRED];
+    if (index < 0)
+        return false;
+
+    key = m_nodes[index].key;
+    unlink(index);
+    release(index);
+    return true;
+}
+
+//============================================================================
+const timer_wheel::node* timer_wheel::find(const timer_handle& handle) const
+{
+    if (handle.index < 0 || handle.index >= int(m_nodes.size()))
+        return 0;
+
+    const node& entry = m_nodes[handle.index];
+    if (entry.list == FREE || entry.serial != handle.serial)
+        return 0;
+    return &entry;
+}
+
+//============================================================================
+// Puts a node in the slot of the lowest ring that reaches its expiry.
+void timer_wheel::file(int index)
+{
+    unsigned int expires = m_nodes[index].expires;
+    unsigned int delta = expires - m_now;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1u << (LEVEL_BITS * (level + 1))))
+        ++level;
+
+    int slot = (expires >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    link(index, level * SLOTS + slot);
+}
+
+//============================================================================
+void timer_wheel::link(int index, int list)
+{
+    node& entry = m_nodes[index];
+    entry.list = list;
+    entry.prev = -1;
+    entry.next = m_heads[list];
+    if (entry.next >= 0)
+        m_nodes[entry.next].prev = index;
+    m_heads[list] = index;
+}
+
+//============================================================================
+void timer_wheel::unlink(int index)
+{
+    node& entry = m_nodes[index];
+    if (entry.prev >= 0)
+        m_nodes[entry.prev].next = entry.next;
+    else
+        m_heads[entry.list] = entry.next;
+    if (entry.next >= 0)
+        m_nodes[entry.next].prev = entry.prev;
+}
+
+//============================================================================
+void timer_wheel::release(int index)
+{
+    node& entry = m_nodes[index];
+    entry.list = FREE;
+    entry.next = m_free;
+    m_free = index;
+    --m_size;
+}
+
+//============================================================================
+// Refiles the slot of 'level' that the clock has reached.
+void timer_wheel::cascade(int level)
+{
+    int list = level * SLOTS + ((m_now >> (LEVEL_BITS * level)) & (SLOTS - 1));
+    int index = m_heads[list];
+    m_heads[list] = -1;
+    while (index >= 0) {
+        int next = m_nodes[index].next;
+        file(index);
+        index = next;
+    }
+}
+}
@@ -0,0 +1,96 @@
+/* timer_wheel.h */
+// A hierarchical timing wheel: things that wait some number of ticks are
+// filed by when they are due, so that moving the clock on costs time in
+// proportion to what expires rather than to everything that is waiting.
+//
+// The wheel has LEVELS rings of SLOTS slots.  Ring 0 holds what is due in
+// the next SLOTS ticks, one slot per tick; each ring above covers SLOTS
+// times the span of the one below, and its slots are spilled into the lower
+// rings as the clock reaches them.
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+#pragma once
+
+#include <vector>
+
+namespace game_timer {
+// Names one scheduled expiry.  A handle whose expiry has fired or has been
+// cancelled is no longer pending; it is safe to cancel it again.
+struct timer_handle {
+    int index;
+    unsigned int serial;
+
+    timer_handle()
+        : index(-1)
+        , serial(0)
+    {
+    }
+};
+
+class timer_wheel {
+public:
+    timer_wheel();
+
+    // Schedules 'key' to expire after 'delay' ticks, or after one tick if
+    // 'delay' is smaller.  Delays past the wheel's span are cut to fit.
+    timer_handle schedule(int delay, unsigned long long key);
+
+    // Cancels the expiry named by 'handle', if it is pending, and clears
+    // the handle.  Returns true if something was cancelled.
+    bool cancel(timer_handle& handle);
+
+    bool pending(const timer_handle& handle) const;
+
+    // Ticks until the expiry named by 'handle' fires, or -1 if it is not
+    // pending.  Expired keys not yet collected have 0 left.
+    int remaining(const timer_handle& handle) const;
+
+    // Moves the clock on one tick.  What falls due is handed out by
+    // next_expired().
+    void advance();
+
+    // Fills 'key' with an expired key and returns true, or returns false
+    // once there are none.  Keys may be scheduled and cancelled while they
+    // are being collected.
+    bool next_expired(unsigned long long& key);
+
+    unsigned int now() const { return m_now; }
+
+    // How many keys are pending.
+    int size() const { return m_size; }
+
+    static const int LEVEL_BITS = 6;
+    static const int SLOTS = 1 << LEVEL_BITS;
+    static const int LEVELS = 4;
+    static const int SPAN = (1 << (LEVEL_BITS * LEVELS)) - 1;
+
+private:
+    struct node {
+        unsigned long long key;
+        unsigned int expires;
+        unsigned int serial;
+        int list; // slot or EXPIRED, or FREE
+        int prev;
+        int next;
+    };
+
+    static const int EXPIRED = LEVELS * SLOTS;
+    static const int FREE = -1;
+
+    const node* find(const timer_handle& handle) const;
+    void file(int index);
+    void link(int index, int list);
+    void unlink(int index);
+    void release(int index);
+    void cascade(int level);
+
+    std::vector<node> m_nodes;
+    int m_heads[LEVELS * SLOTS + 1]; // per slot, then the expired list
+    int m_free;
+    unsigned int m_now;
+    int m_size;
+};
+}
+
+#endif /* TIMER_WHEEL_H */
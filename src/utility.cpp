@@ -39,6 +39,8 @@
 #include "db.h"
 #include "handler.h"
 #include "interpre.h"
+#include "player_index.h"
+#include "slab_pool.h"
 #include "spells.h"
 #include "structs.h"
 #include "utils.h"
@@ -1679,11 +1681,12 @@ int find_player_in_table(char* name, int idnum)
 {
     int i;
 
-    for (i = 0; i <= top_of_p_table; i++)
-        if (((idnum < 0) && (!str_cmp((player_table + i)->name, name))) || ((player_table + i)->idnum == idnum))
-            break;
+    if (idnum < 0)
+        i = game_index::players.find_name(name);
+    else
+        i = game_index::players.find_idnum(idnum);
 
-    if ((i > top_of_p_table) || (IS_SET((player_table + i)->flags, PLR_DELETED)))
+    if ((i < 0) || (IS_SET((player_table + i)->flags, PLR_DELETED)))
         return -1;
 
     return i;
@@ -1956,7 +1959,7 @@ struct obj_data* obj_to_proto(struct obj_data* obj)
     extern struct index_data* obj_index;
     struct obj_data* new_obj;
 
-    CREATE(new_obj, struct obj_data, 1);
+    new_obj = game_memory::object_pool.allocate();
 
     // Get the prototype.
     tmp = &obj_proto[obj->item_number];
@@ -2165,28 +2168,57 @@ static void check_container_proto(struct obj_data* obj, struct char_data* ch)
 char* PERS(struct char_data* target, struct char_data* observer,
     int capitalize, int force_visible)
 {
-    static char name[128];
+    char* name;
 
-    if (CAN_SEE(observer, target) || force_visible) {
-        if (other_side(observer, target)) {
-            snprintf(name, 127, "%s%s%s",
-                CC_USE(observer, COLOR_ENMY),
-                pc_star_types[GET_RACE(target)],
-                CC_NORM(observer));
-        } else if (IS_NPC(target) && MOB_FLAGGED(target, MOB_ORC_FRIEND) && MOB_FLAGGED(target, MOB_PET) && other_side(target, observer)) {
-            snprintf(name, 127, "%s%s%s",
-                CC_USE(observer, COLOR_ENMY),
-                pc_star_types[GET_RACE(target)],
-                CC_NORM(observer));
-        } else
-            snprintf(name, 127, "%s", GET_NAME(target));
-
-        name[127] = '\0';
-    } else
-        sprintf(name, "someone");
+    name = pers_name(pers_kind(target, observer, force_visible),
+        target, observer);
 
     if (capitalize)
         CAP(name);
 
     return name;
 }
+
+/*
+ * Which of its three forms PERS would show 'observer' of
+ * 'target': PERS_SOMEONE, PERS_NAME or PERS_ENEMY.  This is
+ * where PERS calls CAN_SEE.
+ */
+int pers_kind(struct char_data* target, struct char_data* observer,
+    int force_visible)
+{
+    if (!CAN_SEE(observer, target) && !force_visible)
+        return PERS_SOMEONE;
+
+    if (other_side(observer, target))
+        return PERS_ENEMY;
+
+    if (IS_NPC(target) && MOB_FLAGGED(target, MOB_ORC_FRIEND) && MOB_FLAGGED(target, MOB_PET) && other_side(target, observer))
+        return PERS_ENEMY;
+
+    return PERS_NAME;
+}
+
+/*
+ * 'target' in the form 'kind', as PERS shows it to 'observer'.
+ * Only an enemy depends on 'observer', through their colors.
+ */
+char* pers_name(int kind, struct char_data* target,
+    struct char_data* observer)
+{
+    static char name[128];
+
+    if (kind == PERS_ENEMY)
+        snprintf(name, 127, "%s%s%s",
+            CC_USE(observer, COLOR_ENMY),
+            pc_star_types[GET_RACE(target)],
+            CC_NORM(observer));
+    else if (kind == PERS_NAME)
+        snprintf(name, 127, "%s", GET_NAME(target));
+    else
+        sprintf(name, "someone");
+
+    name[127] = '\0';
+
+    return name;
+}
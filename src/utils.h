@@ -34,6 +34,15 @@ double number_d(double from, double to);
 
 struct time_info_data mud_time_passed(time_t, time_t);
 char* PERS(struct char_data*, struct char_data*, int, int);
+
+/* The forms PERS can show a character in; see pers_kind() */
+#define PERS_SOMEONE 0
+#define PERS_NAME 1
+#define PERS_ENEMY 2
+
+int pers_kind(struct char_data*, struct char_data*, int);
+char* pers_name(int, struct char_data*, struct char_data*);
+
 void retire(struct char_data*);
 void unretire(struct char_data*);
 struct char_data* find_playing_char(int);
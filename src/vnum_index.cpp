@@ -0,0 +1,70 @@
+/* vnum_index.cpp */
+
+#include "vnum_index.h"
+
+#include <stddef.h>
+
+namespace game_index {
+vnum_index rooms;
+vnum_index mobiles;
+vnum_index objects;
+vnum_index scripts;
+vnum_index programs;
+
+namespace {
+    const unsigned int MIN_SLOTS = 64;
+}
+
+//============================================================================
+vnum_index::vnum_index()
+    : m_mask(0)
+    , m_count(0)
+{
+}
+
+//============================================================================
+void vnum_index::reset(int count)
+{
+    unsigned int slots = MIN_SLOTS;
+    while (slots < unsigned(count) * 2)
+        slots <<= 1;
+
+    entry empty = { 0, -1 };
+    m_slots.assign(slots, empty);
+    m_mask = slots - 1;
+    m_count = 0;
+}
+
+//============================================================================
+void vnum_index::insert(int vnum, int position)
+{
+    if (unsigned(m_count + 1) * 2 > m_slots.size())
+        grow();
+
+    for (unsigned int slot = hash(vnum);; slot = (slot + 1) & m_mask) {
+        entry& probe = m_slots[slot];
+        if (probe.position < 0) {
+            probe.vnum = vnum;
+            probe.position = position;
+            ++m_count;
+            return;
+        }
+        if (probe.vnum == vnum) {
+            probe.position = position;
+            return;
+        }
+    }
+}
+
+//============================================================================
+void vnum_index::grow()
+{
+    std::vector<entry> old_slots;
+    old_slots.swap(m_slots);
+
+    reset(m_count * 2 + 1);
+    for (size_t slot = 0; slot < old_slots.size(); ++slot)
+        if (old_slots[slot].position >= 0)
+            insert(old_slots[slot].vnum, old_slots[slot].position);
+}
+}
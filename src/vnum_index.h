@@ -0,0 +1,63 @@
+/* vnum_index.h */
+// Hash indexes from virtual numbers to positions in the game's tables, so
+// that real_room(), real_mobile() and the rest take constant time.
+
+#ifndef VNUM_INDEX_H
+#define VNUM_INDEX_H
+#pragma once
+
+#include <vector>
+
+namespace game_index {
+// An open-addressing table with linear probing.  It is kept at most half full
+// so that a lookup rarely probes more than a slot or two.
+class vnum_index {
+public:
+    vnum_index();
+
+    // Forgets every entry and makes room for 'count' of them.
+    void reset(int count);
+
+    // Maps 'vnum' to 'position', replacing any earlier mapping.
+    void insert(int vnum, int position);
+
+    // Returns the position of 'vnum', or -1 if it is not in the table.
+    int find(int vnum) const
+    {
+        if (m_slots.empty())
+            return -1;
+
+        for (unsigned int slot = hash(vnum);; slot = (slot + 1) & m_mask) {
+            const entry& probe = m_slots[slot];
+            if (probe.position < 0)
+                return -1;
+            if (probe.vnum == vnum)
+                return probe.position;
+        }
+    }
+
+    int size() const { return m_count; }
+
+private:
+    struct entry {
+        int vnum;
+        int position; // -1 for an empty slot
+    };
+
+    unsigned int hash(int vnum) const { return (unsigned(vnum) * 2654435761u) & m_mask; }
+    void grow();
+
+    std::vector<entry> m_slots;
+    unsigned int m_mask;
+    int m_count;
+};
+
+// One index per table, rebuilt by index_boot() once the table is loaded.
+extern vnum_index rooms; // world
+extern vnum_index mobiles; // mob_index
+extern vnum_index objects; // obj_index
+extern vnum_index scripts; // script_table
+extern vnum_index programs; // mobile_program_zone
+}
+
+#endif /* VNUM_INDEX_H */
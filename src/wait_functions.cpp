@@ -203,7 +203,7 @@ void wait_list::update()
             if (!utils::is_npc(*character) && utils::is_affected_by(*character, AFF_WAITWHEEL)) {
                 if (utils::is_preference_flagged(*character, PRF_SPINNER)) {
                     // Add this function in somewhere.
-                    write_to_descriptor(character->desc->descriptor, wait_wheel[wait_value % 8]);
+                    write_to_descriptor(character->desc, wait_wheel[wait_value % 8]);
                 }
             }
         } else if (character->delay.wait_value == 0) {
@@ -0,0 +1,352 @@
+/* world_snapshot.cpp */
+
+#include "world_snapshot.h"
+
+#include "area_files.h"
+#include "structs.h"
+#include "utils.h"
+#include "db.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+namespace game_boot {
+namespace {
+    const char SNAPSHOT_MAGIC[8] = "AGESNAP";
+
+    enum table_kind {
+        OBJECT_TABLE = 1,
+        MOBILE_TABLE = 2
+    };
+
+    // The body follows: per prototype, its virtual number, the struct as it
+    // was in memory, then the strings it owns.  Pointers in the struct are
+    // written as they were and replaced when it is read back; every pointer
+    // a loader does not set is null.
+    struct snapshot_header {
+        char magic[8];
+        int version;
+        int kind;
+        int record_size;
+        int count;
+        unsigned long long key;
+        unsigned long long body_digest;
+        unsigned long long body_length;
+    };
+
+    //========================================================================
+    class body_writer {
+    public:
+        void bytes(const void* data, size_t length)
+        {
+            m_body.append(static_cast<const char*>(data), length);
+        }
+
+        void number(int value) { bytes(&value, sizeof(value)); }
+
+        // -1 for a null string, so that it comes back null.
+        void string(const char* text)
+        {
+            int length = text ? int(strlen(text)) : -1;
+            number(length);
+            if (text)
+                bytes(text, length);
+        }
+
+        const std::string& body() const { return m_body; }
+
+    private:
+        std::string m_body;
+    };
+
+    //========================================================================
+    // Reads what body_writer wrote.  With 'apply' false it only checks that
+    // the body is whole, so nothing is allocated for a snapshot that turns
+    // out to be unusable half way through.
+    class body_reader {
+    public:
+        body_reader(const std::string& body, bool apply)
+            : m_at(body.data())
+            , m_end(body.data() + body.size())
+            , m_apply(apply)
+        {
+        }
+
+        bool bytes(void* data, size_t length)
+        {
+            if (size_t(m_end - m_at) < length)
+                return false;
+            if (m_apply)
+                memcpy(data, m_at, length);
+            m_at += length;
+            return true;
+        }
+
+        bool number(int& value)
+        {
+            if (size_t(m_end - m_at) < sizeof(value))
+                return false;
+            memcpy(&value, m_at, sizeof(value));
+            m_at += sizeof(value);
+            return true;
+        }
+
+        // Allocates the string as fread_string() would.
+        bool string(char*& text)
+        {
+            int length;
+            text = 0;
+            if (!number(length) || length < -1 || m_end - m_at < length)
+                return false;
+            if (m_apply) {
+                if (length >= 0) {
+                    CREATE(text, char, length + 1);
+                    memcpy(text, m_at, length);
+                }
+            }
+            if (length > 0)
+                m_at += length;
+            return true;
+        }
+
+        bool applying() const { return m_apply; }
+        bool at_end() const { return m_at == m_end; }
+
+    private:
+        const char* m_at;
+        const char* m_end;
+        bool m_apply;
+    };
+
+    //========================================================================
+    void write_object(body_writer& writer, const obj_data& proto, const index_data& index)
+    {
+        writer.number(index.virt);
+        writer.bytes(&proto, sizeof(proto));
+        writer.string(proto.name);
+        writer.string(proto.short_description);
+        writer.string(proto.description);
+        writer.string(proto.action_description);
+
+        int descriptions = 0;
+        for (const extra_descr_data* descr = proto.ex_description; descr; descr = descr->next)
+            ++descriptions;
+        writer.number(descriptions);
+        for (const extra_descr_data* descr = proto.ex_description; descr; descr = descr->next) {
+            writer.string(descr->keyword);
+            writer.string(descr->description);
+        }
+    }
+
+    bool read_object(body_reader& reader, obj_data& proto, index_data& index)
+    {
+        int virt, descriptions;
+        char* text[4];
+        if (!reader.number(virt) || !reader.bytes(&proto, sizeof(proto)))
+            return false;
+        for (int string = 0; string < 4; ++string)
+            if (!reader.string(text[string]))
+                return false;
+        if (!reader.number(descriptions) || descriptions < 0)
+            return false;
+
+        // In the order load_objects() left them.
+        extra_descr_data* first = 0;
+        extra_descr_data** tail = &first;
+        for (int descr = 0; descr < descriptions; ++descr) {
+            char *keyword, *description;
+            if (!reader.string(keyword) || !reader.string(description))
+                return false;
+            if (reader.applying()) {
+                CREATE(*tail, struct extra_descr_data, 1);
+                (*tail)->keyword = keyword;
+                (*tail)->description = description;
+                tail = &(*tail)->next;
+            }
+        }
+
+        if (reader.applying()) {
+            proto.name = text[0];
+            proto.short_description = text[1];
+            proto.description = text[2];
+            proto.action_description = text[3];
+            proto.ex_description = first;
+
+            index.virt = virt;
+            index.number = 0;
+            index.func = 0;
+        }
+        return true;
+    }
+
+    //========================================================================
+    void write_mobile(body_writer& writer, const char_data& proto, const index_data& index)
+    {
+        writer.number(index.virt);
+        writer.bytes(&proto, sizeof(proto));
+        writer.bytes(proto.profs, sizeof(*proto.profs));
+        writer.string(proto.player.name);
+        writer.string(proto.player.short_descr);
+        writer.string(proto.player.long_descr);
+        writer.string(proto.player.description);
+        writer.string(proto.player.title);
+        writer.string(proto.player.death_cry);
+        writer.string(proto.player.death_cry2);
+    }
+
+    // char_data has members with constructors, but load_mobiles() fills the
+    // prototypes over clear_char()'s memset and so does this.
+    bool read_mobile(body_reader& reader, char_data& proto, index_data& index)
+    {
+        int virt;
+        char_prof_data profs;
+        if (!reader.number(virt) || !reader.bytes((void*)&proto, sizeof(proto)) || !reader.bytes(&profs, sizeof(profs)))
+            return false;
+
+        char* text[7];
+        for (int string = 0; string < 7; ++string)
+            if (!reader.string(text[string]))
+                return false;
+
+        if (reader.applying()) {
+            CREATE1(proto.profs, char_prof_data);
+            *proto.profs = profs;
+            proto.player.name = text[0];
+            proto.player.short_descr = text[1];
+            proto.player.long_descr = text[2];
+            proto.player.description = text[3];
+            proto.player.title = text[4];
+            proto.player.death_cry = text[5];
+            proto.player.death_cry2 = text[6];
+
+            index.virt = virt;
+            index.number = 0;
+            index.func = 0;
+        }
+        return true;
+    }
+
+    //========================================================================
+    bool write_snapshot(const char* filename, int kind, int record_size, int count, unsigned long long key, const body_writer& writer)
+    {
+        snapshot_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.kind = kind;
+        header.record_size = record_size;
+        header.count = count;
+        header.key = key;
+        header.body_length = writer.body().size();
+        header.body_digest = digest_bytes(DIGEST_START, writer.body().data(), writer.body().size());
+
+        std::string temp = std::string(filename) + ".tmp";
+        FILE* file = fopen(temp.c_str(), "wb");
+        if (!file)
+            return false;
+
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(writer.body().data(), 1, writer.body().size(), file) == writer.body().size();
+        if (fclose(file) != 0 || !written || rename(temp.c_str(), filename) < 0) {
+            unlink(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    //========================================================================
+    // Reads the body of the snapshot in 'filename' if its header matches.
+    // Returns the number of prototypes in it, or -1.
+    int read_snapshot(const char* filename, int kind, int record_size, int room, unsigned long long key, std::string& body)
+    {
+        FILE* file = fopen(filename, "rb");
+        if (!file)
+            return -1;
+
+        snapshot_header header;
+        bool usable = fread(&header, sizeof(header), 1, file) == 1
+            && memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0
+            && header.version == SNAPSHOT_VERSION
+            && header.kind == kind
+            && header.record_size == record_size
+            && header.key == key
+            && header.count >= 0 && header.count <= room;
+        if (usable) {
+            body.resize(header.body_length);
+            usable = fread(&body[0], 1, body.size(), file) == body.size()
+                && fgetc(file) == EOF
+                && digest_bytes(DIGEST_START, body.data(), body.size()) == header.body_digest;
+        }
+        fclose(file);
+        return usable ? header.count : -1;
+    }
+
+    //========================================================================
+    template <class Proto>
+    int read_table(const char* filename, int kind, unsigned long long key, Proto* protos, index_data* index, int room,
+        bool (*read_record)(body_reader&, Proto&, index_data&))
+    {
+        std::string body;
+        int count = read_snapshot(filename, kind, sizeof(Proto), room, key, body);
+        if (count < 0)
+            return -1;
+
+        body_reader check(body, false);
+        for (int record = 0; record < count; ++record)
+            if (!read_record(check, protos[record], index[record]))
+                return -1;
+        if (!check.at_end())
+            return -1;
+
+        body_reader fill(body, true);
+        for (int record = 0; record < count; ++record)
+            read_record(fill, protos[record], index[record]);
+        return count;
+    }
+}
+
+//============================================================================
+unsigned long long snapshot_key(const area_directory& areas, const char* build, unsigned long long extra)
+{
+    int version = SNAPSHOT_VERSION;
+    unsigned long long key = digest_bytes(DIGEST_START, &version, sizeof(version));
+    key = digest_bytes(key, build, strlen(build) + 1);
+    for (const area_file& file : areas.files) {
+        key = digest_bytes(key, file.path.c_str(), file.path.size() + 1);
+        key = digest_bytes(key, &file.digest, sizeof(file.digest));
+    }
+    return digest_bytes(key, &extra, sizeof(extra));
+}
+
+//============================================================================
+int read_objects(const char* filename, unsigned long long key, obj_data* protos, index_data* index, int room)
+{
+    return read_table(filename, OBJECT_TABLE, key, protos, index, room, read_object);
+}
+
+//============================================================================
+int read_mobiles(const char* filename, unsigned long long key, char_data* protos, index_data* index, int room)
+{
+    return read_table(filename, MOBILE_TABLE, key, protos, index, room, read_mobile);
+}
+
+//============================================================================
+bool write_objects(const char* filename, unsigned long long key, const obj_data* protos, const index_data* index, int count)
+{
+    body_writer writer;
+    for (int record = 0; record < count; ++record)
+        write_object(writer, protos[record], index[record]);
+    return write_snapshot(filename, OBJECT_TABLE, sizeof(obj_data), count, key, writer);
+}
+
+//============================================================================
+bool write_mobiles(const char* filename, unsigned long long key, const char_data* protos, const index_data* index, int count)
+{
+    body_writer writer;
+    for (int record = 0; record < count; ++record)
+        write_mobile(writer, protos[record], index[record]);
+    return write_snapshot(filename, MOBILE_TABLE, sizeof(char_data), count, key, writer);
+}
+}
@@ -0,0 +1,43 @@
+/* world_snapshot.h */
+// A binary copy of the object and mobile prototype tables.  The tables are
+// written out once they have been parsed at boot, and the next boot reads
+// them back instead of parsing the area files again.
+//
+// A snapshot only stands in for the files it was made from.  Its key covers
+// the contents of every area file in index order, whatever else the loader
+// read, and the build of the loader itself.  If the key differs, the file is
+// short, or its body does not match its digest, boot parses the area files
+// as before and writes a fresh snapshot.
+
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+#pragma once
+
+struct char_data;
+struct index_data;
+struct obj_data;
+
+namespace game_boot {
+struct area_directory;
+
+// Bump this whenever the layout of a snapshot changes in a way the build
+// stamp in the key would not catch.
+const int SNAPSHOT_VERSION = 1;
+
+// The key for a table parsed from 'areas' by a loader built at 'build'.
+// 'extra' is a digest of anything else the loader depends on.
+unsigned long long snapshot_key(const area_directory& areas, const char* build, unsigned long long extra);
+
+// Fills 'protos' and 'index' from 'filename' if it holds a snapshot with
+// 'key' of no more than 'room' prototypes.  Returns how many were read, or
+// -1, leaving the tables untouched, if the snapshot cannot be used.
+int read_objects(const char* filename, unsigned long long key, obj_data* protos, index_data* index, int room);
+int read_mobiles(const char* filename, unsigned long long key, char_data* protos, index_data* index, int room);
+
+// Writes the first 'count' prototypes under 'key'.  The file is replaced as
+// a whole, so a crash leaves the old snapshot or none.
+bool write_objects(const char* filename, unsigned long long key, const obj_data* protos, const index_data* index, int count);
+bool write_mobiles(const char* filename, unsigned long long key, const char_data* protos, const index_data* index, int count);
+}
+
+#endif /* WORLD_SNAPSHOT_H */
@@ -9,6 +9,8 @@
 #include "db.h" /* For buf2 and struct reset_com */
 #include "handler.h" /* For FOLLOW_MOVE */
 #include "pkill.h" /* For pkill_get_XXX_fame() */
+#include "script.h" /* For room_script_arrival() */
+#include "slab_pool.h" /* For game_memory::slab_pool */
 #include "structs.h" /* For struct owner_list */
 #include "utils.h" /* For CREATE */
 #include "zone.h"
@@ -694,6 +696,8 @@ void reset_zone(int zone)
                 case 12: /* Assign script to mob */
                     mob->specials.script_number = ZCMD.arg2;
                     mob->specials.script_info = 0; /* Probably unnecessary */
+                    if (mob->in_room != NOWHERE)
+                        room_script_arrival(&world[mob->in_room], mob->specials.script_number);
                     break;
                 default:
                     vmudlog(CMP, "Unrecognized 'A' command: %d %d %d in zone #%d.",
@@ -857,29 +861,15 @@ void reset_zone(int zone)
     zone_table[zone].age = 0;
 }
 
-static struct reset_q_element* reset_q_pool;
+static game_memory::slab_pool<reset_q_element> reset_q_pool("reset queue");
 
 /*
- * Return the head of the current pool if it exists.
- * Otherwise create a new element and return it.
- *
- * XXX: The modularity is cute, but do we really need it?
- * This file is the only place in the entire codebase that
- * makes use of any of these reset_q_pool functions, and
- * usually they're only called at one place.
+ * Return a cleared element from the pool.
  */
 struct reset_q_element*
 get_from_reset_q_pool(void)
 {
-    struct reset_q_element* resnew;
-
-    if (reset_q_pool) {
-        resnew = reset_q_pool;
-        reset_q_pool = resnew->next;
-    } else
-        CREATE(resnew, struct reset_q_element, 1);
-
-    return resnew;
+    return reset_q_pool.allocate();
 }
 
 /*
@@ -887,8 +877,7 @@ get_from_reset_q_pool(void)
  */
 void put_to_reset_q_pool(struct reset_q_element* oldres)
 {
-    oldres->next = reset_q_pool;
-    reset_q_pool = oldres;
+    reset_q_pool.release(oldres);
 }
 
 /*